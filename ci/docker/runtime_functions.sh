@@ -912,6 +912,11 @@ integrationtest_ubuntu_cpu_dist_kvstore() {
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --no-multiprecision
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=compressed_cpu
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=compressed_cpu --no-multiprecision
+    MXNET_KVSTORE_DIST_FUSED_BUCKET_BYTES=65536 ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py
+    MXNET_KVSTORE_DIST_FUSED_BUCKET_BYTES=65536 ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=gluon_step_cpu
+    MXNET_KVSTORE_SERVER_THREADS=4 ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py
+    MXNET_KVSTORE_SERVER_THREADS=4 ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=compressed_cpu
+    MXNET_KVSTORE_SERVER_THREADS=4 MXNET_KVSTORE_DIST_FUSED_BUCKET_BYTES=65536 ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=gluon_step_cpu
     ../../tools/launch.py -n 3 --launcher local python test_server_profiling.py
 }
 
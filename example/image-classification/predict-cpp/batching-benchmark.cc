@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file batching-benchmark.cc
+ * \brief Latency and throughput of single requests from concurrent clients, each client
+ *  with its own predictor, and all clients sharing one batcher.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+// Path for c_predict_api
+#include <mxnet/c_predict_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+static std::string ReadFile(const std::string& path) {
+  std::ifstream ifs(path.c_str(), std::ios::in | std::ios::binary);
+  if (!ifs) {
+    std::cerr << "Can't open the file. Please check " << path << ".\n";
+    std::exit(EXIT_FAILURE);
+  }
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+static void Check(int ret) {
+  if (ret != 0) {
+    std::cerr << MXGetLastError() << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+static std::vector<mx_uint> ParseShape(const std::string& text) {
+  std::vector<mx_uint> shape;
+  std::stringstream ss(text);
+  std::string dim;
+  while (std::getline(ss, dim, ',')) {
+    shape.push_back(static_cast<mx_uint>(std::atoi(dim.c_str())));
+  }
+  return shape;
+}
+
+static size_t Product(const mx_uint* begin, const mx_uint* end) {
+  size_t size = 1;
+  for (const mx_uint* it = begin; it != end; ++it) size *= *it;
+  return size;
+}
+
+/*!
+ * \brief run num_clients threads sending num_requests requests each through run and
+ *  print the throughput and latency percentiles
+ */
+template<typename Run>
+static void Measure(const char* name, int num_clients, int num_requests, Run run) {
+  std::vector<std::vector<double>> latencies(num_clients);
+  std::vector<std::thread> clients;
+  const auto start = Clock::now();
+  for (int c = 0; c < num_clients; ++c) {
+    clients.emplace_back([&, c]() {
+      for (int r = 0; r < num_requests; ++r) {
+        const auto begin = Clock::now();
+        run(c);
+        latencies[c].push_back(
+            std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+      }
+    });
+  }
+  for (auto& t : clients) t.join();
+  const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  std::vector<double> all;
+  for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+  auto percentile = [&all](double p) {
+    return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+  };
+  std::cout << name << ": " << all.size() / elapsed << " requests/sec, latency ms p50 "
+            << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 "
+            << percentile(0.99) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cout << "Usage: ./batching-benchmark symbol.json model.params 1,3,224,224 "
+              << "[num_clients] [max_batch_size] [max_delay_us] [requests_per_client]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string json = ReadFile(argv[1]);
+  const std::string params = ReadFile(argv[2]);
+  const std::vector<mx_uint> shape = ParseShape(argv[3]);
+  const int num_clients = argc > 4 ? std::atoi(argv[4]) : 8;
+  const mx_uint max_batch_size = argc > 5 ? std::atoi(argv[5]) : 8;
+  const mx_uint max_delay_us = argc > 6 ? std::atoi(argv[6]) : 2000;
+  const int num_requests = argc > 7 ? std::atoi(argv[7]) : 100;
+
+  int dev_type = 1;  // 1: cpu, 2: gpu
+  int dev_id = 0;
+  const char* input_keys[1] = { "data" };
+  const mx_uint input_shape_indptr[2] = { 0, static_cast<mx_uint>(shape.size()) };
+  const size_t input_size = Product(shape.data(), shape.data() + shape.size());
+  std::vector<mx_float> input(input_size, 0.5f);
+
+  // every client with its own predictor, weights shared through a pool
+  {
+    PredictorPoolHandle pool;
+    Check(MXPredPoolCreate(json.c_str(), params.data(), static_cast<int>(params.size()),
+                           dev_type, dev_id, 1, input_keys, input_shape_indptr, shape.data(),
+                           &pool));
+    std::vector<PredictorHandle> predictors(num_clients);
+    for (auto& p : predictors) Check(MXPredPoolCreatePredictor(pool, &p));
+    mx_uint* out_shape;
+    mx_uint out_ndim;
+    Check(MXPredGetOutputShape(predictors[0], 0, &out_shape, &out_ndim));
+    const size_t output_size = Product(out_shape, out_shape + out_ndim);
+    std::vector<std::vector<mx_float>> outputs(num_clients,
+                                               std::vector<mx_float>(output_size));
+    Measure("predictor per client", num_clients, num_requests, [&](int c) {
+      Check(MXPredSetInput(predictors[c], "data", input.data(),
+                           static_cast<mx_uint>(input.size())));
+      Check(MXPredForward(predictors[c]));
+      Check(MXPredGetOutput(predictors[c], 0, outputs[c].data(),
+                            static_cast<mx_uint>(outputs[c].size())));
+    });
+    for (auto p : predictors) Check(MXPredFree(p));
+    Check(MXPredPoolFree(pool));
+  }
+
+  // all clients sharing a batcher
+  {
+    PredictorBatcherHandle batcher;
+    Check(MXPredBatcherCreate(json.c_str(), params.data(), static_cast<int>(params.size()),
+                              dev_type, dev_id, 1, input_keys, input_shape_indptr,
+                              shape.data(), max_batch_size, max_delay_us, &batcher));
+    mx_uint* out_shape;
+    mx_uint out_ndim;
+    if (MXPredBatcherGetOutputShape(batcher, 1, &out_shape, &out_ndim) == 0) {
+      std::cerr << "only nets with one output are supported" << std::endl;
+      return EXIT_FAILURE;
+    }
+    Check(MXPredBatcherGetOutputShape(batcher, 0, &out_shape, &out_ndim));
+    const size_t output_size = Product(out_shape, out_shape + out_ndim);
+    std::vector<std::vector<mx_float>> outputs(num_clients,
+                                               std::vector<mx_float>(output_size));
+    std::ostringstream name;
+    name << "batcher, max batch " << max_batch_size << ", max delay " << max_delay_us << "us";
+    Measure(name.str().c_str(), num_clients, num_requests, [&](int c) {
+      const mx_float* inputs[1] = { input.data() };
+      mx_float* outs[1] = { outputs[c].data() };
+      Check(MXPredBatcherPredict(batcher, inputs, outs));
+    });
+    Check(MXPredBatcherFree(batcher));
+  }
+  return EXIT_SUCCESS;
+}
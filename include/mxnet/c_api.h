@@ -71,6 +71,8 @@ typedef const void *FunctionHandle;
 typedef void *AtomicSymbolCreator;
 /*! \brief handle to cached operator */
 typedef void *CachedOpHandle;
+/*! \brief handle to an operator with parsed parameters */
+typedef void *ParsedOpHandle;
 /*! \brief handle to a symbol that can be bind as operator */
 typedef void *SymbolHandle;
 /*! \brief handle to a AtomicSymbol */
@@ -303,6 +305,16 @@ MXNET_DLL int MXDumpProfile(int finished);
  */
 MXNET_DLL int MXAggregateProfileStatsPrint(const char **out_str, int reset);
 
+/*!
+ * \brief Snapshot the latency percentiles of the aggregate stats, without dumping the profile
+ * \param out_json Will receive a pointer to a json string mapping each category to a list of
+ *        {name, device, count, mean, min, max, p50, p90, p99, p999}, times in microseconds
+ * \param reset Clear the latency histograms after the snapshot
+ * \return 0 when success, -1 when failure happens.
+ * \note Empty unless the profiler was configured with aggregate_stats
+ */
+MXNET_DLL int MXAggregateProfileLatency(const char **out_json, int reset);
+
 /*!
  * \brief Pause profiler tuning collection
  * \param paused If nonzero, profiling pauses. Otherwise, profiling resumes/continues
@@ -577,6 +589,20 @@ MXNET_DLL int MXNDArraySave(const char* fname,
                             mx_uint num_args,
                             NDArrayHandle* args,
                             const char** keys);
+/*!
+ * \brief Save list of narray into the file, with the data of dense arrays aligned so
+ *  that MXNDArrayLoad memory maps it instead of reading it. Versions before this API
+ *  was added cannot load the file.
+ * \param fname name of the file.
+ * \param num_args number of arguments to save.
+ * \param args the array of NDArrayHandles to be saved.
+ * \param keys the name of the NDArray, optional, can be NULL
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArraySaveAligned(const char* fname,
+                                   mx_uint num_args,
+                                   NDArrayHandle* args,
+                                   const char** keys);
 /*!
  * \brief Load list of narray from the file.
  * \param fname name of the file.
@@ -995,6 +1021,45 @@ MXNET_DLL int MXImperativeInvokeEx(AtomicSymbolCreator creator,
                                    const char **param_keys,
                                    const char **param_vals,
                                    const int **out_stypes);
+/*!
+ * \brief parse the parameters of an operator once, for invoking it many times
+ *  with MXInvokeParsedOp without parsing them again
+ * \param creator the op
+ * \param num_inputs number of input NDArrays the op will be invoked with
+ * \param num_params number of keyword parameters
+ * \param param_keys keys for keyword parameters
+ * \param param_vals values for keyword parameters
+ * \param out the returning handle
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXCreateParsedOp(AtomicSymbolCreator creator,
+                               int num_inputs,
+                               int num_params,
+                               const char **param_keys,
+                               const char **param_vals,
+                               ParsedOpHandle *out);
+/*!
+ * \brief free an operator created by MXCreateParsedOp
+ * \param handle the handle
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXFreeParsedOp(ParsedOpHandle handle);
+/*!
+ * \brief invoke an operator created by MXCreateParsedOp, as MXImperativeInvokeEx
+ * \param handle the handle
+ * \param num_inputs number of input NDArrays, as given to MXCreateParsedOp
+ * \param inputs input NDArrays
+ * \param num_outputs number of output NDArrays
+ * \param outputs output NDArrays
+ * \param out_stypes output ndarrays' stypes
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXInvokeParsedOp(ParsedOpHandle handle,
+                               int num_inputs,
+                               NDArrayHandle *inputs,
+                               int *num_outputs,
+                               NDArrayHandle **outputs,
+                               const int **out_stypes);
 /*!
  * \brief set whether to record operator for autograd
  * \param is_recording 1 when recording, 0 when not recording.
@@ -47,6 +47,10 @@ typedef unsigned int mx_uint;
 typedef float mx_float;
 /*! \brief handle to Predictor */
 typedef void *PredictorHandle;
+/*! \brief handle to a pool of predictors sharing weights */
+typedef void *PredictorPoolHandle;
+/*! \brief handle to a batcher of predict requests */
+typedef void *PredictorBatcherHandle;
 /*! \brief handle to NDArray list */
 typedef void *NDListHandle;
 
@@ -152,6 +156,137 @@ MXNET_DLL int MXPredCreateMultiThread(const char* symbol_json_str,
                                       int num_threads,
                                       PredictorHandle* out);
 
+/*!
+ * \brief create a pool of predictors sharing one read only copy of the weights.
+ *  Predictors created from the pool own only their inputs and intermediate arrays,
+ *  and are used with MXPredSetInput, MXPredForward, MXPredGetOutput and MXPredFree.
+ *  Dense float32 CPU parameters refer to the loaded bytes directly.
+ * \param symbol_json_str The JSON string of the symbol.
+ * \param param_bytes The in-memory raw bytes of parameter ndarray file.
+ * \param param_size The size of parameter ndarray file.
+ * \param dev_type The device type, 1: cpu, 2:gpu
+ * \param dev_id The device id of the predictors.
+ * \param num_input_nodes Number of input nodes to the net.
+ * \param input_keys The name of input argument.
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ * \param input_shape_data A flattened data of shapes of each input node.
+ * \param out The created pool handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredPoolCreate(const char* symbol_json_str,
+                               const void* param_bytes,
+                               int param_size,
+                               int dev_type, int dev_id,
+                               mx_uint num_input_nodes,
+                               const char** input_keys,
+                               const mx_uint* input_shape_indptr,
+                               const mx_uint* input_shape_data,
+                               PredictorPoolHandle* out);
+
+/*!
+ * \brief create a pool of predictors from a parameter file. Local files are memory
+ *  mapped copy-on-write, so processes serving the same file share its pages.
+ * \param symbol_json_str The JSON string of the symbol.
+ * \param param_file The path or URI of the parameter ndarray file.
+ * \param dev_type The device type, 1: cpu, 2:gpu
+ * \param dev_id The device id of the predictors.
+ * \param num_input_nodes Number of input nodes to the net.
+ * \param input_keys The name of input argument.
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ * \param input_shape_data A flattened data of shapes of each input node.
+ * \param out The created pool handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredPoolCreateFromFile(const char* symbol_json_str,
+                                       const char* param_file,
+                                       int dev_type, int dev_id,
+                                       mx_uint num_input_nodes,
+                                       const char** input_keys,
+                                       const mx_uint* input_shape_indptr,
+                                       const mx_uint* input_shape_data,
+                                       PredictorPoolHandle* out);
+
+/*!
+ * \brief create a predictor using the weights of a pool. Can be called from several
+ *  threads at once; each predictor must be used by one thread at a time.
+ * \param handle The pool handle.
+ * \param out The created predictor handle, freed with MXPredFree.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredPoolCreatePredictor(PredictorPoolHandle handle, PredictorHandle* out);
+
+/*!
+ * \brief free a pool. The weights stay alive until its predictors are freed too.
+ * \param handle The pool handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredPoolFree(PredictorPoolHandle handle);
+
+/*!
+ * \brief create a batcher, which queues single requests and runs them together in
+ *  batches of up to max_batch_size. Predictors are bound ahead for batch sizes of
+ *  powers of two and max_batch_size; a batch runs on the smallest one that fits.
+ *  The first dimension of every input and output is the batch dimension.
+ * \param symbol_json_str The JSON string of the symbol.
+ * \param param_bytes The in-memory raw bytes of parameter ndarray file.
+ * \param param_size The size of parameter ndarray file.
+ * \param dev_type The device type, 1: cpu, 2:gpu
+ * \param dev_id The device id of the predictors.
+ * \param num_input_nodes Number of input nodes to the net.
+ * \param input_keys The name of input argument.
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ * \param input_shape_data A flattened data of shapes of each input node for one request,
+ *    usually with a batch dimension of 1.
+ * \param max_batch_size The largest number of requests run at once.
+ * \param max_delay_us The longest time in microseconds a request waits for others to
+ *    join its batch.
+ * \param out The created batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherCreate(const char* symbol_json_str,
+                                  const void* param_bytes,
+                                  int param_size,
+                                  int dev_type, int dev_id,
+                                  mx_uint num_input_nodes,
+                                  const char** input_keys,
+                                  const mx_uint* input_shape_indptr,
+                                  const mx_uint* input_shape_data,
+                                  mx_uint max_batch_size,
+                                  mx_uint max_delay_us,
+                                  PredictorBatcherHandle* out);
+
+/*!
+ * \brief Get the shape of an output of one request.
+ * \param handle The batcher handle.
+ * \param index The index of output node.
+ * \param shape_data Used to hold pointer to the shape data
+ * \param shape_ndim Used to hold shape dimension.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherGetOutputShape(PredictorBatcherHandle handle,
+                                          mx_uint index,
+                                          mx_uint** shape_data,
+                                          mx_uint* shape_ndim);
+
+/*!
+ * \brief Run one request, returning when its outputs are written. Can be called from
+ *  several threads at once, which is how requests get batched.
+ * \param handle The batcher handle.
+ * \param input_data The data of each input of the request, in the order of input_keys.
+ * \param output_data The buffers receiving each output of the request.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherPredict(PredictorBatcherHandle handle,
+                                   const mx_float** input_data,
+                                   mx_float** output_data);
+
+/*!
+ * \brief Free a batcher after running the requests already queued.
+ * \param handle The batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherFree(PredictorBatcherHandle handle);
+
 /*!
  * \brief Change the input shape of an existing predictor.
  * \param num_input_nodes Number of input nodes to the net,
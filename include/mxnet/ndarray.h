@@ -792,6 +792,17 @@ class NDArray {
   static void Save(dmlc::Stream* fo,
                    const std::vector<NDArray>& data,
                    const std::vector<std::string>& names);
+  /*!
+   * \brief Save list of ndarray into the Stream, with the data of every dense array
+   *  aligned in the stream, so that it can be used in place when the file is memory
+   *  mapped by LoadFile. Older versions cannot load such files.
+   * \param fo The stream of output.
+   * \param data the NDArrays to be saved.
+   * \param names the name of the NDArray, optional, can be zero length.
+   */
+  static void SaveAligned(dmlc::Stream* fo,
+                          const std::vector<NDArray>& data,
+                          const std::vector<std::string>& names);
   /*!
    * \brief Load list of ndarray into from the stream.
    * \param fi The stream of the input file.
@@ -801,6 +812,31 @@ class NDArray {
   static void Load(dmlc::Stream* fi,
                    std::vector<NDArray>* data,
                    std::vector<std::string>* keys);
+  /*!
+   * \brief Load list of ndarray saved by Save from memory, without copying the data of
+   *  dense CPU arrays. Such arrays refer to the memory and keep owner alive; writing to
+   *  them writes to the memory. Other arrays are copied as by Load.
+   * \param buffer the saved list.
+   * \param size the size of buffer in bytes.
+   * \param owner keeps buffer valid, released when the last array referring to it is freed.
+   * \param data the NDArrays to be loaded
+   * \param keys the name of the NDArray, if saved in the file.
+   */
+  static void LoadFromMemory(char* buffer, size_t size,
+                             const std::shared_ptr<void>& owner,
+                             std::vector<NDArray>* data,
+                             std::vector<std::string>* keys);
+  /*!
+   * \brief Load list of ndarray from a file. Local files saved by SaveAligned are memory
+   *  mapped copy-on-write, and their dense CPU arrays are paged in when first used;
+   *  others are read as by Load.
+   * \param fname the path or URI of the file.
+   * \param data the NDArrays to be loaded
+   * \param keys the name of the NDArray, if saved in the file.
+   */
+  static void LoadFile(const std::string& fname,
+                       std::vector<NDArray>* data,
+                       std::vector<std::string>* keys);
 
  private:
   friend class Imperative;
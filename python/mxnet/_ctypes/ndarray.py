@@ -22,10 +22,11 @@
 from __future__ import absolute_import as _abs
 
 import ctypes
+import os
 
 from ..base import _LIB
 from ..base import c_str_array, c_handle_array
-from ..base import NDArrayHandle, CachedOpHandle
+from ..base import NDArrayHandle, CachedOpHandle, ParsedOpHandle
 from ..base import check_call
 
 
@@ -62,6 +63,28 @@ def _set_ndarray_class(cls):
     _ndarray_cls = cls
 
 
+class _ParsedOp(object):
+    """Operator with its parameters parsed once, for invoking it many times."""
+    __slots__ = ["handle"]
+    def __init__(self, handle, num_inputs, keys, vals):
+        self.handle = ParsedOpHandle()
+        check_call(_LIB.MXCreateParsedOp(
+            ctypes.c_void_p(handle),
+            ctypes.c_int(num_inputs),
+            ctypes.c_int(len(keys)),
+            c_str_array(keys),
+            c_str_array(vals),
+            ctypes.byref(self.handle)))
+
+    def __del__(self):
+        check_call(_LIB.MXFreeParsedOp(self.handle))
+
+
+# parsed operators by op handle, number of inputs and parameters
+_parsed_ops = {}
+_parsed_ops_limit = int(os.environ.get('MXNET_PARSED_OP_CACHE_SIZE', 4096))
+
+
 def _imperative_invoke(handle, ndargs, keys, vals, out):
     """ctypes implementation of imperative invoke wrapper"""
     if out is not None:
@@ -80,16 +103,34 @@ def _imperative_invoke(handle, ndargs, keys, vals, out):
     # a handle's stype in _ndarray_cls
     out_stypes = ctypes.POINTER(ctypes.c_int)()
 
-    check_call(_LIB.MXImperativeInvokeEx(
-        ctypes.c_void_p(handle),
-        ctypes.c_int(len(ndargs)),
-        c_handle_array(ndargs),
-        ctypes.byref(num_output),
-        ctypes.byref(output_vars),
-        ctypes.c_int(len(keys)),
-        c_str_array(keys),
-        c_str_array([str(s) for s in vals]),
-        ctypes.byref(out_stypes)))
+    vals = [str(s) for s in vals]
+    if _parsed_ops_limit > 0:
+        # the same op with the same parameters is parsed once
+        key = (handle, len(ndargs), tuple(keys), tuple(vals))
+        parsed_op = _parsed_ops.get(key)
+        if parsed_op is None:
+            if len(_parsed_ops) >= _parsed_ops_limit:
+                _parsed_ops.clear()
+            parsed_op = _ParsedOp(handle, len(ndargs), keys, vals)
+            _parsed_ops[key] = parsed_op
+        check_call(_LIB.MXInvokeParsedOp(
+            parsed_op.handle,
+            ctypes.c_int(len(ndargs)),
+            c_handle_array(ndargs),
+            ctypes.byref(num_output),
+            ctypes.byref(output_vars),
+            ctypes.byref(out_stypes)))
+    else:
+        check_call(_LIB.MXImperativeInvokeEx(
+            ctypes.c_void_p(handle),
+            ctypes.c_int(len(ndargs)),
+            c_handle_array(ndargs),
+            ctypes.byref(num_output),
+            ctypes.byref(output_vars),
+            ctypes.c_int(len(keys)),
+            c_str_array(keys),
+            c_str_array(vals),
+            ctypes.byref(out_stypes)))
 
     if original_output is not None:
         return original_output
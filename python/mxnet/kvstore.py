@@ -407,6 +407,19 @@ class KVStore(object):
         original values is stored at the sender's end as residual and added to the
         gradient in the next iteration.
 
+        The other types also keep what was not sent in the residual:
+
+        - `1bit` sends the sign of every value, and the mean of the absolute values of
+          each block of 1024 values.
+        - `8bit` sends every value as a signed byte, scaled by the largest absolute value
+          of its block of 256 values. Values are rounded up or down at random so that the
+          sent values are unbiased.
+        - `topk` sends only the `k` (default 8) values of largest magnitude of every
+          block of 256 values, with their positions.
+
+        These three types are only implemented for arrays on CPU, so they can be used
+        with 'dist' kvstores but not for communication between GPUs.
+
         When kvstore is 'local', gradient compression is used to reduce communication
         between multiple devices (gpus). Gradient is quantized on each GPU which
         computed the gradients, then sent to the GPU which merges the gradients. This
@@ -428,6 +441,8 @@ class KVStore(object):
         To completely specify the arguments for 2bit compression, we would need to pass
         a dictionary which includes `threshold` like:
         {'type': '2bit', 'threshold': 0.5}
+        Similarly, top-k sparsification sending 4 of every 256 values is specified as
+        {'type': 'topk', 'k': 4}
 
         Parameters
         ----------
@@ -435,7 +450,7 @@ class KVStore(object):
             A dictionary specifying the type and parameters for gradient compression.
             The key `type` in this dictionary is a
             required string argument and specifies the type of gradient compression.
-            Currently `type` can be only `2bit`
+            Currently `type` can be `2bit`, `1bit`, `8bit` or `topk`
             Other keys in this dictionary are optional and specific to the type
             of gradient compression.
         """
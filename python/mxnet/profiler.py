@@ -21,6 +21,8 @@
 """Profiler setting methods."""
 from __future__ import absolute_import
 import ctypes
+import json
+import struct
 import warnings
 from .base import _LIB, check_call, c_str, ProfileHandle, c_str_array, py_str, KVStoreHandle
 
@@ -58,6 +60,11 @@ def set_config(**kwargs):
         whether to profile kvstore `server` or `worker`.
         server can only be profiled when kvstore is of type dist.
         if this is not passed, defaults to `worker`
+    binary_trace : boolean
+        whether to stream profiling data to `filename` in a compact binary
+        format, written every `dump_period` seconds by a background thread.
+        Events are dropped rather than blocking when a thread records faster
+        than they are written. Use `convert_trace` to view the file.
     """
     kk = kwargs.keys()
     vv = kwargs.values()
@@ -162,6 +169,27 @@ def dumps(reset=False):
     return py_str(debug_str.value)
 
 
+def latency(reset=False):
+    """Return the latency percentiles of the aggregate profile stats, requires
+    `set_config(aggregate_stats=True)`. Cheap enough to be polled by monitoring.
+
+    Parameters
+    ----------
+    reset: boolean
+        Indicates whether to clean the latency histograms after this snapshot
+
+    Returns
+    -------
+    dict of str to list of dict
+        For each category, the durations by name and device, with keys `name`,
+        `device`, `count`, `mean`, `min`, `max`, `p50`, `p90`, `p99` and `p999`.
+        Times are in microseconds.
+    """
+    out_json = ctypes.c_char_p()
+    check_call(_LIB.MXAggregateProfileLatency(ctypes.byref(out_json), int(reset)))
+    return json.loads(py_str(out_json.value))
+
+
 def pause(profile_process='worker'):
     """Pause profiling.
 
@@ -195,6 +223,61 @@ def resume(profile_process='worker'):
                                           profiler_kvstore_handle))
 
 
+def convert_trace(trace_filename, json_filename):
+    """Convert a binary trace, written with `set_config(binary_trace=True)`,
+    into chrome://tracing json. This does not need the profiled process.
+
+    Parameters
+    ----------
+    trace_filename : string
+        binary trace file
+    json_filename : string
+        output json file
+    """
+    category_pid = 0xffffffff
+    with open(trace_filename, 'rb') as fin, open(json_filename, 'w') as fout:
+        magic, record_size, num_devices = struct.unpack('<8sII', fin.read(16))
+        if magic != b'MXTRACE1':
+            raise ValueError('%s is not a binary trace' % trace_filename)
+        record = struct.Struct('<4QI2s2x24s128s')
+        if record_size != record.size:
+            raise ValueError('unsupported trace record size %d' % record_size)
+        events = []
+        for pid in range(num_devices):
+            length, = struct.unpack('<I', fin.read(4))
+            name = fin.read(length).decode('utf-8')
+            events.append({'ph': 'M', 'args': {'name': name}, 'pid': pid, 'name': 'process_name'})
+        fout.write('{\n    "traceEvents": [\n')
+        fout.write(',\n'.join(json.dumps(e) for e in events))
+        category_pids = {}
+        while True:
+            data = fin.read(record_size)
+            if len(data) < record_size:
+                break
+            ts0, ts1, tid, arg, pid, types, cat, name = record.unpack(data)
+            cat = cat.split(b'\0', 1)[0].decode('utf-8', 'replace')
+            name = name.split(b'\0', 1)[0].decode('utf-8', 'replace')
+            if pid == category_pid:
+                if cat not in category_pids:
+                    category_pids[cat] = num_devices + len(category_pids)
+                    fout.write(',\n' + json.dumps({'ph': 'M', 'args': {'name': cat},
+                                                    'pid': category_pids[cat],
+                                                    'name': 'process_name'}))
+                pid = category_pids[cat]
+            for ph, ts in zip(types.decode('ascii'), (ts0, ts1)):
+                if ph == '\0':
+                    continue
+                event = {'name': name, 'cat': cat, 'ph': ph, 'ts': ts, 'pid': pid, 'tid': tid}
+                if ph == 'C':
+                    event['args'] = {name: arg}
+                elif ph in 'be':
+                    event['id'] = tid
+                elif ph in 'in':
+                    event['s'] = chr(arg)
+                fout.write(',\n' + json.dumps(event))
+        fout.write('\n    ],\n    "displayTimeUnit": "ms"\n}\n')
+
+
 class Domain(object):
     """Profiling domain, used to group sub-objects like tasks, counters, etc into categories
     Serves as part of 'categories' for chrome://tracing
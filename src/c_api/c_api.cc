@@ -299,11 +299,12 @@ int MXNDArrayWaitAll() {
   API_END();
 }
 
-int MXNDArraySave(const char* fname,
-                  mx_uint num_args,
-                  NDArrayHandle* args,
-                  const char** keys) {
-  API_BEGIN();
+/*! \brief save the arrays to fname, aligned for memory mapping if aligned is true */
+static void SaveNDArrays(const char* fname,
+                         mx_uint num_args,
+                         NDArrayHandle* args,
+                         const char** keys,
+                         bool aligned) {
   std::vector<NDArray> data(num_args);
   std::vector<std::string> names;
   for (mx_uint i = 0; i < num_args; ++i) {
@@ -317,8 +318,29 @@ int MXNDArraySave(const char* fname,
   }
   {
     std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
-    mxnet::NDArray::Save(fo.get(), data, names);
+    if (aligned) {
+      mxnet::NDArray::SaveAligned(fo.get(), data, names);
+    } else {
+      mxnet::NDArray::Save(fo.get(), data, names);
+    }
   }
+}
+
+int MXNDArraySave(const char* fname,
+                  mx_uint num_args,
+                  NDArrayHandle* args,
+                  const char** keys) {
+  API_BEGIN();
+  SaveNDArrays(fname, num_args, args, keys, false);
+  API_END();
+}
+
+int MXNDArraySaveAligned(const char* fname,
+                         mx_uint num_args,
+                         NDArrayHandle* args,
+                         const char** keys) {
+  API_BEGIN();
+  SaveNDArrays(fname, num_args, args, keys, true);
   API_END();
 }
 
@@ -332,10 +354,7 @@ int MXNDArrayLoad(const char* fname,
   API_BEGIN();
   std::vector<NDArray> data;
   std::vector<std::string> &names = ret->ret_vec_str;
-  {
-    std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(fname, "r"));
-    mxnet::NDArray::Load(fi.get(), &data, &names);
-  }
+  mxnet::NDArray::LoadFile(fname, &data, &names);
   ret->ret_handles.resize(data.size());
   for (size_t i = 0; i < data.size(); ++i) {
     NDArray *ptr = new NDArray();
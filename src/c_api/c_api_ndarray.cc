@@ -31,6 +31,7 @@
 #include <mxnet/imperative.h>
 #include <nnvm/node.h>
 #include <nnvm/op_attr_types.h>
+#include <memory>
 #include <string>
 #include "./c_api_common.h"
 #include "../common/utils.h"
@@ -78,31 +79,40 @@ void SetNDInputsOutputs(const nnvm::Op* op,
   }
 }
 
-void MXImperativeInvokeImpl(AtomicSymbolCreator creator,
+// an operator with its attributes parsed once, for invoking it many times
+struct MXAPIParsedOp {
+  // the parsed attributes, including the op
+  nnvm::NodeAttrs attrs;
+  // the number of inputs the attributes were parsed for
+  int num_inputs;
+  // the number of outputs, and of those visible to the caller
+  int infered_num_outputs;
+  int num_visible_outputs;
+};
+
+/*!
+ * \brief invoke the op of attrs, which were parsed for num_inputs inputs
+ * \param attrs the parsed attributes
+ * \param keep_attrs whether attrs are used again, otherwise recording moves from them
+ */
+void ImperativeInvokeParsed(nnvm::NodeAttrs* attrs,
+                            bool keep_attrs,
+                            int infered_num_outputs,
+                            int num_visible_outputs,
                             int num_inputs,
                             NDArrayHandle *inputs,
                             int *num_outputs,
-                            NDArrayHandle **outputs,
-                            int num_params,
-                            const char **param_keys,
-                            const char **param_vals) {
-  const nnvm::Op* op = static_cast<nnvm::Op*>(creator);
+                            NDArrayHandle **outputs) {
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
 
-  nnvm::NodeAttrs attrs = imperative::ParseAttrs(op, num_inputs, num_params,
-                                                 param_keys, param_vals);
-
-  int infered_num_outputs;
-  int num_visible_outputs;
-  imperative::SetNumOutputs(op, attrs, num_inputs, &infered_num_outputs, &num_visible_outputs);
-
   std::vector<NDArray*> ndinputs, ndoutputs;
-  SetNDInputsOutputs(op, &ndinputs, &ndoutputs, num_inputs, inputs,
+  SetNDInputsOutputs(attrs->op, &ndinputs, &ndoutputs, num_inputs, inputs,
       num_outputs, infered_num_outputs, num_visible_outputs, outputs);
 
-  auto state = Imperative::Get()->Invoke(Context::CPU(), attrs, ndinputs, ndoutputs);
+  auto state = Imperative::Get()->Invoke(Context::CPU(), *attrs, ndinputs, ndoutputs);
   if (Imperative::Get()->is_recording()) {
-    Imperative::Get()->RecordOp(std::move(attrs), ndinputs, ndoutputs, state);
+    Imperative::Get()->RecordOp(keep_attrs ? nnvm::NodeAttrs(*attrs) : std::move(*attrs),
+                                ndinputs, ndoutputs, state);
   }
 
   for (int i = *num_outputs; i < infered_num_outputs; ++i) delete ndoutputs[i];
@@ -115,6 +125,39 @@ void MXImperativeInvokeImpl(AtomicSymbolCreator creator,
   }
 }
 
+void MXImperativeInvokeImpl(AtomicSymbolCreator creator,
+                            int num_inputs,
+                            NDArrayHandle *inputs,
+                            int *num_outputs,
+                            NDArrayHandle **outputs,
+                            int num_params,
+                            const char **param_keys,
+                            const char **param_vals) {
+  const nnvm::Op* op = static_cast<nnvm::Op*>(creator);
+
+  nnvm::NodeAttrs attrs = imperative::ParseAttrs(op, num_inputs, num_params,
+                                                 param_keys, param_vals);
+
+  int infered_num_outputs;
+  int num_visible_outputs;
+  imperative::SetNumOutputs(op, attrs, num_inputs, &infered_num_outputs, &num_visible_outputs);
+
+  ImperativeInvokeParsed(&attrs, false, infered_num_outputs, num_visible_outputs,
+                         num_inputs, inputs, num_outputs, outputs);
+}
+
+/*! \brief the storage types of the outputs, kept in the thread local store */
+void SetOutputStypes(int num_outputs, NDArrayHandle *outputs, const int **out_stypes) {
+  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+  NDArray** out_array = reinterpret_cast<NDArray**>(outputs);
+  ret->out_types.clear();
+  ret->out_types.reserve(num_outputs);
+  for (int i = 0; i < num_outputs; ++i) {
+    ret->out_types.emplace_back(out_array[i]->storage_type());
+  }
+  *out_stypes = dmlc::BeginPtr(ret->out_types);
+}
+
 int MXImperativeInvoke(AtomicSymbolCreator creator,
                        int num_inputs,
                        NDArrayHandle *inputs,
@@ -138,17 +181,50 @@ int MXImperativeInvokeEx(AtomicSymbolCreator creator,
                          const char **param_keys,
                          const char **param_vals,
                          const int **out_stypes) {  // outputs storage types
-  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
   API_BEGIN();
   MXImperativeInvokeImpl(creator, num_inputs, inputs, num_outputs, outputs,
                          num_params, param_keys, param_vals);
-  NDArray** out_array = *reinterpret_cast<NDArray***>(outputs);
-  ret->out_types.clear();
-  ret->out_types.reserve(*num_outputs);
-  for (int i = 0; i < *num_outputs; ++i) {
-    ret->out_types.emplace_back(out_array[i]->storage_type());
-  }
-  *out_stypes = dmlc::BeginPtr(ret->out_types);
+  SetOutputStypes(*num_outputs, *outputs, out_stypes);
+  API_END();
+}
+
+int MXCreateParsedOp(AtomicSymbolCreator creator,
+                     int num_inputs,
+                     int num_params,
+                     const char **param_keys,
+                     const char **param_vals,
+                     ParsedOpHandle *out) {
+  const nnvm::Op* op = static_cast<nnvm::Op*>(creator);
+  API_BEGIN();
+  std::unique_ptr<MXAPIParsedOp> ret(new MXAPIParsedOp());
+  ret->attrs = imperative::ParseAttrs(op, num_inputs, num_params, param_keys, param_vals);
+  ret->num_inputs = num_inputs;
+  imperative::SetNumOutputs(op, ret->attrs, num_inputs,
+                            &ret->infered_num_outputs, &ret->num_visible_outputs);
+  *out = ret.release();
+  API_END();
+}
+
+int MXFreeParsedOp(ParsedOpHandle handle) {
+  API_BEGIN();
+  delete static_cast<MXAPIParsedOp*>(handle);
+  API_END();
+}
+
+int MXInvokeParsedOp(ParsedOpHandle handle,
+                     int num_inputs,
+                     NDArrayHandle *inputs,
+                     int *num_outputs,
+                     NDArrayHandle **outputs,
+                     const int **out_stypes) {
+  MXAPIParsedOp* p = static_cast<MXAPIParsedOp*>(handle);
+  API_BEGIN();
+  CHECK_EQ(num_inputs, p->num_inputs)
+      << "Operator " << p->attrs.op->name << " was parsed for " << p->num_inputs
+      << " inputs, but got " << num_inputs << " instead.";
+  ImperativeInvokeParsed(&p->attrs, true, p->infered_num_outputs, p->num_visible_outputs,
+                         num_inputs, inputs, num_outputs, outputs);
+  SetOutputStypes(*num_outputs, *outputs, out_stypes);
   API_END();
 }
 
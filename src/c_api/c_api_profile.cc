@@ -212,6 +212,7 @@ struct ProfileConfigParam : public dmlc::Parameter<ProfileConfigParam> {
   bool continuous_dump;
   float dump_period;
   bool aggregate_stats;
+  bool binary_trace;
   int profile_process;
   DMLC_DECLARE_PARAMETER(ProfileConfigParam) {
     DMLC_DECLARE_FIELD(profile_all).set_default(false)
@@ -234,6 +235,10 @@ struct ProfileConfigParam : public dmlc::Parameter<ProfileConfigParam> {
     DMLC_DECLARE_FIELD(aggregate_stats).set_default(false)
       .describe("Maintain aggregate stats, required for MXDumpAggregateStats.  Note that "
       "this can have anegative performance impact.");
+    DMLC_DECLARE_FIELD(binary_trace).set_default(false)
+      .describe("Stream profiling data to the file in a compact binary format through "
+                "bounded per-thread buffers, written every dump_period seconds. "
+                "Use mxnet.profiler.convert_trace to turn the file into json.");
     DMLC_DECLARE_FIELD(profile_process)
       .add_enum("worker", static_cast<int>(ProfileProcess::kWorker))
       .add_enum("server", static_cast<int>(ProfileProcess::kServer))
@@ -296,7 +301,8 @@ int MXSetProcessProfilerConfig(int num_params, const char* const* keys, const ch
                                            std::string(param.filename),
                                            param.continuous_dump,
                                            param.dump_period,
-                                           param.aggregate_stats);
+                                           param.aggregate_stats,
+                                           param.binary_trace);
     }
   API_END();
 }
@@ -310,10 +316,7 @@ int MXAggregateProfileStatsPrint(const char **out_str, int reset) {
   API_BEGIN();
     CHECK_NOTNULL(out_str);
     profiler::Profiler *profiler = profiler::Profiler::Get();
-    if (profiler->IsEnableOutput()) {
-      // Register stats up until now
-      profiler->DumpProfile(false);
-    }
+    // statistics are aggregated when recorded
     std::shared_ptr<profiler::AggregateStats> stats = profiler->GetAggregateStats();
     std::ostringstream os;
     if (stats) {
@@ -324,6 +327,23 @@ int MXAggregateProfileStatsPrint(const char **out_str, int reset) {
   API_END();
 }
 
+int MXAggregateProfileLatency(const char **out_json, int reset) {
+  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+  API_BEGIN();
+    CHECK_NOTNULL(out_json);
+    std::shared_ptr<profiler::AggregateStats> stats =
+      profiler::Profiler::Get()->GetAggregateStats();
+    std::ostringstream os;
+    if (stats) {
+      stats->DumpLatency(os, reset != 0);
+    } else {
+      os << "{}";
+    }
+    ret->ret_str = os.str();
+    *out_json = (ret->ret_str).c_str();
+  API_END();
+}
+
 int MXDumpProfile(int finished) {
   return MXDumpProcessProfile(finished, static_cast<int>(ProfileProcess::kWorker), nullptr);
 }
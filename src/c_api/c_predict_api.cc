@@ -28,35 +28,61 @@
 #include <mxnet/executor.h>
 #include <mxnet/ndarray.h>
 #include <nnvm/pass_functions.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 #include "./c_api_common.h"
+#include "./c_predict_api_common.h"
+#include "../common/mapped_file.h"
 #include "../operator/operator_common.h"
 #include "../executor/exec_pass.h"
 
 using namespace mxnet;
 
-// predictor interface
-struct MXAPIPredictor {
-  // output arrays
-  std::vector<NDArray> out_arrays;
-  // argument arrays
-  std::vector<NDArray> arg_arrays;
-  // auxiliary arrays
-  std::vector<NDArray> aux_arrays;
-  // output shapes
+// a request waiting in a batcher
+struct MXAPIBatchRequest {
+  // one pointer per input and output, each to the data of this request only
+  const mx_float* const* inputs;
+  mx_float* const* outputs;
+  // when the request was queued
+  std::chrono::steady_clock::time_point arrival;
+  // set by the worker when the outputs have been written
+  bool done = false;
+  // the error of the batch, if any
+  std::string error;
+};
+
+// coalesces single requests into batches run by predictors bound for a few batch sizes
+struct MXAPIPredictorBatcher {
+  // the weights shared by the predictors
+  std::unique_ptr<MXAPIPredictorPool> pool;
+  // input names and number of elements of one request
+  std::vector<std::string> input_keys;
+  std::vector<size_t> input_sizes;
+  // output shapes and number of elements of one request
   std::vector<TShape> out_shapes;
+  std::vector<size_t> out_sizes;
   // uint32_t buffer for output shapes
   std::vector<uint32_t> out_shapes_buffer;
-  // key to arguments
-  std::unordered_map<std::string, size_t> key2arg;
-  // executor
-  std::unique_ptr<Executor> exec;
-  // symbol
-  nnvm::Symbol sym;
-  // Context
-  Context ctx;
+  // ascending batch sizes, and the predictor bound for each
+  std::vector<size_t> bucket_sizes;
+  std::vector<std::unique_ptr<MXAPIPredictor>> buckets;
+  // longest time a request waits for others to join its batch
+  std::chrono::microseconds max_delay;
+  // guards queue, stop and the done flags of the requests
+  std::mutex mutex;
+  std::condition_variable queue_cv, done_cv;
+  std::deque<MXAPIBatchRequest*> queue;
+  bool stop = false;
+  // runs the batches
+  std::thread worker;
+  // staging buffers of the worker
+  std::vector<mx_float> input_buffer, output_buffer;
 };
 
 struct MXAPINDList {
@@ -84,23 +110,10 @@ inline void _CreateExecutor(PredictorHandle pred_hnd) {
   }
 }
 
-int _CreatePartialOut(const char* symbol_json_str,
-                      const void* param_bytes,
-                      int param_size,
-                      int dev_type, int dev_id,
-                      mx_uint num_input_nodes,
-                      const char** input_keys,
-                      const mx_uint* input_shape_indptr,
-                      const mx_uint* input_shape_data,
-                      mx_uint num_output_nodes,
-                      const char** output_keys,
-                      // This is used for parallel inference.
-                      int num_threads,
-                      bool lazy,
-                      PredictorHandle* out) {
+nnvm::Symbol _LoadSymbol(const char* symbol_json_str,
+                         mx_uint num_output_nodes,
+                         const char** output_keys) {
   using nnvm::Symbol;
-
-  API_BEGIN();
   Symbol sym;
   // make sure symbols are registered
   {
@@ -132,64 +145,57 @@ int _CreatePartialOut(const char* symbol_json_str,
     }
     sym = nnvm::Symbol::CreateGroup(out_syms);
   }
+  return sym;
+}
 
-  // load the parameters
-  std::unordered_map<std::string, NDArray> arg_params, aux_params;
-  {
-    std::unordered_set<std::string> arg_names, aux_names;
-    std::vector<std::string> arg_names_vec = sym.ListInputNames(Symbol::kReadOnlyArgs);
-    std::vector<std::string> aux_names_vec = sym.ListInputNames(Symbol::kAuxiliaryStates);
-    for (const auto &arg_name : arg_names_vec) {
-      arg_names.insert(arg_name);
-    }
-    for (const auto &aux_name : aux_names_vec) {
-      aux_names.insert(aux_name);
-    }
-    std::vector<NDArray> data;
-    std::vector<std::string> names;
-    dmlc::MemoryFixedSizeStream fi((void*)param_bytes, param_size);  // NOLINT(*)
-    NDArray::Load(&fi, &data, &names);
-    CHECK_EQ(names.size(), data.size())
-        << "Invalid param file format";
-    for (size_t i = 0; i < names.size(); ++i) {
-      if (!strncmp(names[i].c_str(), "aux:", 4)) {
-        std::string name(names[i].c_str() + 4);
-        if (aux_names.count(name) != 0) {
-          aux_params[name] = data[i];
-        }
+// sort the loaded parameters into arguments and auxiliary states of sym
+void _SplitParams(const nnvm::Symbol& sym,
+                  const std::vector<NDArray>& data,
+                  const std::vector<std::string>& names,
+                  std::unordered_map<std::string, NDArray>* arg_params,
+                  std::unordered_map<std::string, NDArray>* aux_params) {
+  using nnvm::Symbol;
+  std::unordered_set<std::string> arg_names, aux_names;
+  std::vector<std::string> arg_names_vec = sym.ListInputNames(Symbol::kReadOnlyArgs);
+  std::vector<std::string> aux_names_vec = sym.ListInputNames(Symbol::kAuxiliaryStates);
+  for (const auto &arg_name : arg_names_vec) {
+    arg_names.insert(arg_name);
+  }
+  for (const auto &aux_name : aux_names_vec) {
+    aux_names.insert(aux_name);
+  }
+  CHECK_EQ(names.size(), data.size())
+      << "Invalid param file format";
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!strncmp(names[i].c_str(), "aux:", 4)) {
+      std::string name(names[i].c_str() + 4);
+      if (aux_names.count(name) != 0) {
+        (*aux_params)[name] = data[i];
       }
-      if (!strncmp(names[i].c_str(), "arg:", 4)) {
-        std::string name(names[i].c_str() + 4);
-        if (arg_names.count(name) != 0) {
-          arg_params[name] = data[i];
-        }
+    }
+    if (!strncmp(names[i].c_str(), "arg:", 4)) {
+      std::string name(names[i].c_str() + 4);
+      if (arg_names.count(name) != 0) {
+        (*arg_params)[name] = data[i];
       }
     }
   }
+}
 
-  // shape inference and bind
-  std::unordered_map<std::string, TShape> known_shape;
-  for (mx_uint i = 0; i < num_input_nodes; ++i) {
-    known_shape[std::string(input_keys[i])] =
-        TShape(input_shape_data + input_shape_indptr[i],
-               input_shape_data + input_shape_indptr[i + 1]);
-  }
-  std::vector<std::string> arg_names = sym.ListInputNames(Symbol::kReadOnlyArgs);
-  std::vector<std::string> aux_names = sym.ListInputNames(Symbol::kAuxiliaryStates);
-  std::vector<TShape> out_shapes(sym.ListOutputNames().size());
-  std::vector<TShape> aux_shapes(aux_names.size());
-  std::vector<TShape> arg_shapes;
-  std::unordered_map<std::string, size_t> key2arg;
-  for (size_t i = 0; i < arg_names.size(); ++i) {
-    std::string key = arg_names[i];
-    key2arg[key] = i;
-  }
-
+void _InferShape(const nnvm::Symbol& sym,
+                 const std::unordered_map<std::string, TShape>& known_shape,
+                 std::vector<TShape>* arg_shapes,
+                 std::vector<TShape>* out_shapes,
+                 std::vector<TShape>* aux_shapes) {
+  using nnvm::Symbol;
+  out_shapes->resize(sym.ListOutputNames().size());
+  aux_shapes->resize(sym.ListInputNames(Symbol::kAuxiliaryStates).size());
   try {
     std::vector<TShape> in_shapes;
     for (std::string key : sym.ListInputNames(Symbol::kAll)) {
-      if (known_shape.count(key) != 0) {
-        in_shapes.push_back(known_shape[key]);
+      auto it = known_shape.find(key);
+      if (it != known_shape.end()) {
+        in_shapes.push_back(it->second);
       } else {
         in_shapes.emplace_back();
       }
@@ -201,10 +207,66 @@ int _CreatePartialOut(const char* symbol_json_str,
       << "The shape information of is not enough to get the shapes";
     CopyAttr(g.indexed_graph(),
              g.GetAttr<nnvm::ShapeVector>("shape"),
-             &arg_shapes, &out_shapes, &aux_shapes);
+             arg_shapes, out_shapes, aux_shapes);
   } catch (const mxnet::op::InferShapeError &err) {
     throw dmlc::Error(err.msg);
   }
+}
+
+std::unordered_map<std::string, TShape> _InputShapes(mx_uint num_input_nodes,
+                                                     const char** input_keys,
+                                                     const mx_uint* input_shape_indptr,
+                                                     const mx_uint* input_shape_data) {
+  std::unordered_map<std::string, TShape> known_shape;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    known_shape[std::string(input_keys[i])] =
+        TShape(input_shape_data + input_shape_indptr[i],
+               input_shape_data + input_shape_indptr[i + 1]);
+  }
+  return known_shape;
+}
+
+int _CreatePartialOut(const char* symbol_json_str,
+                      const void* param_bytes,
+                      int param_size,
+                      int dev_type, int dev_id,
+                      mx_uint num_input_nodes,
+                      const char** input_keys,
+                      const mx_uint* input_shape_indptr,
+                      const mx_uint* input_shape_data,
+                      mx_uint num_output_nodes,
+                      const char** output_keys,
+                      // This is used for parallel inference.
+                      int num_threads,
+                      bool lazy,
+                      PredictorHandle* out) {
+  using nnvm::Symbol;
+
+  API_BEGIN();
+  Symbol sym = _LoadSymbol(symbol_json_str, num_output_nodes, output_keys);
+
+  // load the parameters
+  std::unordered_map<std::string, NDArray> arg_params, aux_params;
+  {
+    std::vector<NDArray> data;
+    std::vector<std::string> names;
+    dmlc::MemoryFixedSizeStream fi((void*)param_bytes, param_size);  // NOLINT(*)
+    NDArray::Load(&fi, &data, &names);
+    _SplitParams(sym, data, names, &arg_params, &aux_params);
+  }
+
+  // shape inference and bind
+  std::unordered_map<std::string, TShape> known_shape = _InputShapes(
+      num_input_nodes, input_keys, input_shape_indptr, input_shape_data);
+  std::vector<std::string> arg_names = sym.ListInputNames(Symbol::kReadOnlyArgs);
+  std::vector<std::string> aux_names = sym.ListInputNames(Symbol::kAuxiliaryStates);
+  std::vector<TShape> out_shapes, aux_shapes, arg_shapes;
+  std::unordered_map<std::string, size_t> key2arg;
+  for (size_t i = 0; i < arg_names.size(); ++i) {
+    std::string key = arg_names[i];
+    key2arg[key] = i;
+  }
+  _InferShape(sym, known_shape, &arg_shapes, &out_shapes, &aux_shapes);
 
   Context ctx = Context::Create(static_cast<Context::DeviceType>(dev_type), dev_id);
 
@@ -232,13 +294,22 @@ int _CreatePartialOut(const char* symbol_json_str,
     ret->arg_arrays = arg_arrays;
     ret->aux_arrays = aux_arrays;
     ret->out_shapes = out_shapes;
+    if (i > 0) {
+      // the weights are shared, but every predictor needs inputs of its own
+      for (const auto& kv : known_shape) {
+        auto it = key2arg.find(kv.first);
+        if (it != key2arg.end()) {
+          ret->arg_arrays[it->second] = NDArray(arg_shapes[it->second], ctx);
+        }
+      }
+    }
 
     if (!lazy) {
       std::map<std::string, Context> ctx_map;
       std::vector<NDArray> grad_store(arg_arrays.size());
       std::vector<OpReqType> grad_req(arg_arrays.size(), kNullOp);
       ret->exec.reset(Executor::Bind(sym, ctx, ctx_map,
-                                     arg_arrays,
+                                     ret->arg_arrays,
                                      grad_store, grad_req,
                                      aux_arrays));
       ret->out_arrays = ret->exec->outputs();
@@ -336,6 +407,342 @@ int MXPredCreateMultiThread(const char* symbol_json_str,
       out);
 }
 
+// a weight of shape on ctx, which is param itself when it can be used without a copy
+NDArray _SharedWeight(const NDArray* param, const TShape& shape, const Context& ctx) {
+  if (param != nullptr && param->ctx() == ctx && param->dtype() == mshadow::kFloat32 &&
+      param->storage_type() == kDefaultStorage && param->shape().Size() == shape.Size()) {
+    return param->shape() == shape ? *param : param->Reshape(shape);
+  }
+  NDArray nd(shape, ctx);
+  if (param != nullptr) {
+    CopyFromTo(*param, &nd);
+  }
+  return nd;
+}
+
+MXAPIPredictorPool* _CreatePool(const char* symbol_json_str,
+                                char* param_buffer,
+                                size_t param_size,
+                                const std::shared_ptr<void>& param_owner,
+                                int dev_type, int dev_id,
+                                mx_uint num_input_nodes,
+                                const char** input_keys,
+                                const mx_uint* input_shape_indptr,
+                                const mx_uint* input_shape_data) {
+  using nnvm::Symbol;
+
+  std::unique_ptr<MXAPIPredictorPool> pool(new MXAPIPredictorPool());
+  pool->sym = _LoadSymbol(symbol_json_str, 0, nullptr);
+
+  // the parameters refer to param_buffer where possible
+  std::unordered_map<std::string, NDArray> arg_params, aux_params;
+  {
+    std::vector<NDArray> data;
+    std::vector<std::string> names;
+    NDArray::LoadFromMemory(param_buffer, param_size, param_owner, &data, &names);
+    _SplitParams(pool->sym, data, names, &arg_params, &aux_params);
+  }
+
+  std::unordered_map<std::string, TShape> known_shape = _InputShapes(
+      num_input_nodes, input_keys, input_shape_indptr, input_shape_data);
+  std::vector<std::string> arg_names = pool->sym.ListInputNames(Symbol::kReadOnlyArgs);
+  std::vector<std::string> aux_names = pool->sym.ListInputNames(Symbol::kAuxiliaryStates);
+  std::vector<TShape> aux_shapes, arg_shapes;
+  _InferShape(pool->sym, known_shape, &arg_shapes, &pool->out_shapes, &aux_shapes);
+
+  pool->ctx = Context::Create(static_cast<Context::DeviceType>(dev_type), dev_id);
+  for (size_t i = 0; i < arg_names.size(); ++i) {
+    pool->key2arg[arg_names[i]] = i;
+    pool->is_input.push_back(known_shape.count(arg_names[i]) != 0);
+    if (pool->is_input.back()) {
+      // never allocated, each predictor has its own
+      pool->arg_arrays.emplace_back(arg_shapes[i], pool->ctx, true);
+    } else {
+      auto it = arg_params.find(arg_names[i]);
+      pool->arg_arrays.push_back(_SharedWeight(it == arg_params.end() ? nullptr : &it->second,
+                                               arg_shapes[i], pool->ctx));
+    }
+  }
+  for (size_t i = 0; i < aux_names.size(); ++i) {
+    auto it = aux_params.find(aux_names[i]);
+    pool->aux_arrays.push_back(_SharedWeight(it == aux_params.end() ? nullptr : &it->second,
+                                             aux_shapes[i], pool->ctx));
+  }
+  return pool.release();
+}
+
+int MXPredPoolCreate(const char* symbol_json_str,
+                     const void* param_bytes,
+                     int param_size,
+                     int dev_type, int dev_id,
+                     mx_uint num_input_nodes,
+                     const char** input_keys,
+                     const mx_uint* input_shape_indptr,
+                     const mx_uint* input_shape_data,
+                     PredictorPoolHandle* out) {
+  API_BEGIN();
+  // one copy of the bytes, shared by all predictors
+  auto buffer = std::make_shared<std::vector<char>>(
+      static_cast<const char*>(param_bytes), static_cast<const char*>(param_bytes) + param_size);
+  *out = _CreatePool(symbol_json_str, buffer->data(), buffer->size(), buffer,
+                     dev_type, dev_id, num_input_nodes, input_keys,
+                     input_shape_indptr, input_shape_data);
+  API_END();
+}
+
+int MXPredPoolCreateFromFile(const char* symbol_json_str,
+                             const char* param_file,
+                             int dev_type, int dev_id,
+                             mx_uint num_input_nodes,
+                             const char** input_keys,
+                             const mx_uint* input_shape_indptr,
+                             const mx_uint* input_shape_data,
+                             PredictorPoolHandle* out) {
+  API_BEGIN();
+  auto file = std::make_shared<common::MappedFile>(param_file);
+  *out = _CreatePool(symbol_json_str, file->data(), file->size(), file,
+                     dev_type, dev_id, num_input_nodes, input_keys,
+                     input_shape_indptr, input_shape_data);
+  API_END();
+}
+
+/*!
+ * \brief a predictor using the weights of pool, with its own inputs of the shapes in
+ *  input_shapes, or of the shapes the pool was created with when it is empty.
+ *  The predictor shares the memory of shared_exec when given, so both must not run at once.
+ */
+MXAPIPredictor* _PoolPredictor(MXAPIPredictorPool* pool,
+                               const std::unordered_map<std::string, TShape>& input_shapes,
+                               Executor* shared_exec = nullptr) {
+  using nnvm::Symbol;
+  std::unique_ptr<MXAPIPredictor> ret(new MXAPIPredictor());
+  ret->sym = pool->sym;
+  ret->ctx = pool->ctx;
+  ret->key2arg = pool->key2arg;
+  ret->out_shapes = pool->out_shapes;
+  ret->arg_arrays = pool->arg_arrays;
+  ret->aux_arrays = pool->aux_arrays;
+  std::vector<TShape> arg_shapes;
+  if (input_shapes.empty()) {
+    for (const NDArray& arg : pool->arg_arrays) {
+      arg_shapes.push_back(arg.shape());
+    }
+  } else {
+    std::vector<TShape> aux_shapes;
+    _InferShape(pool->sym, input_shapes, &arg_shapes, &ret->out_shapes, &aux_shapes);
+    std::vector<std::string> arg_names = pool->sym.ListInputNames(Symbol::kReadOnlyArgs);
+    for (size_t i = 0; i < arg_names.size(); ++i) {
+      CHECK(pool->is_input[i] || arg_shapes[i] == pool->arg_arrays[i].shape())
+          << "arg " << arg_names[i]
+          << " shape has been changed, only allow to change the shape of input data.";
+    }
+  }
+  for (size_t i = 0; i < ret->arg_arrays.size(); ++i) {
+    if (pool->is_input[i]) {
+      ret->arg_arrays[i] = NDArray(arg_shapes[i], pool->ctx);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    std::map<std::string, Context> ctx_map;
+    std::vector<NDArray> grad_store(ret->arg_arrays.size());
+    std::vector<OpReqType> grad_req(ret->arg_arrays.size(), kNullOp);
+    ret->exec.reset(Executor::Bind(ret->sym, ret->ctx, ctx_map,
+                                   ret->arg_arrays,
+                                   grad_store, grad_req,
+                                   ret->aux_arrays,
+                                   shared_exec));
+  }
+  ret->out_arrays = ret->exec->outputs();
+  return ret.release();
+}
+
+int MXPredPoolCreatePredictor(PredictorPoolHandle handle, PredictorHandle* out) {
+  MXAPIPredictorPool* pool = static_cast<MXAPIPredictorPool*>(handle);
+  API_BEGIN();
+  *out = _PoolPredictor(pool, {});
+  API_END();
+}
+
+int MXPredPoolFree(PredictorPoolHandle handle) {
+  API_BEGIN();
+  delete static_cast<MXAPIPredictorPool*>(handle);
+  API_END();
+}
+
+// gathers the inputs of batch, runs the smallest predictor that fits and scatters the outputs
+void _RunBatch(MXAPIPredictorBatcher* b, const std::vector<MXAPIBatchRequest*>& batch) {
+  size_t bucket = 0;
+  while (b->bucket_sizes[bucket] < batch.size()) ++bucket;
+  const size_t batch_size = b->bucket_sizes[bucket];
+  MXAPIPredictor* p = b->buckets[bucket].get();
+  for (size_t i = 0; i < b->input_keys.size(); ++i) {
+    const size_t size = b->input_sizes[i];
+    // rows past the requests are padding
+    b->input_buffer.assign(size * batch_size, 0.0f);
+    for (size_t r = 0; r < batch.size(); ++r) {
+      std::copy(batch[r]->inputs[i], batch[r]->inputs[i] + size,
+                b->input_buffer.begin() + r * size);
+    }
+    p->arg_arrays[p->key2arg.at(b->input_keys[i])].SyncCopyFromCPU(b->input_buffer.data(),
+                                                                   b->input_buffer.size());
+  }
+  p->exec->Forward(false);
+  for (size_t i = 0; i < b->out_shapes.size(); ++i) {
+    const size_t size = b->out_sizes[i];
+    b->output_buffer.resize(size * batch_size);
+    p->out_arrays[i].SyncCopyToCPU(b->output_buffer.data(), b->output_buffer.size());
+    for (size_t r = 0; r < batch.size(); ++r) {
+      std::copy(b->output_buffer.begin() + r * size, b->output_buffer.begin() + (r + 1) * size,
+                batch[r]->outputs[i]);
+    }
+  }
+}
+
+// the worker of a batcher, waits for up to max_delay after the oldest request for a full batch
+void _RunBatches(MXAPIPredictorBatcher* b) {
+  const size_t max_batch_size = b->bucket_sizes.back();
+  std::unique_lock<std::mutex> lock(b->mutex);
+  while (true) {
+    b->queue_cv.wait(lock, [b]() { return b->stop || !b->queue.empty(); });
+    if (b->queue.empty()) return;
+    b->queue_cv.wait_until(lock, b->queue.front()->arrival + b->max_delay,
+                           [b, max_batch_size]() {
+                             return b->stop || b->queue.size() >= max_batch_size;
+                           });
+    const size_t n = std::min(max_batch_size, b->queue.size());
+    std::vector<MXAPIBatchRequest*> batch(b->queue.begin(), b->queue.begin() + n);
+    b->queue.erase(b->queue.begin(), b->queue.begin() + n);
+    lock.unlock();
+    std::string error;
+    try {
+      _RunBatch(b, batch);
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+    lock.lock();
+    for (MXAPIBatchRequest* r : batch) {
+      r->error = error;
+      r->done = true;
+    }
+    b->done_cv.notify_all();
+  }
+}
+
+int MXPredBatcherCreate(const char* symbol_json_str,
+                        const void* param_bytes,
+                        int param_size,
+                        int dev_type, int dev_id,
+                        mx_uint num_input_nodes,
+                        const char** input_keys,
+                        const mx_uint* input_shape_indptr,
+                        const mx_uint* input_shape_data,
+                        mx_uint max_batch_size,
+                        mx_uint max_delay_us,
+                        PredictorBatcherHandle* out) {
+  API_BEGIN();
+  CHECK_GT(max_batch_size, 0U) << "max_batch_size must be positive";
+  std::unique_ptr<MXAPIPredictorBatcher> ret(new MXAPIPredictorBatcher());
+  ret->max_delay = std::chrono::microseconds(max_delay_us);
+  auto buffer = std::make_shared<std::vector<char>>(
+      static_cast<const char*>(param_bytes), static_cast<const char*>(param_bytes) + param_size);
+  ret->pool.reset(_CreatePool(symbol_json_str, buffer->data(), buffer->size(), buffer,
+                              dev_type, dev_id, num_input_nodes, input_keys,
+                              input_shape_indptr, input_shape_data));
+  const std::unordered_map<std::string, TShape> request_shapes = _InputShapes(
+      num_input_nodes, input_keys, input_shape_indptr, input_shape_data);
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    const TShape& shape = request_shapes.at(input_keys[i]);
+    CHECK_GT(shape.ndim(), 0U) << "input " << input_keys[i] << " has no batch dimension";
+    ret->input_keys.emplace_back(input_keys[i]);
+    ret->input_sizes.push_back(shape.Size());
+  }
+  ret->out_shapes = ret->pool->out_shapes;
+  for (const TShape& shape : ret->out_shapes) {
+    ret->out_sizes.push_back(shape.Size());
+  }
+
+  // powers of two up to max_batch_size, and max_batch_size
+  for (size_t batch_size = 1; batch_size <= max_batch_size; batch_size *= 2) {
+    ret->bucket_sizes.push_back(batch_size);
+  }
+  if (ret->bucket_sizes.back() != max_batch_size) {
+    ret->bucket_sizes.push_back(max_batch_size);
+  }
+  // largest first, the others share its memory as only one batch runs at a time
+  ret->buckets.resize(ret->bucket_sizes.size());
+  for (size_t j = ret->bucket_sizes.size(); j-- > 0;) {
+    const size_t batch_size = ret->bucket_sizes[j];
+    std::unordered_map<std::string, TShape> shapes = request_shapes;
+    for (auto& kv : shapes) {
+      kv.second[0] *= batch_size;
+    }
+    Executor* shared_exec = ret->buckets.back() ? ret->buckets.back()->exec.get() : nullptr;
+    ret->buckets[j].reset(_PoolPredictor(ret->pool.get(), shapes, shared_exec));
+    const std::vector<TShape>& batch_out_shapes = ret->buckets[j]->out_shapes;
+    for (size_t i = 0; i < ret->out_shapes.size(); ++i) {
+      TShape expected = ret->out_shapes[i];
+      CHECK_GT(expected.ndim(), 0U) << "output " << i << " has no batch dimension";
+      expected[0] *= batch_size;
+      CHECK_EQ(batch_out_shapes[i], expected)
+          << "the first dimension of output " << i << " is not the batch dimension";
+    }
+  }
+  ret->worker = std::thread(_RunBatches, ret.get());
+  *out = ret.release();
+  API_END();
+}
+
+int MXPredBatcherGetOutputShape(PredictorBatcherHandle handle,
+                                mx_uint out_index,
+                                mx_uint** shape_data,
+                                mx_uint* shape_ndim) {
+  MXAPIPredictorBatcher* b = static_cast<MXAPIPredictorBatcher*>(handle);
+  API_BEGIN();
+  CHECK_LT(out_index, b->out_shapes.size())
+      << "Index exceed number of outputs";
+  const TShape& s = b->out_shapes[out_index];
+  b->out_shapes_buffer.resize(s.ndim());
+  nnvm::ShapeTypeCast(s.begin(), s.end(), b->out_shapes_buffer.data());
+  *shape_data = b->out_shapes_buffer.data();
+  *shape_ndim = s.ndim();
+  API_END();
+}
+
+int MXPredBatcherPredict(PredictorBatcherHandle handle,
+                         const mx_float** input_data,
+                         mx_float** output_data) {
+  MXAPIPredictorBatcher* b = static_cast<MXAPIPredictorBatcher*>(handle);
+  API_BEGIN();
+  MXAPIBatchRequest request;
+  request.inputs = input_data;
+  request.outputs = output_data;
+  request.arrival = std::chrono::steady_clock::now();
+  {
+    std::unique_lock<std::mutex> lock(b->mutex);
+    b->queue.push_back(&request);
+    b->queue_cv.notify_one();
+    b->done_cv.wait(lock, [&request]() { return request.done; });
+  }
+  if (!request.error.empty()) {
+    throw dmlc::Error(request.error);
+  }
+  API_END();
+}
+
+int MXPredBatcherFree(PredictorBatcherHandle handle) {
+  API_BEGIN();
+  MXAPIPredictorBatcher* b = static_cast<MXAPIPredictorBatcher*>(handle);
+  {
+    std::lock_guard<std::mutex> lock(b->mutex);
+    b->stop = true;
+  }
+  b->queue_cv.notify_one();
+  b->worker.join();
+  delete b;
+  API_END();
+}
+
 int MXPredReshape(mx_uint num_input_nodes,
                   const char** input_keys,
                   const mx_uint* input_shape_indptr,
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  Copyright (c) 2019 by Contributors
+ * \file c_predict_api_common.h
+ * \brief the predictor and predictor pool behind the handles of the C predict API
+ */
+#ifndef MXNET_C_API_C_PREDICT_API_COMMON_H_
+#define MXNET_C_API_C_PREDICT_API_COMMON_H_
+
+#include <mxnet/executor.h>
+#include <mxnet/ndarray.h>
+#include <nnvm/symbolic.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// predictor interface
+struct MXAPIPredictor {
+  // output arrays
+  std::vector<mxnet::NDArray> out_arrays;
+  // argument arrays
+  std::vector<mxnet::NDArray> arg_arrays;
+  // auxiliary arrays
+  std::vector<mxnet::NDArray> aux_arrays;
+  // output shapes
+  std::vector<mxnet::TShape> out_shapes;
+  // uint32_t buffer for output shapes
+  std::vector<uint32_t> out_shapes_buffer;
+  // key to arguments
+  std::unordered_map<std::string, size_t> key2arg;
+  // executor
+  std::unique_ptr<mxnet::Executor> exec;
+  // symbol
+  nnvm::Symbol sym;
+  // Context
+  mxnet::Context ctx;
+};
+
+// weights shared by the predictors created from a pool
+struct MXAPIPredictorPool {
+  // symbol
+  nnvm::Symbol sym;
+  // Context
+  mxnet::Context ctx;
+  // argument arrays, input arrays are only used for their shapes
+  std::vector<mxnet::NDArray> arg_arrays;
+  // auxiliary arrays
+  std::vector<mxnet::NDArray> aux_arrays;
+  // whether an argument is an input, which every predictor allocates for itself
+  std::vector<bool> is_input;
+  // output shapes
+  std::vector<mxnet::TShape> out_shapes;
+  // key to arguments
+  std::unordered_map<std::string, size_t> key2arg;
+  // serializes binding
+  std::mutex mutex;
+};
+
+#endif  // MXNET_C_API_C_PREDICT_API_COMMON_H_
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file mapped_file.h
+ * \brief Read only view of a whole file, memory mapped where possible.
+ */
+#ifndef MXNET_COMMON_MAPPED_FILE_H_
+#define MXNET_COMMON_MAPPED_FILE_H_
+
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <memory>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // !defined(_WIN32)
+
+namespace mxnet {
+namespace common {
+
+/*!
+ * \brief The contents of a file. Local files are mapped copy-on-write, so pages are shared
+ *  with the page cache and with other processes mapping the same file, and writing to the
+ *  contents never changes the file. Other URIs (and all files on Windows) are read into
+ *  memory.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+#if !defined(_WIN32)
+    if (path.find("://") == std::string::npos) {
+      const int fd = open(path.c_str(), O_RDONLY);
+      CHECK_GE(fd, 0) << "Cannot open " << path;
+      struct stat st;
+      CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << path;
+      size_ = static_cast<size_t>(st.st_size);
+      if (size_ > 0) {
+        void *addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        CHECK(addr != MAP_FAILED) << "Cannot map " << path;
+        data_ = static_cast<char*>(addr);
+        mapped_ = true;
+      }
+      close(fd);
+      return;
+    }
+#endif  // !defined(_WIN32)
+    std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(path.c_str(), "r"));
+    const size_t kChunk = 1 << 20;
+    size_t nread;
+    do {
+      buffer_.resize(size_ + kChunk);
+      nread = fi->Read(buffer_.data() + size_, kChunk);
+      size_ += nread;
+    } while (nread == kChunk);
+    buffer_.resize(size_);
+    data_ = buffer_.data();
+  }
+
+  ~MappedFile() {
+#if !defined(_WIN32)
+    if (mapped_) munmap(data_, size_);
+#endif  // !defined(_WIN32)
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char *data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  char *data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<char> buffer_;
+};
+
+}  // namespace common
+}  // namespace mxnet
+
+#endif  // MXNET_COMMON_MAPPED_FILE_H_
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file numa.h
+ * \brief NUMA topology, thread pinning and memory placement helpers.
+ *  Uses sysfs and raw syscalls on Linux, so no libnuma is needed. Everything degrades to
+ *  a single node without pinning on other platforms.
+ */
+#ifndef MXNET_COMMON_NUMA_H_
+#define MXNET_COMMON_NUMA_H_
+
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+namespace mxnet {
+namespace common {
+namespace numa {
+
+/*!
+ * \brief Whether CPU workers and CPU storage should be placed by NUMA node.
+ *  Controlled by MXNET_CPU_NUMA_AWARE. When set, Context::CPU(i) maps to node i % NumNodes().
+ */
+inline bool Enabled() {
+  static const bool enabled = dmlc::GetEnv("MXNET_CPU_NUMA_AWARE", false);
+  return enabled;
+}
+
+/*!
+ * \brief Parse a sysfs cpu list such as "0-3,8-11".
+ */
+inline std::vector<int> ParseCPUList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") continue;
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/*!
+ * \brief Logical CPUs of each NUMA node. Empty if the topology is unknown.
+ */
+inline const std::vector<std::vector<int>>& NodeCPUs() {
+  static const std::vector<std::vector<int>> node_cpus = []() {
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    for (int node = 0; ; ++node) {
+      std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      if (!file.is_open()) break;
+      std::string list;
+      std::getline(file, list);
+      nodes.emplace_back(ParseCPUList(list));
+    }
+#endif  // defined(__linux__)
+    return nodes;
+  }();
+  return node_cpus;
+}
+
+/*!
+ * \brief Number of NUMA nodes, at least 1.
+ */
+inline int NumNodes() {
+  return NodeCPUs().empty() ? 1 : static_cast<int>(NodeCPUs().size());
+}
+
+/*!
+ * \brief NUMA node a CPU device id is placed on when there are num_nodes nodes.
+ *  Device ids past the last node wrap around.
+ */
+inline int NodeOfDevice(int dev_id, int num_nodes) {
+  return num_nodes > 1 ? dev_id % num_nodes : 0;
+}
+
+/*!
+ * \brief NUMA node a CPU device id is placed on. Warns once if device ids wrap around,
+ *  since two devices then share the cores and memory of one node.
+ */
+inline int NodeOfDevice(int dev_id) {
+  const int num_nodes = NumNodes();
+  if (dev_id >= num_nodes) {
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+      LOG(WARNING) << "MXNET_CPU_NUMA_AWARE: cpu(" << dev_id << ") is placed on node "
+                   << NodeOfDevice(dev_id, num_nodes) << ", but there are only "
+                   << num_nodes << " NUMA node(s). Devices past the last node share nodes.";
+    }
+  }
+  return NodeOfDevice(dev_id, num_nodes);
+}
+
+/*!
+ * \brief Restrict the calling thread to the CPUs of a node. Threads (e.g. OpenMP teams)
+ *  created afterwards by this thread inherit the mask.
+ * \return whether the thread was pinned
+ */
+inline bool BindCurrentThreadToNode(int node) {
+#if defined(__linux__)
+  const auto &nodes = NodeCPUs();
+  if (node < 0 || node >= static_cast<int>(nodes.size()) || nodes[node].empty()) {
+    return false;
+  }
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : nodes[node]) {
+    CPU_SET(cpu, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "Failed to bind thread to NUMA node " << node;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // defined(__linux__)
+}
+
+/*!
+ * \brief Ask the kernel to place the pages of a memory range on a node when they are first
+ *  touched. Only the whole pages inside the range are affected. Pages that are already
+ *  populated are not migrated, so this is only worth calling on freshly mapped memory.
+ *  Each call is a syscall; callers recycling memory should call it once per fresh chunk.
+ */
+inline void PreferNode(void *ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // MPOL_PREFERRED from <numaif.h>
+  constexpr int kMPolPreferred = 1;
+  if (node < 0 || NumNodes() <= 1) return;
+  const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) & ~(page - 1);
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~(page - 1);
+  if (end <= begin) return;
+  const size_t bits = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+  std::vector<unsigned long> node_mask(node / bits + 1, 0);  // NOLINT(runtime/int)
+  node_mask[node / bits] = 1UL << (node % bits);
+  // Placement is only a hint, ignore failures (e.g. seccomp forbidding mbind)
+  syscall(SYS_mbind, begin, end - begin, kMPolPreferred, node_mask.data(),
+          node_mask.size() * bits + 1, 0);
+#endif  // defined(__linux__) && defined(SYS_mbind)
+}
+
+}  // namespace numa
+}  // namespace common
+}  // namespace mxnet
+
+#endif  // MXNET_COMMON_NUMA_H_
@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file op_cost.h
+ * \brief Measured operator run times, used to size bulks by cost instead of op count.
+ */
+#ifndef MXNET_ENGINE_OP_COST_H_
+#define MXNET_ENGINE_OP_COST_H_
+
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "mxnet/base.h"
+
+namespace mxnet {
+namespace engine {
+
+/*!
+ * \brief Time budget of one bulk in microseconds, from MXNET_EXEC_BULK_EXEC_MAX_COST_US.
+ *  0 (default) sizes bulks by op count only.
+ */
+inline double BulkCostBudget() {
+  static const double budget = dmlc::GetEnv("MXNET_EXEC_BULK_EXEC_MAX_COST_US", 0.0);
+  return budget;
+}
+
+/*!
+ * \brief Running estimate of the run time of an operator.
+ *
+ * The first run is discarded since it usually pays for lazy allocation and cold caches.
+ * Afterwards every run is timed until the estimate settles, then one in kSampleInterval
+ * runs per thread, so the timer stays off the hot path of tiny ops. Updates are racy
+ * read-modify-writes of an exponential moving average; losing one to a concurrent update
+ * is harmless.
+ */
+class OpCost {
+ public:
+  /*! \return estimated run time in microseconds, negative while still unknown */
+  inline double Estimate() const {
+    return num_samples_.load(std::memory_order_relaxed) < kWarmupSamples ?
+           -1.0 : estimate_us_.load(std::memory_order_relaxed);
+  }
+  /*!
+   * \brief Run fn, timing it if this run is sampled.
+   * \param fn The operator body.
+   */
+  template<typename Fn>
+  inline void Run(const Fn &fn) {
+    static MX_THREAD_LOCAL uint32_t tick = 0;
+    if (num_samples_.load(std::memory_order_relaxed) >= kSettleSamples &&
+        ++tick % kSampleInterval != 0) {
+      fn();
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    Record(elapsed.count());
+  }
+
+ private:
+  inline void Record(double us) {
+    const uint32_t n = num_samples_.load(std::memory_order_relaxed);
+    if (n + 1 == kWarmupSamples) {
+      estimate_us_.store(us, std::memory_order_relaxed);
+    } else if (n + 1 > kWarmupSamples) {
+      const double old_us = estimate_us_.load(std::memory_order_relaxed);
+      estimate_us_.store(old_us + (us - old_us) / 8, std::memory_order_relaxed);
+    }
+    if (n < kSettleSamples) num_samples_.store(n + 1, std::memory_order_relaxed);
+  }
+
+  /*! \brief number of samples before the estimate is used, the first one is dropped */
+  static constexpr uint32_t kWarmupSamples = 2;
+  /*! \brief number of samples after which runs are timed only occasionally */
+  static constexpr uint32_t kSettleSamples = 16;
+  static constexpr uint32_t kSampleInterval = 64;
+
+  std::atomic<uint32_t> num_samples_{0};
+  std::atomic<double> estimate_us_{0.0};
+};
+
+/*!
+ * \brief Decides where a sequence of ops is cut into bulks of at most a time budget.
+ *  Ops slower than the budget run on their own so they can overlap with other work.
+ *  Unmeasured ops take the share of the budget they would get by op count.
+ */
+class BulkCostSplitter {
+ public:
+  /*!
+   * \param budget time budget of one bulk in microseconds
+   * \param max_nodes op count of a bulk when bulks are sized by count
+   */
+  BulkCostSplitter(double budget, size_t max_nodes)
+    : budget_(budget), unmeasured_cost_(budget / std::max<size_t>(max_nodes, 1)) {}
+  /*!
+   * \brief Whether the next op is cut from the current bulk. If it is, the bulk ends
+   *  before the op, which either starts the next bulk or, if *standalone, runs on its own.
+   * \param estimate estimated run time of the op (OpCost::Estimate), negative if unknown
+   */
+  inline bool Split(double estimate, bool *standalone) {
+    if (estimate < 0) {
+      saw_unmeasured_ = true;
+      estimate = unmeasured_cost_;
+    }
+    if (estimate >= budget_) {
+      *standalone = true;
+      seg_cost_ = 0;
+      return true;
+    }
+    *standalone = false;
+    if (seg_cost_ + estimate > budget_) {
+      seg_cost_ = estimate;
+      return true;
+    }
+    seg_cost_ += estimate;
+    return false;
+  }
+  /*! \brief the current bulk was ended by something else than its cost */
+  inline void Reset() {
+    seg_cost_ = 0;
+  }
+  /*! \brief whether an op without a measured cost was seen */
+  inline bool saw_unmeasured() const {
+    return saw_unmeasured_;
+  }
+
+ private:
+  const double budget_;
+  const double unmeasured_cost_;
+  double seg_cost_ = 0;
+  bool saw_unmeasured_ = false;
+};
+
+/*!
+ * \brief Process-wide OpCost per operator name, for ops pushed without a cached operator.
+ */
+class OpCostTable {
+ public:
+  static OpCostTable* Get() {
+    // Leaked like the engine singletons, entries may be used during static destruction
+    static OpCostTable *inst = new OpCostTable();
+    return inst;
+  }
+  /*!
+   * \brief Find or create the entry of an operator.
+   * \param name Operator name. The returned entry never moves, callers may keep it.
+   */
+  inline OpCost* Find(const char *name) {
+    // Operator names are mostly string literals or nnvm::Op::name, so the address is
+    // a good cache key. It is only a hint, the name is compared on every hit.
+    static MX_THREAD_LOCAL CacheEntry cache[kCacheSize];
+    CacheEntry &slot = cache[(reinterpret_cast<uintptr_t>(name) >> 3) % kCacheSize];
+    if (slot.key == name && slot.entry->name == name) return &slot.entry->cost;
+    Entry *entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_ptr<Entry> &e = entries_[name];
+      if (!e) {
+        e.reset(new Entry());
+        e->name = name;
+      }
+      entry = e.get();
+    }
+    slot.key = name;
+    slot.entry = entry;
+    return &entry->cost;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    OpCost cost;
+  };
+  struct CacheEntry {
+    const char *key;
+    Entry *entry;
+  };
+  static constexpr size_t kCacheSize = 256;
+
+  OpCostTable() = default;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+};
+
+}  // namespace engine
+}  // namespace mxnet
+
+#endif  // MXNET_ENGINE_OP_COST_H_
@@ -19,6 +19,7 @@
 #include <dmlc/omp.h>
 #include <dmlc/base.h>
 #include <dmlc/parameter.h>
+#include <algorithm>
 #include <climits>
 #include "./openmp.h"
 
@@ -69,6 +70,20 @@ void OpenMP::on_start_worker_thread(bool use_omp) {
 #endif
 }
 
+void OpenMP::on_start_bound_worker_thread(int num_cpus) {
+#ifdef _OPENMP
+  if (!omp_num_threads_set_in_environment_) {
+    int thread_count = num_cpus;
+#ifdef ARCH_IS_INTEL_X86
+    // Same hyper-threading assumption as for omp_thread_max_
+    thread_count >>= 1;
+#endif
+    thread_count = std::min(thread_count, GetRecommendedOMPThreadCount(true));
+    omp_set_num_threads(std::max(thread_count, 1));
+  }
+#endif
+}
+
 void OpenMP::set_reserve_cores(int cores) {
   CHECK_GE(cores, 0);
   reserve_cores_ = cores;
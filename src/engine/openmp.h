@@ -74,6 +74,14 @@ class OpenMP {
    */
   void on_start_worker_thread(bool use_omp);
 
+  /*!
+   * \brief Like on_start_worker_thread(true), for a worker thread that is pinned to a subset
+   *        of the machine (e.g. one NUMA node). OMP regions created by this thread are
+   *        limited to that subset.
+   * \param num_cpus Number of logical cores the thread is pinned to
+   */
+  void on_start_bound_worker_thread(int num_cpus);
+
   /*!
    * \brief Get the OpenMP object's singleton pointer
    * \return Singleton OpenMP object pointer
@@ -49,7 +49,7 @@ ThreadedVar::ThreadedVar(VersionedVarBlock* head) : head_{head} {
 }
 
 inline void ThreadedVar::AppendReadDependency(OprBlock* opr_block) {
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SpinLock> lock{lock_};
   if (pending_write_ == nullptr) {
     // invariant: is_ready_to_read()
     CHECK_GE(num_pending_reads_, 0);
@@ -71,7 +71,7 @@ inline void ThreadedVar::AppendReadDependency(OprBlock* opr_block) {
 
 inline void ThreadedVar::AppendWriteDependency(OprBlock* opr_block) {
   auto&& new_var_block = VersionedVarBlock::New();
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SpinLock> lock{lock_};
   // invariant.
   assert(head_->next == nullptr);
   assert(head_->trigger == nullptr);
@@ -102,7 +102,7 @@ inline void ThreadedVar::CompleteReadDependency(Dispatcher dispatcher) {
   OprBlock *trigger = nullptr;
   {
     // this is lock scope
-    std::lock_guard<std::mutex> lock{mutex_};
+    std::lock_guard<SpinLock> lock{lock_};
     CHECK_GT(num_pending_reads_, 0);
 
     if (--num_pending_reads_ == 0) {
@@ -124,7 +124,7 @@ inline bool ThreadedVar::CompleteWriteDependency(Dispatcher dispatcher) {
   VersionedVarBlock *old_pending_write, *end_of_read_chain;
   OprBlock* trigger_write = nullptr;
   {
-    std::lock_guard<std::mutex> lock{mutex_};
+    std::lock_guard<SpinLock> lock{lock_};
     // invariants
     assert(head_->next == nullptr);
     assert(pending_write_ != nullptr);
@@ -190,17 +190,17 @@ inline bool ThreadedVar::CompleteWriteDependency(Dispatcher dispatcher) {
 }
 
 inline void ThreadedVar::SetToDelete() {
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SpinLock> lock{lock_};
   to_delete_ = true;
 }
 
 inline bool ThreadedVar::ready_to_read() {
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SpinLock> lock{lock_};
   return this->is_ready_to_read();
 }
 
 inline size_t ThreadedVar::version() {
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SpinLock> lock{lock_};
   return this->version_;
 }
 
@@ -355,7 +355,32 @@ void ThreadedEngine::PushSync(SyncFn exec_fn, Context exec_ctx,
 
   const BulkStatus& bulk_status = *BulkStatusStore::Get();
   if (bulk_status.count && exec_ctx != bulk_status.ctx) BulkFlush();
-  BulkAppend(exec_fn, exec_ctx, const_vars, mutable_vars);
+
+  // Size the bulk by measured run time. Only CPU ops are timed, GPU ops return as soon
+  // as their kernels are launched.
+  const double budget = BulkCostBudget();
+  if (budget > 0 && opr_name && exec_ctx.dev_mask() == cpu::kDevMask) {
+    OpCost *cost = OpCostTable::Get()->Find(opr_name);
+    SyncFn timed_fn = [cost, exec_fn](RunContext ctx) {
+        cost->Run([&]() { exec_fn(ctx); });
+      };
+    const double estimate = cost->Estimate();
+    if (estimate >= budget) {
+      // Expensive enough to be worth its own scheduling, run it standalone
+      BulkFlush();
+      this->PushAsync([timed_fn](RunContext ctx, CallbackOnComplete on_complete) {
+          timed_fn(ctx);
+          on_complete();
+        }, exec_ctx, const_vars, mutable_vars, prop, priority, opr_name);
+      return;
+    }
+    // Until an op has been measured it takes the share of the budget it would get
+    // with count based bulking
+    BulkAppend(timed_fn, exec_ctx, const_vars, mutable_vars,
+               estimate < 0 ? budget / bulk_status.bulk_size : estimate);
+    return;
+  }
+  BulkAppend(exec_fn, exec_ctx, const_vars, mutable_vars, 0);
 }
 
 void ThreadedEngine::DeleteVariable(SyncFn delete_fn,
@@ -40,6 +40,7 @@
 #include <thread>
 #include "./engine_impl.h"
 #include "../profiler/profiler.h"
+#include "./op_cost.h"
 #include "./openmp.h"
 #include "../common/object_pool.h"
 
@@ -59,6 +60,43 @@ namespace engine {
 // Forward declarations
 struct ThreadedOpr;
 
+/*!
+ * \brief Test-and-test-and-set spin lock for very short critical sections.
+ *  After a bounded number of spins the waiting thread yields, so a contended lock does
+ *  not keep burning a core while the holder is descheduled.
+ *  Satisfies BasicLockable, so it can be used with std::lock_guard.
+ */
+class SpinLock {
+ public:
+  SpinLock() = default;
+  inline void lock() {
+    for (int spins = 0; locked_.exchange(true, std::memory_order_acquire); ) {
+      // wait on a plain load to keep the cache line shared while the lock is held
+      while (locked_.load(std::memory_order_relaxed)) {
+        if (++spins < kSpinsBeforeYield) {
+#if defined(__x86_64__) || defined(__i386__)
+          __builtin_ia32_pause();
+#endif
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+  inline bool try_lock() {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+  inline void unlock() {
+    locked_.store(false, std::memory_order_release);
+  }
+
+ private:
+  static constexpr int kSpinsBeforeYield = 64;
+  std::atomic<bool> locked_{false};
+  DISALLOW_COPY_AND_ASSIGN(SpinLock);
+};
+
 /*!
  * \brief Operation block in the scheduler.
  *  Each OprBlock corresponds to an operation pushed to the engine.
@@ -180,10 +218,13 @@ class ThreadedVar final
   std::shared_ptr<std::exception_ptr> var_exception;
 
  private:
-  // TODO(hotpxl) change this to spinlock for faster runtime
   // TODO(hotpxl) consider rename head
-  /*! \brief internal mutex of the ThreadedVar */
-  std::mutex mutex_;
+  /*!
+   * \brief internal lock of the ThreadedVar.
+   *  Critical sections only touch a few pointers and counters, so spinning is cheaper
+   *  than a futex round trip.
+   */
+  SpinLock lock_;
   /*!
    * \brief number of pending reads operation in the variable.
    *  will be marked as -1 when there is a already triggered pending write.
@@ -413,6 +454,8 @@ class ThreadedEngine : public Engine {
     int bulk_size = 0;
     /*! \brief current number of ops in bulk */
     int count = 0;
+    /*! \brief estimated run time of the ops in bulk in microseconds */
+    double cost = 0;
     /*! \brief context of current ops */
     Context ctx;
     /*! \brief current op functions */
@@ -422,6 +465,8 @@ class ThreadedEngine : public Engine {
     /*! \brief mutable variables */
     std::vector<VarHandle> mutable_vars;
   };
+  /*! \brief bulks sized by cost hold at most this many times bulk_size ops */
+  static constexpr int kMaxCostBulkFactor = 8;
   /*! thread local store for bulk */
   typedef dmlc::ThreadLocalStore<BulkStatus> BulkStatusStore;
   /*!
@@ -467,10 +512,16 @@ class ThreadedEngine : public Engine {
 
   static void OnCompleteStatic(Engine *engine, void *threaded_opr,
                                const dmlc::Error* error);
-  /*! \brief append an operator to bulk */
+  /*!
+   * \brief append an operator to bulk
+   * \param cost estimated run time of the operator in microseconds. When bulks are sized by
+   *  cost (MXNET_EXEC_BULK_EXEC_MAX_COST_US), the bulk is flushed once the total reaches the
+   *  budget rather than after bulk_size ops.
+   */
   inline void BulkAppend(SyncFn exec_fn, Context exec_ctx,
                          std::vector<VarHandle> const& const_vars,
-                         std::vector<VarHandle> const& mutable_vars) {
+                         std::vector<VarHandle> const& mutable_vars,
+                         double cost) {
     BulkStatus& bulk_status = *BulkStatusStore::Get();
     if (!bulk_status.count) {
       bulk_status.ctx = exec_ctx;
@@ -484,18 +535,30 @@ class ThreadedEngine : public Engine {
     }
 
     ++bulk_status.count;
+    bulk_status.cost += cost;
     bulk_status.const_vars.insert(
         bulk_status.const_vars.end(), const_vars.begin(), const_vars.end());
     bulk_status.mutable_vars.insert(
         bulk_status.mutable_vars.end(), mutable_vars.begin(), mutable_vars.end());
 
-    if (bulk_status.count >= bulk_status.bulk_size) BulkFlush();
+    const double budget = BulkCostBudget();
+    if (budget > 0 && cost > 0) {
+      // Cheap ops may grow the bulk past bulk_size, but the ops are chained through nested
+      // closures, so keep the depth bounded.
+      if (bulk_status.cost >= budget ||
+          bulk_status.count >= kMaxCostBulkFactor * bulk_status.bulk_size) {
+        BulkFlush();
+      }
+    } else if (bulk_status.count >= bulk_status.bulk_size) {
+      BulkFlush();
+    }
   }
   /*! \brief flush current bulk to execution */
   inline void BulkFlush() {
     BulkStatus& bulk_status = *BulkStatusStore::Get();
     if (!bulk_status.count) return;
     bulk_status.count = 0;
+    bulk_status.cost = 0;
     DeduplicateVarHandle(&bulk_status.const_vars, &bulk_status.mutable_vars);
     SyncFn fn = std::move(bulk_status.fn);
     this->PushAsync([fn](RunContext ctx, CallbackOnComplete on_complete) {
@@ -30,7 +30,9 @@
 #include <dmlc/thread_group.h>
 #include "./threaded_engine.h"
 #include "./thread_pool.h"
+#include "./work_stealing_queue.h"
 #include "../common/lazy_alloc_array.h"
+#include "../common/numa.h"
 #include "../common/utils.h"
 
 namespace mxnet {
@@ -42,6 +44,10 @@ namespace engine {
  *  - Use fixed amount of threads for each device.
  *  - Use special threads for copy operations.
  *  - Each stream is allocated and bound to each of the thread.
+ *  - Optionally, CPU workers of a device keep one deque each and steal work from each
+ *    other instead of sharing a single blocking queue.
+ *  - Optionally (MXNET_CPU_NUMA_AWARE), the workers of CPU device i and their OpenMP teams
+ *    are pinned to NUMA node i % num_nodes.
  */
 class ThreadedEnginePerDevice : public ThreadedEngine {
  public:
@@ -51,7 +57,13 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   static auto constexpr kPriorityQueue = kPriority;
   static auto constexpr kWorkerQueue = kFIFO;
 
-  ThreadedEnginePerDevice() noexcept(false) {
+  /*!
+   * \brief Constructor.
+   * \param cpu_work_stealing whether normal CPU tasks go through per-worker deques with
+   *  work stealing instead of one shared queue per device
+   */
+  explicit ThreadedEnginePerDevice(bool cpu_work_stealing = false) noexcept(false)
+    : cpu_work_stealing_(cpu_work_stealing) {
     this->Start();
   }
   ~ThreadedEnginePerDevice() noexcept(false) {
@@ -64,6 +76,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     gpu_priority_workers_.Clear();
     gpu_copy_workers_.Clear();
     cpu_normal_workers_.Clear();
+    cpu_stealing_workers_.Clear();
     cpu_priority_worker_.reset(nullptr);
   }
 
@@ -105,6 +118,25 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
         // CPU execution.
         if (opr_block->opr->prop == FnProperty::kCPUPrioritized) {
           cpu_priority_worker_->task_queue.Push(opr_block, opr_block->priority);
+        } else if (cpu_work_stealing_) {
+          int dev_id = ctx.dev_id;
+          int nthread = cpu_worker_nthreads_;
+          auto ptr =
+          cpu_stealing_workers_.Get(dev_id, [this, ctx, nthread]() {
+              auto blk = new WorkStealingWorkerBlock(nthread);
+              blk->pool.reset(new ThreadPool(nthread,
+                  [this, ctx, blk](std::shared_ptr<dmlc::ManualEvent> ready_event) {
+                    this->CPUStealingWorker(ctx, blk, ready_event);
+                  }, true));
+            return blk;
+          });
+          if (ptr) {
+            if (opr_block->opr->prop == FnProperty::kDeleteVar) {
+              ptr->task_queue.PushFront(opr_block, opr_block->priority);
+            } else {
+              ptr->task_queue.Push(opr_block, opr_block->priority);
+            }
+          }
         } else {
           int dev_id = ctx.dev_id;
           int nthread = cpu_worker_nthreads_;
@@ -113,7 +145,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
               auto blk = new ThreadWorkerBlock<kWorkerQueue>();
               blk->pool.reset(new ThreadPool(nthread,
                   [this, ctx, blk](std::shared_ptr<dmlc::ManualEvent> ready_event) {
-                    this->CPUWorker(ctx, blk, ready_event);
+                    this->CPUWorker(ctx, blk, ready_event, common::numa::Enabled());
                   }, true));
             return blk;
           });
@@ -211,9 +243,24 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     // destructor
     ~ThreadWorkerBlock() noexcept(false) {}
   };
+  // working unit of CPU workers that steal work from each other
+  struct WorkStealingWorkerBlock {
+    // per worker task deques
+    WorkStealingQueue<OprBlock*> task_queue;
+    // thread pool that works on this task
+    std::unique_ptr<ThreadPool> pool;
+    // next worker index to hand out
+    std::atomic<size_t> next_worker_id{0};
+    // constructor
+    explicit WorkStealingWorkerBlock(size_t nthread) : task_queue(nthread) {}
+    // destructor
+    ~WorkStealingWorkerBlock() noexcept(false) {}
+  };
 
   /*! \brief whether this is a worker thread. */
   static MX_THREAD_LOCAL bool is_worker_;
+  /*! \brief whether normal CPU workers use work stealing */
+  const bool cpu_work_stealing_;
   /*! \brief number of concurrent thread cpu worker uses */
   size_t cpu_worker_nthreads_;
   /*! \brief number of concurrent thread each gpu worker uses */
@@ -222,6 +269,8 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   size_t gpu_copy_nthreads_;
   // cpu worker
   common::LazyAllocArray<ThreadWorkerBlock<kWorkerQueue> > cpu_normal_workers_;
+  // cpu workers with work stealing
+  common::LazyAllocArray<WorkStealingWorkerBlock> cpu_stealing_workers_;
   // cpu priority worker
   std::unique_ptr<ThreadWorkerBlock<kPriorityQueue> > cpu_priority_worker_;
   // workers doing normal works on GPU
@@ -280,7 +329,8 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   template<dmlc::ConcurrentQueueType type>
   inline void CPUWorker(Context ctx,
                         ThreadWorkerBlock<type> *block,
-                        const std::shared_ptr<dmlc::ManualEvent>& ready_event) {
+                        const std::shared_ptr<dmlc::ManualEvent>& ready_event,
+                        bool numa_bind = false) {
     this->is_worker_ = true;
     auto* task_queue = &(block->task_queue);
     RunContext run_ctx{ctx, nullptr};
@@ -290,12 +340,53 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     ready_event->signal();
 
     // Set default number of threads for OMP parallel regions initiated by this thread
-    OpenMP::Get()->on_start_worker_thread(true);
+    StartCPUWorkerThread(ctx, numa_bind);
 
     while (task_queue->Pop(&opr_block)) {
       this->ExecuteOprBlock(run_ctx, opr_block);
     }
   }
+  /*!
+   * \brief CPU worker that owns one deque of a work stealing block.
+   * \param block The task block of the worker.
+   */
+  inline void CPUStealingWorker(Context ctx,
+                                WorkStealingWorkerBlock *block,
+                                const std::shared_ptr<dmlc::ManualEvent>& ready_event) {
+    this->is_worker_ = true;
+    auto* task_queue = &(block->task_queue);
+    const size_t worker_id = block->next_worker_id++;
+    // Ops this worker makes ready are pushed to its own deque
+    task_queue->RegisterWorker(worker_id);
+    RunContext run_ctx{ctx, nullptr};
+
+    // execute task
+    OprBlock* opr_block;
+    ready_event->signal();
+
+    // Set default number of threads for OMP parallel regions initiated by this thread
+    StartCPUWorkerThread(ctx, common::numa::Enabled());
+
+    while (task_queue->Pop(worker_id, &opr_block)) {
+      this->ExecuteOprBlock(run_ctx, opr_block);
+    }
+  }
+
+  /*!
+   * \brief Pin a CPU worker to the NUMA node of its device if requested, and set the
+   *  number of threads of the OMP regions it starts.
+   */
+  static void StartCPUWorkerThread(const Context& ctx, bool numa_bind) {
+    if (numa_bind) {
+      const int node = common::numa::NodeOfDevice(ctx.dev_id);
+      if (common::numa::BindCurrentThreadToNode(node)) {
+        OpenMP::Get()->on_start_bound_worker_thread(
+          static_cast<int>(common::numa::NodeCPUs()[node].size()));
+        return;
+      }
+    }
+    OpenMP::Get()->on_start_worker_thread(true);
+  }
 
   /*!
    * \brief Get number of cores this engine should reserve for its own use
@@ -332,6 +423,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     SignalQueueForKill(&gpu_normal_workers_);
     SignalQueueForKill(&gpu_copy_workers_);
     SignalQueueForKill(&cpu_normal_workers_);
+    SignalQueueForKill(&cpu_stealing_workers_);
     if (cpu_priority_worker_) {
       cpu_priority_worker_->task_queue.SignalForKill();
     }
@@ -342,6 +434,10 @@ Engine *CreateThreadedEnginePerDevice() {
   return new ThreadedEnginePerDevice();
 }
 
+Engine *CreateThreadedEnginePerDeviceWorkStealing() {
+  return new ThreadedEnginePerDevice(true);
+}
+
 MX_THREAD_LOCAL bool ThreadedEnginePerDevice::is_worker_ = false;
 
 }  // namespace engine
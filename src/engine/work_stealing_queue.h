@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file work_stealing_queue.h
+ * \brief Task queue with one deque per worker thread and work stealing.
+ */
+#ifndef MXNET_ENGINE_WORK_STEALING_QUEUE_H_
+#define MXNET_ENGINE_WORK_STEALING_QUEUE_H_
+
+#include <dmlc/base.h>
+#include <dmlc/logging.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "mxnet/base.h"
+
+namespace mxnet {
+namespace engine {
+
+/*!
+ * \brief Blocking task queue shared by a fixed set of worker threads.
+ *
+ * Every worker owns a deque. Tasks pushed by one of the workers go to its own deque,
+ * tasks pushed by other threads are spread round robin. A worker takes tasks from the
+ * front of its own deque, in FIFO order like dmlc::ConcurrentBlockingQueue<kFIFO>, and
+ * when that is empty steals from the back of the others. Each deque has its own lock, so
+ * pushes and pops only contend when they hit the same worker. Idle workers sleep on a
+ * condition variable that is only signalled when some worker is actually asleep.
+ *
+ * \tparam T Task type.
+ */
+template<typename T>
+class WorkStealingQueue {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param num_workers Number of worker threads that will call Pop().
+   */
+  explicit WorkStealingQueue(size_t num_workers)
+    : num_workers_(num_workers), queues_(new WorkerDeque[num_workers]) {
+    CHECK_GT(num_workers, 0U);
+  }
+  /*!
+   * \brief Register the calling thread as worker worker_id of this queue.
+   * \param worker_id Worker index in [0, num_workers).
+   */
+  void RegisterWorker(size_t worker_id) {
+    CHECK_LT(worker_id, num_workers_);
+    current_queue_ = this;
+    current_worker_ = worker_id;
+  }
+  /*!
+   * \brief Push a task to the back of a deque.
+   * \param item The task.
+   * \param priority Unused, kept for interface compatibility with
+   *  dmlc::ConcurrentBlockingQueue<kFIFO>.
+   */
+  void Push(T item, int priority = 0) {
+    WorkerDeque &q = queues_[TargetWorker()];
+    {
+      std::lock_guard<std::mutex> lock(q.mutex);
+      q.tasks.push_back(item);
+    }
+    OnPushed();
+  }
+  /*!
+   * \brief Push a task to the front of a deque, so it is the next task of that worker.
+   * \param item The task.
+   * \param priority Unused.
+   */
+  void PushFront(T item, int priority = 0) {
+    WorkerDeque &q = queues_[TargetWorker()];
+    {
+      std::lock_guard<std::mutex> lock(q.mutex);
+      q.tasks.push_front(item);
+    }
+    OnPushed();
+  }
+  /*!
+   * \brief Pop a task for a worker, blocking until one is available.
+   * \param worker_id The worker index of the calling thread.
+   * \param rv Output task.
+   * \return false if the queue was signalled for kill.
+   */
+  bool Pop(size_t worker_id, T *rv) {
+    while (!killed_.load(std::memory_order_acquire)) {
+      if (TryPopOwn(worker_id, rv)) return true;
+      for (size_t i = 1; i < num_workers_; ++i) {
+        if (TrySteal((worker_id + i) % num_workers_, rv)) return true;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      ++num_sleeping_;
+      // A pusher increments pending_ before it looks at num_sleeping_, so either we
+      // see its task here or it sees us sleeping and notifies under sleep_mutex_.
+      while (pending_.load() == 0 && !killed_.load()) {
+        cv_.wait(lock);
+      }
+      --num_sleeping_;
+    }
+    return false;
+  }
+  /*!
+   * \brief Wake up all workers and make Pop() return false.
+   */
+  void SignalForKill() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      killed_ = true;
+    }
+    cv_.notify_all();
+  }
+  /*! \return Number of queued tasks */
+  size_t Size() const {
+    return pending_.load();
+  }
+
+ private:
+  /*! \brief Deque of one worker */
+  struct WorkerDeque {
+    std::mutex mutex;
+    std::deque<T> tasks;
+  };
+
+  size_t TargetWorker() {
+    if (current_queue_ == this) return current_worker_;
+    return next_worker_.fetch_add(1, std::memory_order_relaxed) % num_workers_;
+  }
+
+  void OnPushed() {
+    ++pending_;
+    if (num_sleeping_.load() > 0) {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      cv_.notify_one();
+    }
+  }
+
+  bool TryPopOwn(size_t worker_id, T *rv) {
+    WorkerDeque &q = queues_[worker_id];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    *rv = q.tasks.front();
+    q.tasks.pop_front();
+    --pending_;
+    return true;
+  }
+
+  bool TrySteal(size_t victim, T *rv) {
+    WorkerDeque &q = queues_[victim];
+    // Don't wait behind the owner or another thief, just try the next victim
+    std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || q.tasks.empty()) return false;
+    *rv = q.tasks.back();
+    q.tasks.pop_back();
+    --pending_;
+    return true;
+  }
+
+  /*! \brief queue the calling thread is a worker of */
+  static MX_THREAD_LOCAL WorkStealingQueue *current_queue_;
+  /*! \brief worker index of the calling thread in current_queue_ */
+  static MX_THREAD_LOCAL size_t current_worker_;
+
+  const size_t num_workers_;
+  std::unique_ptr<WorkerDeque[]> queues_;
+  std::atomic<size_t> next_worker_{0};
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> num_sleeping_{0};
+  std::atomic<bool> killed_{false};
+  std::mutex sleep_mutex_;
+  std::condition_variable cv_;
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingQueue);
+};
+
+template<typename T>
+MX_THREAD_LOCAL WorkStealingQueue<T> *WorkStealingQueue<T>::current_queue_ = nullptr;
+template<typename T>
+MX_THREAD_LOCAL size_t WorkStealingQueue<T>::current_worker_ = 0;
+
+}  // namespace engine
+}  // namespace mxnet
+
+#endif  // MXNET_ENGINE_WORK_STEALING_QUEUE_H_
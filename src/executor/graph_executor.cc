@@ -62,6 +62,7 @@ GraphExecutor::~GraphExecutor() {
 }
 
 void GraphExecutor::Forward(bool is_train) {
+  UpdateOpSegsByCost();
   RunOps(is_train, 0, num_forward_nodes_);
 }
 
@@ -1127,6 +1128,12 @@ void GraphExecutor::InitCachedOps() {
     auto& exec = op_nodes_[nid].exec;
     bool is_async = op_nodes_[nid].exec->exec_type() == ExecType::kAsync;
     bool is_gpu = op_nodes_[nid].ctx.dev_mask() == gpu::kDevMask;
+    // only synchronous CPU ops can be timed from the engine thread
+    if (engine::BulkCostBudget() > 0 && !is_gpu &&
+        op_nodes_[nid].exec->exec_type() == ExecType::kSync) {
+      op_nodes_[nid].cost = std::make_shared<engine::OpCost>();
+    }
+    auto cost = op_nodes_[nid].cost;
 
     // the variables
     std::vector<Engine::VarHandle> use_vars, mutate_vars;
@@ -1155,12 +1162,16 @@ void GraphExecutor::InitCachedOps() {
         on_complete();
       }, Context::CPU(), {}, all_vars, FnProperty::kNormal, 0,
       "SetupExec");
-    auto exec_fun = [exec, is_async, is_gpu] (
+    auto exec_fun = [exec, is_async, is_gpu, cost] (
         RunContext ctx, Engine::CallbackOnComplete on_complete) {
       if (is_async) {
         exec->op_ctx.async_on_complete = on_complete;
       }
-      exec->Run(ctx, is_gpu);
+      if (cost) {
+        cost->Run([&]() { exec->Run(ctx, is_gpu); });
+      } else {
+        exec->Run(ctx, is_gpu);
+      }
       // call on complete only if it is async op
       if (!is_async) {
         if (is_gpu) {
@@ -1185,7 +1196,13 @@ void GraphExecutor::InitCachedOps() {
 
 void GraphExecutor::InitOpSegs() {
   size_t total_num_nodes = graph_.indexed_graph().num_nodes();
+  for (auto& seg : cached_seg_opr_) {
+    if (seg.opr != nullptr) {
+      Engine::Get()->DeleteOperator(seg.opr);
+    }
+  }
   cached_seg_opr_.clear();
+  resegment_by_cost_ = false;
   CachedSegOpr p;
   cached_seg_opr_.resize(total_num_nodes, p);
   if (monitor_callback_) return;
@@ -1212,19 +1229,34 @@ void GraphExecutor::InitOpSegs() {
 void GraphExecutor::BulkTrainingOpSegs(size_t total_num_nodes) {
   // The maximum number of node in a segment executed in bulk
   size_t num_nodes_threshold = dmlc::GetEnv("MXNET_EXEC_BULK_EXEC_MAX_NODE_TRAIN", 15);
+  // Cuts segments by measured op cost, if a time budget is set
+  engine::BulkCostSplitter cost_splitter(engine::BulkCostBudget(), num_nodes_threshold);
+  // Decide whether node nid is cut from the current segment. When it is, the segment
+  // ends before nid, and nid either starts the next segment (returns false) or runs on
+  // its own (returns true). Nodes without a cost are counted against num_nodes_threshold.
+  auto split = [&](size_t nid, size_t topo_start, bool *standalone) {
+    const auto& cost = op_nodes_[nid].cost;
+    if (cost == nullptr) {
+      *standalone = true;
+      return nid - topo_start > num_nodes_threshold;
+    }
+    return cost_splitter.Split(cost->Estimate(), standalone);
+  };
 
   // create forward segments for training
   size_t topo_start = 0;
   for (size_t nid = 0; nid < num_forward_nodes_; nid++) {
     auto &node = graph_.indexed_graph()[nid].source;
     auto &op_node = op_nodes_[nid];
+    bool standalone = true;
     // check if the segment relies on external input, or exceeds maxinum number of node,
     // or requires async ops
-    if (node->is_variable() || nid - topo_start > num_nodes_threshold ||
-        op_node.exec->exec_type() != ExecType::kSync) {
+    if (node->is_variable() || op_node.exec->exec_type() != ExecType::kSync ||
+        split(nid, topo_start, &standalone)) {
       // create a new segment for the previous nodes if the current one cannot be bulked
       cached_seg_opr_[topo_start] = this->CreateCachedSegOpr(topo_start, nid);
-      topo_start = nid + 1;
+      topo_start = standalone ? nid + 1 : nid;
+      if (standalone) cost_splitter.Reset();
     }
   }
   // the last segment
@@ -1240,15 +1272,18 @@ void GraphExecutor::BulkTrainingOpSegs(size_t total_num_nodes) {
   }
   auto &idx = graph_.indexed_graph();
   topo_start = num_forward_nodes_;
+  cost_splitter.Reset();
   for (size_t nid = num_forward_nodes_; nid < total_num_nodes; nid++) {
     auto &op_node = op_nodes_[nid];
     if (op_node.skip_exec_node || op_node.exec == nullptr) {
       continue;
     }
-    if (idx[nid].source->is_variable() || nid - topo_start > num_nodes_threshold ||
-        op_node.exec->exec_type() != ExecType::kSync) {
+    bool standalone = true;
+    if (idx[nid].source->is_variable() || op_node.exec->exec_type() != ExecType::kSync ||
+        split(nid, topo_start, &standalone)) {
       cached_seg_opr_[topo_start] = this->CreateCachedSegOpr(topo_start, nid);
-      topo_start = nid + 1;
+      topo_start = standalone ? nid + 1 : nid;
+      if (standalone) cost_splitter.Reset();
     } else {
       // If it produces output gradient, don't include it in the segment
       bool output_gradient = false;
@@ -1260,6 +1295,7 @@ void GraphExecutor::BulkTrainingOpSegs(size_t total_num_nodes) {
       if (output_gradient) {
         cached_seg_opr_[topo_start] = this->CreateCachedSegOpr(topo_start, nid);
         topo_start = nid + 1;
+        cost_splitter.Reset();
       }
     }
   }
@@ -1267,6 +1303,17 @@ void GraphExecutor::BulkTrainingOpSegs(size_t total_num_nodes) {
   if (topo_start < total_num_nodes) {
     cached_seg_opr_[topo_start] = this->CreateCachedSegOpr(topo_start, total_num_nodes);
   }
+  // Segment again once the nodes that were guessed have been measured
+  resegment_by_cost_ = cost_splitter.saw_unmeasured();
+}
+
+void GraphExecutor::UpdateOpSegsByCost() {
+  if (!resegment_by_cost_) return;
+  for (const auto& op_node : op_nodes_) {
+    if (op_node.cost && op_node.cost->Estimate() < 0) return;
+  }
+  // All costs are known now, this is the last time the segments change
+  this->InitOpSegs();
 }
 
 void GraphExecutor::BulkInferenceOpSegs() {
@@ -1377,6 +1424,7 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
     return ret;
   }
   std::string opr_names = "[";
+  std::vector<std::shared_ptr<engine::OpCost> > costs;
 
   const auto& idx = graph_.indexed_graph();
   for (size_t nid = topo_start; nid < topo_end; ++nid) {
@@ -1398,6 +1446,7 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
     std::copy(op_node.use_vars.begin(), op_node.use_vars.end(),
               std::inserter(use_vars, use_vars.end()));
     ret.exec_list.push_back(exec);
+    costs.push_back(op_node.cost);
     opr_names += inode.source->op()->name + ",";
   }
 
@@ -1406,11 +1455,15 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
   Engine::Get()->DeduplicateVarHandle(&use_vars, &mutate_vars);
 
   bool is_gpu = pctx->dev_mask() == gpu::kDevMask;
-  auto exec_fun = [exec_list, is_gpu] (
+  auto exec_fun = [exec_list, costs, is_gpu] (
       RunContext ctx, Engine::CallbackOnComplete on_complete) {
     // Run all opr in the sub-graph
-    for (auto &exec : exec_list) {
-      exec->Run(ctx, is_gpu);
+    for (size_t i = 0; i < exec_list.size(); ++i) {
+      if (costs[i]) {
+        costs[i]->Run([&]() { exec_list[i]->Run(ctx, is_gpu); });
+      } else {
+        exec_list[i]->Run(ctx, is_gpu);
+      }
     }
     if (is_gpu) {
 #if MXNET_USE_GPU
@@ -39,6 +39,7 @@
 #include <utility>
 #include <vector>
 #include "./exec_pass.h"
+#include "../engine/op_cost.h"
 
 namespace mxnet {
 
@@ -137,6 +138,8 @@ class GraphExecutor : public Executor {
     std::vector<Engine::VarHandle> use_vars;
     // cached mutate vars, used for seg ops creation
     std::vector<Engine::VarHandle> mutate_vars;
+    // measured run time, only for CPU sync ops when segments are sized by cost
+    std::shared_ptr<engine::OpCost> cost;
   };
   // a cached segment operator that executes a segment
   struct CachedSegOpr {
@@ -195,6 +198,8 @@ class GraphExecutor : public Executor {
   void InitCachedOps();
   // initialize the opr segments for bulk exec
   void InitOpSegs();
+  // rebuild the training segments once all op costs have been measured
+  void UpdateOpSegsByCost();
   // initialize the resources in the graph
   // initialize the memory of data entries
   // shared_pool: extra memory shared from other parts
@@ -254,6 +259,8 @@ class GraphExecutor : public Executor {
   bool prefer_bulk_execution_;
   // cached segment operator
   std::vector<CachedSegOpr> cached_seg_opr_;
+  // whether training segments are to be rebuilt from measured op costs
+  bool resegment_by_cost_{false};
   // cached segment operator name (needs a longer lifecycle than cached_seg_opr_)
   std::unordered_set<std::string> cached_seg_opr_names_;
   // verbose logging
@@ -248,6 +248,9 @@ class DefaultImageAugmenter : public ImageAugmenter {
       return inter_method;
     }
   }
+  int ResizeShorterEdge() const override {
+    return param_.resize;
+  }
   cv::Mat Process(const cv::Mat &src, std::vector<float> *label,
                   common::RANDOM_ENGINE *prnd) override {
     if (!seed_init_state && param_.seed_aug.has_value()) {
@@ -59,6 +59,14 @@ class ImageAugmenter {
    */
   virtual cv::Mat Process(const cv::Mat &src, std::vector<float> *label,
                           common::RANDOM_ENGINE *prnd) = 0;
+  /*!
+   * \brief the length the shorter edge of the source image is resized to before anything
+   *  else is done to it, so decoders may produce an image down to that size directly.
+   * \return the length, or -1 if the source is processed at its own size
+   */
+  virtual int ResizeShorterEdge() const {
+    return -1;
+  }
   // virtual destructor
   virtual ~ImageAugmenter() {}
   /*!
@@ -133,6 +133,8 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
   size_t shuffle_chunk_size;
   /*! \brief the seed for chunk shuffling */
   int shuffle_chunk_seed;
+  /*! \brief whether to decode jpeg images scaled down to the resize target */
+  bool jpeg_dct_scaling;
 
   // declare parameters
   DMLC_DECLARE_PARAMETER(ImageRecParserParam) {
@@ -172,6 +174,11 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
         .describe("The data shuffle buffer size in MB. Only valid if shuffle is true.");
     DMLC_DECLARE_FIELD(shuffle_chunk_seed).set_default(0)
         .describe("The random seed for shuffling");
+    DMLC_DECLARE_FIELD(jpeg_dct_scaling).set_default(false)
+        .describe("Whether to decode JPEG images at the smallest DCT scale that is not "
+                  "smaller than ``resize``, which saves most of the decoding of large images. "
+                  "The pixels differ slightly from a full decode followed by the resize. "
+                  "Only used by ImageRecordIter when built with libjpeg-turbo.");
   }
 };
 
@@ -342,8 +349,13 @@ struct ImageDetNormalizeParam :  public dmlc::Parameter<ImageDetNormalizeParam>
 
 // Define prefetcher parameters
 struct PrefetcherParam : public dmlc::Parameter<PrefetcherParam> {
+  enum CtxType { kCPU = 0, kGPU };
   /*! \brief number of prefetched batches */
   size_t prefetch_buffer;
+  /*! \brief device the batches are optimized for */
+  int ctx;
+  /*! \brief gpu the pinned batches are registered with */
+  int device_id;
   /*! \brief data type */
   dmlc::optional<int> dtype;
 
@@ -351,6 +363,13 @@ struct PrefetcherParam : public dmlc::Parameter<PrefetcherParam> {
   DMLC_DECLARE_PARAMETER(PrefetcherParam) {
     DMLC_DECLARE_FIELD(prefetch_buffer).set_default(4)
         .describe("Maximum number of batches to prefetch.");
+    DMLC_DECLARE_FIELD(ctx).set_default(kCPU)
+        .add_enum("cpu", kCPU)
+        .add_enum("gpu", kGPU)
+        .describe("Context the batches are optimized for. The batches are always on cpu, "
+                  "with ``gpu`` they are in pinned memory for faster copies to the gpu.");
+    DMLC_DECLARE_FIELD(device_id).set_default(0)
+        .describe("The gpu the pinned memory is used with when ``ctx`` is ``gpu``.");
     DMLC_DECLARE_FIELD(dtype)
       .add_enum("float32", mshadow::kFloat32)
       .add_enum("float64", mshadow::kFloat64)
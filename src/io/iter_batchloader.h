@@ -88,10 +88,10 @@ class BatchLoader : public IIterator<TBlobBatch> {
       }
       for (size_t i = 0; i < d.data.size(); ++i) {
         CHECK_EQ(unit_size_[i], d.data[i].Size());
-        MSHADOW_TYPE_SWITCH(data_[i].type_flag_, DType, {
+        MSHADOW_TYPE_SWITCH(out_.data[i].type_flag_, DType, {
             mshadow::Copy(
-              data_[i].get<cpu, 1, DType>().Slice(top * unit_size_[i],
-                                                  (top + 1) * unit_size_[i]),
+              out_.data[i].FlatTo1D<cpu, DType>().Slice(top * unit_size_[i],
+                                                        (top + 1) * unit_size_[i]),
               d.data[i].get_with_shape<cpu, 1, DType>(mshadow::Shape1(unit_size_[i])));
           });
       }
@@ -110,10 +110,10 @@ class BatchLoader : public IIterator<TBlobBatch> {
           // copy data
           for (size_t i = 0; i < d.data.size(); ++i) {
             CHECK_EQ(unit_size_[i], d.data[i].Size());
-            MSHADOW_TYPE_SWITCH(data_[i].type_flag_, DType, {
+            MSHADOW_TYPE_SWITCH(out_.data[i].type_flag_, DType, {
                 mshadow::Copy(
-                  data_[i].get<cpu, 1, DType>().Slice(top * unit_size_[i],
-                                                      (top + 1) * unit_size_[i]),
+                  out_.data[i].FlatTo1D<cpu, DType>().Slice(top * unit_size_[i],
+                                                            (top + 1) * unit_size_[i]),
                   d.data[i].get_with_shape<cpu, 1, DType>(mshadow::Shape1(unit_size_[i])));
               });
           }
@@ -129,6 +129,20 @@ class BatchLoader : public IIterator<TBlobBatch> {
   virtual const TBlobBatch &Value(void) const {
     return out_;
   }
+  /*!
+   * \brief write the following batches into data instead of the loader's own buffers,
+   *  so they need not be copied out. Only valid after the first batch, data has to be
+   *  shaped and typed like Value().data and outlive its use by Next().
+   */
+  inline void SetOutputData(const std::vector<TBlob> &data) {
+    CHECK_EQ(data.size(), out_.data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      CHECK_EQ(data[i].shape_, out_.data[i].shape_);
+      CHECK_EQ(data[i].type_flag_, out_.data[i].type_flag_);
+      CHECK_EQ(data[i].dev_mask(), cpu::kDevMask);
+    }
+    out_.data = data;
+  }
 
  protected:
   /*! \brief batch parameters */
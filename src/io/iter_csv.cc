@@ -26,9 +26,11 @@
 #include <dmlc/base.h>
 #include <dmlc/logging.h>
 #include <dmlc/parameter.h>
-#include <dmlc/data.h>
+#include <dmlc/omp.h>
+#include <dmlc/common.h>
 #include "./iter_prefetcher.h"
 #include "./iter_batchloader.h"
+#include "./text_parser.h"
 
 namespace mxnet {
 namespace io {
@@ -42,6 +44,8 @@ struct CSVIterParam : public dmlc::Parameter<CSVIterParam> {
   std::string label_csv;
   /*! \brief label shape */
   TShape label_shape;
+  /*! \brief number of threads parsing the input */
+  int preprocess_threads;
   // declare parameters
   DMLC_DECLARE_PARAMETER(CSVIterParam) {
     DMLC_DECLARE_FIELD(data_csv)
@@ -54,9 +58,89 @@ struct CSVIterParam : public dmlc::Parameter<CSVIterParam> {
     index_t shape1[] = {1};
     DMLC_DECLARE_FIELD(label_shape).set_default(TShape(shape1, shape1 + 1))
         .describe("The shape of one label.");
+    DMLC_DECLARE_FIELD(preprocess_threads).set_lower_bound(1).set_default(4)
+        .describe("The number of threads to parse the input with.");
   }
 };
 
+/*!
+ * \brief Parses the rows of a CSV file into one dense row major buffer per chunk, the
+ *  lines of a chunk in parallel. Fields are separated by commas, empty fields are 0.
+ */
+template<typename DType>
+class CSVRowParser {
+ public:
+  CSVRowParser(const std::string &uri, const TShape &shape, int nthread)
+      : source_(uri, 0, 1), shape_(shape), row_length_(shape.Size()), nthread_(nthread) {}
+
+  void BeforeFirst() {
+    source_.BeforeFirst();
+    num_rows_ = 0;
+  }
+
+  /*! \brief parse the next chunk with rows, false at the end of the file */
+  bool Next() {
+    const char *begin, *end;
+    do {
+      if (!source_.NextChunk(&begin, &end)) return false;
+      FindLines(begin, end, &lines_);
+    } while (lines_.empty());
+    num_rows_ = lines_.size();
+    if (values_.size() < num_rows_ * row_length_) {
+      values_.resize(num_rows_ * row_length_);
+    }
+    #pragma omp parallel for num_threads(nthread_) schedule(static)
+    for (int64_t i = 0; i < static_cast<int64_t>(num_rows_); ++i) {
+      omp_exc_.Run([&] {
+        ParseLine(lines_[i].first, lines_[i].second, values_.data() + i * row_length_);
+      });
+    }
+    omp_exc_.Rethrow();
+    return true;
+  }
+
+  size_t size() const {
+    return num_rows_;
+  }
+
+  /*! \brief row i of the current chunk */
+  TBlob Row(size_t i) const {
+    return TBlob(const_cast<DType*>(values_.data() + i * row_length_),  // NOLINT(*)
+                 shape_, cpu::kDevMask, 0);
+  }
+
+ private:
+  void ParseLine(const char *p, const char *end, DType *out) const {
+    size_t length = 0;
+    while (true) {
+      while (p < end && (*p == ' ' || *p == '\t')) ++p;
+      DType value = 0;
+      p = ParseNumber(p, end, &value);
+      if (length < row_length_) out[length] = value;
+      ++length;
+      // like dmlc's parser, anything following the number in a field is ignored
+      const char *comma = static_cast<const char*>(memchr(p, ',', end - p));
+      if (comma == nullptr) break;
+      p = comma + 1;
+      // a trailing comma does not start another field
+      while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+      if (p == end) break;
+    }
+    CHECK_EQ(length, row_length_)
+        << "The data size in CSV do not match size of shape: "
+        << "specified shape=" << shape_ << ", the csv row-length=" << length;
+  }
+
+  TextChunkSource source_;
+  TShape shape_;
+  size_t row_length_;
+  int nthread_;
+  std::vector<std::pair<const char*, const char*> > lines_;
+  std::vector<DType> values_;
+  size_t num_rows_ = 0;
+  dmlc::OMPException omp_exc_;
+};
+
 class CSVIterBase: public IIterator<DataInst> {
  public:
   CSVIterBase() {
@@ -97,10 +181,11 @@ class CSVIterTyped: public CSVIterBase {
   // intialize iterator loads data in
   virtual void Init(const std::vector<std::pair<std::string, std::string> >& kwargs) {
     param_.InitAllowUnknown(kwargs);
-    data_parser_.reset(dmlc::Parser<uint32_t, DType>::Create(param_.data_csv.c_str(), 0, 1, "csv"));
+    data_parser_.reset(new CSVRowParser<DType>(param_.data_csv, param_.data_shape,
+                                               param_.preprocess_threads));
     if (param_.label_csv != "NULL") {
-      label_parser_.reset(
-        dmlc::Parser<uint32_t, DType>::Create(param_.label_csv.c_str(), 0, 1, "csv"));
+      label_parser_.reset(new CSVRowParser<DType>(param_.label_csv, param_.label_shape,
+                                                  param_.preprocess_threads));
     } else {
       dummy_label.set_pad(false);
       dummy_label.Resize(mshadow::Shape1(1));
@@ -126,21 +211,21 @@ class CSVIterTyped: public CSVIterBase {
         end_ = true; return false;
       }
       data_ptr_ = 0;
-      data_size_ = data_parser_->Value().size;
+      data_size_ = data_parser_->size();
     }
     out_.index = inst_counter_++;
     CHECK_LT(data_ptr_, data_size_);
-    out_.data[0] = AsTBlob(data_parser_->Value()[data_ptr_++], param_.data_shape);
+    out_.data[0] = data_parser_->Row(data_ptr_++);
 
     if (label_parser_.get() != nullptr) {
       while (label_ptr_ >= label_size_) {
         CHECK(label_parser_->Next())
             << "Data CSV's row is smaller than the number of rows in label_csv";
         label_ptr_ = 0;
-        label_size_ = label_parser_->Value().size;
+        label_size_ = label_parser_->size();
       }
       CHECK_LT(label_ptr_, label_size_);
-      out_.data[1] = AsTBlob(label_parser_->Value()[label_ptr_++], param_.label_shape);
+      out_.data[1] = label_parser_->Row(label_ptr_++);
     } else {
       out_.data[1] = dummy_label;
     }
@@ -148,17 +233,10 @@ class CSVIterTyped: public CSVIterBase {
   }
 
  private:
-  inline TBlob AsTBlob(const dmlc::Row<uint32_t, DType>& row, const TShape& shape) {
-    CHECK_EQ(row.length, shape.Size())
-        << "The data size in CSV do not match size of shape: "
-        << "specified shape=" << shape << ", the csv row-length=" << row.length;
-    const DType* ptr = row.value;
-    return TBlob((DType*)ptr, shape, cpu::kDevMask, 0);  // NOLINT(*)
-  }
   // dummy label
   mshadow::TensorContainer<cpu, 1, DType> dummy_label;
-  std::unique_ptr<dmlc::Parser<uint32_t, DType> > label_parser_;
-  std::unique_ptr<dmlc::Parser<uint32_t, DType> > data_parser_;
+  std::unique_ptr<CSVRowParser<DType> > label_parser_;
+  std::unique_ptr<CSVRowParser<DType> > data_parser_;
 };
 
 class CSVIter: public IIterator<DataInst> {
@@ -49,6 +49,13 @@ namespace io {
 template<typename DType>
 class ImageRecordIOParser2 {
  public:
+  ~ImageRecordIOParser2() {
+#if MXNET_USE_OPENCV && MXNET_USE_LIBJPEG_TURBO
+    for (tjhandle handle : tj_handles_) {
+      tjDestroy(handle);
+    }
+#endif
+  }
   // initialize the parser
   inline void Init(const std::vector<std::pair<std::string, std::string> >& kwargs);
 
@@ -72,7 +79,7 @@ class ImageRecordIOParser2 {
     mshadow::Tensor<cpu, 3, DType>* data_ptr, const bool is_mirrored, const float contrast_scaled,
     const float illumination_scaled);
 #if MXNET_USE_LIBJPEG_TURBO
-  cv::Mat TJimdecode(cv::Mat buf, int color);
+  cv::Mat TJimdecode(cv::Mat buf, int color, tjhandle handle);
 #endif
 #endif
   inline size_t ParseChunk(DType* data_dptr, real_t* label_dptr, const size_t current_size,
@@ -91,7 +98,13 @@ class ImageRecordIOParser2 {
   #if MXNET_USE_OPENCV
   /*! \brief augmenters */
   std::vector<std::vector<std::unique_ptr<ImageAugmenter> > > augmenters_;
+  #if MXNET_USE_LIBJPEG_TURBO
+  /*! \brief decompressors, one per thread */
+  std::vector<tjhandle> tj_handles_;
   #endif
+  #endif
+  /*! \brief shorter edge images may be decoded down to, -1 to decode at full size */
+  int decode_shorter_edge_ = -1;
   /*! \brief random samplers */
   std::vector<std::unique_ptr<common::RANDOM_ENGINE> > prnds_;
   common::RANDOM_ENGINE rnd_;
@@ -160,6 +173,16 @@ inline void ImageRecordIOParser2<DType>::Init(
       augmenters_[i].back()->Init(kwargs);
     }
     prnds_.emplace_back(new common::RANDOM_ENGINE((i + 1) * kRandMagic));
+#if MXNET_USE_LIBJPEG_TURBO
+    if (static_cast<int>(tj_handles_.size()) <= i) {
+      tj_handles_.push_back(tjInitDecompress());
+      CHECK(tj_handles_.back() != nullptr) << tjGetErrorStr();
+    }
+#endif
+  }
+  // the first augmenter resizing the source allows decoding it scaled down
+  if (param_.jpeg_dct_scaling && !augmenters_[0].empty()) {
+    decode_shorter_edge_ = augmenters_[0].front()->ResizeShorterEdge();
   }
   if (param_.path_imglist.length() != 0) {
     label_map_.reset(new ImageLabelMap(param_.path_imglist.c_str(),
@@ -404,34 +427,36 @@ void ImageRecordIOParser2<DType>::ProcessImage(const cv::Mat& res,
     swap_indices[3] = 3;
   }
 
-  DType RGBA[n_channels] = {};
+  // normalize/mirror here to avoid memory copies, logic from iter_normalize.h, function
+  // SetOutImg. Each output row of a channel is written in one branch free pass the
+  // compiler can vectorize, reading the interleaved pixels of the row from cache.
+  const int cols = res.cols;
   for (int i = 0; i < res.rows; ++i) {
     const uchar* im_data = res.ptr<uchar>(i);
-    for (int j = 0; j < res.cols; ++j) {
-      for (int k = 0; k < n_channels; ++k) {
-        RGBA[k] = im_data[swap_indices[k]];
-      }
-      if (!std::is_same<DType, uint8_t>::value) {
-        // normalize/mirror here to avoid memory copies
-        // logic from iter_normalize.h, function SetOutImg
-        for (int k = 0; k < n_channels; ++k) {
-          if (meanfile_ready_) {
-            RGBA[k] = (RGBA[k] - meanimg_[k][i][j]) * RGBA_MULT[k] + RGBA_BIAS[k];
-          } else {
-            RGBA[k] = (RGBA[k] - RGBA_MEAN[k]) * RGBA_MULT[k] + RGBA_BIAS[k];
-          }
+    for (int k = 0; k < n_channels; ++k) {
+      const uchar* src = im_data + swap_indices[k];
+      DType* dst = data[k][i].dptr_;
+      // mirrored rows are written backwards
+      const int dst_begin = is_mirrored ? cols - 1 : 0;
+      const int dst_step = is_mirrored ? -1 : 1;
+      if (std::is_same<DType, uint8_t>::value) {
+        for (int j = 0; j < cols; ++j) {
+          dst[dst_begin + dst_step * j] = src[j * n_channels];
         }
-      }
-      for (int k = 0; k < n_channels; ++k) {
-        // mirror here to avoid memory copies
-        // logic from iter_normalize.h, function SetOutImg
-        if (is_mirrored) {
-          data[k][i][res.cols - j - 1] = RGBA[k];
-        } else {
-          data[k][i][j] = RGBA[k];
+      } else if (meanfile_ready_) {
+        const real_t* mean = meanimg_[k][i].dptr_;
+        const float mult = RGBA_MULT[k], bias = RGBA_BIAS[k];
+        for (int j = 0; j < cols; ++j) {
+          const DType v = src[j * n_channels];
+          dst[dst_begin + dst_step * j] = (v - mean[j]) * mult + bias;
+        }
+      } else {
+        const float mean = RGBA_MEAN[k], mult = RGBA_MULT[k], bias = RGBA_BIAS[k];
+        for (int j = 0; j < cols; ++j) {
+          const DType v = src[j * n_channels];
+          dst[dst_begin + dst_step * j] = (v - mean) * mult + bias;
         }
       }
-      im_data += n_channels;
     }
   }
 }
@@ -447,7 +472,7 @@ bool is_jpeg(unsigned char * file) {
 }
 
 template<typename DType>
-cv::Mat ImageRecordIOParser2<DType>::TJimdecode(cv::Mat image, int color) {
+cv::Mat ImageRecordIOParser2<DType>::TJimdecode(cv::Mat image, int color, tjhandle handle) {
   unsigned char* jpeg = image.ptr();
   size_t jpeg_size = image.rows * image.cols;
 
@@ -456,7 +481,6 @@ cv::Mat ImageRecordIOParser2<DType>::TJimdecode(cv::Mat image, int color) {
     return cv::imdecode(image, color);
   }
 
-  tjhandle handle = tjInitDecompress();
   int h, w, subsamp;
   int err = tjDecompressHeader2(handle,
                                 jpeg,
@@ -466,6 +490,24 @@ cv::Mat ImageRecordIOParser2<DType>::TJimdecode(cv::Mat image, int color) {
     // If it is a malformed JPEG then fall back to OpenCV
     return cv::imdecode(image, color);
   }
+  if (decode_shorter_edge_ > 0) {
+    // skip the high frequencies of the DCT, picking the smallest scale that is not below
+    // the size the image is resized to anyway
+    int num_factors;
+    const tjscalingfactor *factors = tjGetScalingFactors(&num_factors);
+    int scaled_w = w, scaled_h = h;
+    for (int i = 0; i < num_factors; ++i) {
+      if (factors[i].num >= factors[i].denom) continue;
+      const int sw = TJSCALED(w, factors[i]);
+      const int sh = TJSCALED(h, factors[i]);
+      if (std::min(sw, sh) >= decode_shorter_edge_ && sw < scaled_w) {
+        scaled_w = sw;
+        scaled_h = sh;
+      }
+    }
+    w = scaled_w;
+    h = scaled_h;
+  }
   cv::Mat ret = cv::Mat(h, w, color ? CV_8UC3 : CV_8UC1);
   err = tjDecompress2(handle,
                       jpeg,
@@ -480,7 +522,6 @@ cv::Mat ImageRecordIOParser2<DType>::TJimdecode(cv::Mat image, int color) {
     // If it is a malformed JPEG then fall back to OpenCV
     return cv::imdecode(image, color);
   }
-  tjDestroy(handle);
   return ret;
 }
 #endif
@@ -527,14 +568,14 @@ inline size_t ImageRecordIOParser2<DType>::ParseChunk(DType* data_dptr, real_t*
       switch (param_.data_shape[0]) {
        case 1:
 #if MXNET_USE_LIBJPEG_TURBO
-        res = TJimdecode(buf, 0);
+        res = TJimdecode(buf, 0, tj_handles_[tid]);
 #else
         res = cv::imdecode(buf, 0);
 #endif
         break;
        case 3:
 #if MXNET_USE_LIBJPEG_TURBO
-        res = TJimdecode(buf, 1);
+        res = TJimdecode(buf, 1, tj_handles_[tid]);
 #else
         res = cv::imdecode(buf, 1);
 #endif
@@ -25,9 +25,11 @@
 #include <dmlc/base.h>
 #include <dmlc/logging.h>
 #include <dmlc/parameter.h>
-#include <dmlc/data.h>
+#include <dmlc/omp.h>
+#include <dmlc/common.h>
 #include "./iter_sparse_prefetcher.h"
 #include "./iter_sparse_batchloader.h"
+#include "./text_parser.h"
 
 namespace mxnet {
 namespace io {
@@ -45,6 +47,8 @@ struct LibSVMIterParam : public dmlc::Parameter<LibSVMIterParam> {
   int num_parts;
   /*! \brief the index of the part will read*/
   int part_index;
+  /*! \brief number of threads parsing the input */
+  int preprocess_threads;
   // declare parameters
   DMLC_DECLARE_PARAMETER(LibSVMIterParam) {
     DMLC_DECLARE_FIELD(data_libsvm)
@@ -61,9 +65,141 @@ struct LibSVMIterParam : public dmlc::Parameter<LibSVMIterParam> {
         .describe("partition the data into multiple parts");
     DMLC_DECLARE_FIELD(part_index).set_default(0)
         .describe("the index of the part will read");
+    DMLC_DECLARE_FIELD(preprocess_threads).set_lower_bound(1).set_default(4)
+        .describe("The number of threads to parse the input with.");
   }
 };
 
+/*!
+ * \brief Parses the rows of a LibSVM file into CSR buffers per chunk, the lines of a chunk
+ *  in parallel: the features of each line are counted first, then written in place.
+ *  A line is `label[:weight] index:value ...`, a feature without a value is 1 and
+ *  everything after a `#` is a comment.
+ */
+class LibSVMRowParser {
+ public:
+  LibSVMRowParser(const std::string &uri, unsigned part_index, unsigned num_parts,
+                  int nthread)
+      : source_(uri, part_index, num_parts), nthread_(nthread) {}
+
+  void BeforeFirst() {
+    source_.BeforeFirst();
+    label_.clear();
+  }
+
+  /*! \brief parse the next chunk with rows, false at the end of the part */
+  bool Next() {
+    const char *begin, *end;
+    do {
+      if (!source_.NextChunk(&begin, &end)) return false;
+      FindLines(begin, end, &lines_);
+    } while (lines_.empty());
+    const int64_t num_rows = static_cast<int64_t>(lines_.size());
+    label_.resize(num_rows);
+    offset_.resize(num_rows + 1);
+    offset_[0] = 0;
+    #pragma omp parallel for num_threads(nthread_) schedule(static)
+    for (int64_t i = 0; i < num_rows; ++i) {
+      offset_[i + 1] = CountFeatures(lines_[i].first, lines_[i].second);
+    }
+    for (int64_t i = 0; i < num_rows; ++i) {
+      offset_[i + 1] += offset_[i];
+    }
+    index_.resize(offset_[num_rows]);
+    value_.resize(offset_[num_rows]);
+    #pragma omp parallel for num_threads(nthread_) schedule(static)
+    for (int64_t i = 0; i < num_rows; ++i) {
+      omp_exc_.Run([&] {
+        ParseLine(lines_[i].first, lines_[i].second, i);
+      });
+    }
+    omp_exc_.Rethrow();
+    return true;
+  }
+
+  size_t size() const {
+    return label_.size();
+  }
+
+  /*! \brief values of the features of row i */
+  TBlob Value(size_t i) const {
+    return TBlob(const_cast<real_t*>(value_.data() + offset_[i]),  // NOLINT(*)
+                 mshadow::Shape1(offset_[i + 1] - offset_[i]), cpu::kDevMask);
+  }
+
+  /*! \brief indices of the features of row i */
+  TBlob Index(size_t i) const {
+    return TBlob(const_cast<int64_t*>(index_.data() + offset_[i]),  // NOLINT(*)
+                 mshadow::Shape1(offset_[i + 1] - offset_[i]), cpu::kDevMask);
+  }
+
+  /*! \brief label of row i */
+  TBlob Label(size_t i) const {
+    return TBlob(const_cast<real_t*>(label_.data() + i),  // NOLINT(*)
+                 mshadow::Shape1(1), cpu::kDevMask);
+  }
+
+ private:
+  static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  /*! \brief whether the token at p is the query id, which may follow the label */
+  static bool IsQid(const char *p, const char *end) {
+    return end - p >= 4 && strncmp(p, "qid:", 4) == 0;
+  }
+
+  /*! \brief number of tokens after the label and the query id */
+  static size_t CountFeatures(const char *p, const char *end) {
+    size_t num_tokens = 0;
+    bool has_qid = false;
+    while (p < end && *p != '#') {
+      while (p < end && IsSpace(*p)) ++p;
+      if (p == end || *p == '#') break;
+      has_qid |= num_tokens == 1 && IsQid(p, end);
+      ++num_tokens;
+      while (p < end && !IsSpace(*p) && *p != '#') ++p;
+    }
+    return num_tokens == 0 ? 0 : num_tokens - 1 - has_qid;
+  }
+
+  void ParseLine(const char *p, const char *end, int64_t row) {
+    while (p < end && IsSpace(*p)) ++p;
+    const char *q = ParseNumber(p, end, &label_[row]);
+    CHECK(q != p) << "Invalid LibSVM label: " << std::string(p, std::min(end, p + 32));
+    // the instance weight and the query id are not used
+    while (q < end && !IsSpace(*q) && *q != '#') ++q;
+    while (q < end && IsSpace(*q)) ++q;
+    if (IsQid(q, end)) {
+      while (q < end && !IsSpace(*q) && *q != '#') ++q;
+    }
+    for (size_t k = offset_[row]; k < offset_[row + 1]; ++k) {
+      while (q < end && IsSpace(*q)) ++q;
+      p = q;
+      q = ParseNumber(p, end, &index_[k]);
+      CHECK(q != p && index_[k] >= 0)
+          << "Invalid LibSVM feature: " << std::string(p, std::min(end, p + 32));
+      value_[k] = 1.0f;
+      if (q < end && *q == ':') {
+        p = q + 1;
+        q = ParseNumber(p, end, &value_[k]);
+        CHECK(q != p) << "Invalid LibSVM feature value: "
+                      << std::string(p, std::min(end, p + 32));
+      }
+      while (q < end && !IsSpace(*q) && *q != '#') ++q;
+    }
+  }
+
+  TextChunkSource source_;
+  int nthread_;
+  std::vector<std::pair<const char*, const char*> > lines_;
+  std::vector<real_t> label_;
+  std::vector<size_t> offset_;
+  std::vector<int64_t> index_;
+  std::vector<real_t> value_;
+  dmlc::OMPException omp_exc_;
+};
+
 class LibSVMIter: public SparseIIterator<DataInst> {
  public:
   LibSVMIter() {}
@@ -75,13 +211,11 @@ class LibSVMIter: public SparseIIterator<DataInst> {
     CHECK_EQ(param_.data_shape.ndim(), 1) << "dimension of data_shape is expected to be 1";
     CHECK_GT(param_.num_parts, 0) << "number of parts should be positive";
     CHECK_GE(param_.part_index, 0) << "part index should be non-negative";
-    data_parser_.reset(dmlc::Parser<uint64_t>::Create(param_.data_libsvm.c_str(),
-                                                      param_.part_index,
-                                                      param_.num_parts, "libsvm"));
+    data_parser_.reset(new LibSVMRowParser(param_.data_libsvm, param_.part_index,
+                                           param_.num_parts, param_.preprocess_threads));
     if (param_.label_libsvm != "NULL") {
-      label_parser_.reset(dmlc::Parser<uint64_t>::Create(param_.label_libsvm.c_str(),
-                                                         param_.part_index,
-                                                         param_.num_parts, "libsvm"));
+      label_parser_.reset(new LibSVMRowParser(param_.label_libsvm, param_.part_index,
+                                              param_.num_parts, param_.preprocess_threads));
       CHECK_GT(param_.label_shape.Size(), 1)
         << "label_shape is not expected to be (1,) when param_.label_libsvm is set.";
     } else {
@@ -115,31 +249,31 @@ class LibSVMIter: public SparseIIterator<DataInst> {
         end_ = true; return false;
       }
       data_ptr_ = 0;
-      data_size_ = data_parser_->Value().size;
+      data_size_ = data_parser_->size();
     }
     out_.index = inst_counter_++;
     CHECK_LT(data_ptr_, data_size_);
-    const auto data_row = data_parser_->Value()[data_ptr_++];
+    const size_t data_row = data_ptr_++;
     // data, indices and indptr
-    out_.data[0] = AsDataBlob(data_row);
-    out_.data[1] = AsIdxBlob(data_row);
-    out_.data[2] = AsIndPtrPlaceholder(data_row);
+    out_.data[0] = data_parser_->Value(data_row);
+    out_.data[1] = data_parser_->Index(data_row);
+    out_.data[2] = AsIndPtrPlaceholder();
 
     if (label_parser_.get() != nullptr) {
       while (label_ptr_ >= label_size_) {
         CHECK(label_parser_->Next())
             << "Data LibSVM's row is smaller than the number of rows in label_libsvm";
         label_ptr_ = 0;
-        label_size_ = label_parser_->Value().size;
+        label_size_ = label_parser_->size();
       }
       CHECK_LT(label_ptr_, label_size_);
-      const auto label_row = label_parser_->Value()[label_ptr_++];
+      const size_t label_row = label_ptr_++;
       // data, indices and indptr
-      out_.data[3] = AsDataBlob(label_row);
-      out_.data[4] = AsIdxBlob(label_row);
-      out_.data[5] = AsIndPtrPlaceholder(label_row);
+      out_.data[3] = label_parser_->Value(label_row);
+      out_.data[4] = label_parser_->Index(label_row);
+      out_.data[5] = AsIndPtrPlaceholder();
     } else {
-      out_.data[3] = AsScalarLabelBlob(data_row);
+      out_.data[3] = data_parser_->Label(data_row);
     }
     return true;
   }
@@ -159,27 +293,10 @@ class LibSVMIter: public SparseIIterator<DataInst> {
   }
 
  private:
-  inline TBlob AsDataBlob(const dmlc::Row<uint64_t>& row) {
-    const real_t* ptr = row.value;
-    TShape shape(mshadow::Shape1(row.length));
-    return TBlob((real_t*) ptr, shape, cpu::kDevMask);  // NOLINT(*)
-  }
-
-  inline TBlob AsIdxBlob(const dmlc::Row<uint64_t>& row) {
-    const uint64_t* ptr = row.index;
-    TShape shape(mshadow::Shape1(row.length));
-    return TBlob((int64_t*) ptr, shape, cpu::kDevMask, mshadow::kInt64);  // NOLINT(*)
-  }
-
-  inline TBlob AsIndPtrPlaceholder(const dmlc::Row<uint64_t>& row) {
+  inline TBlob AsIndPtrPlaceholder() {
     return TBlob(nullptr, mshadow::Shape1(0), cpu::kDevMask, mshadow::kInt64);
   }
 
-  inline TBlob AsScalarLabelBlob(const dmlc::Row<uint64_t>& row) {
-    const real_t* ptr = row.label;
-    return TBlob((real_t*) ptr, mshadow::Shape1(1), cpu::kDevMask);  // NOLINT(*)
-  }
-
   LibSVMIterParam param_;
   // output instance
   DataInst out_;
@@ -190,8 +307,8 @@ class LibSVMIter: public SparseIIterator<DataInst> {
   // label parser
   size_t label_ptr_{0}, label_size_{0};
   size_t data_ptr_{0}, data_size_{0};
-  std::unique_ptr<dmlc::Parser<uint64_t> > label_parser_;
-  std::unique_ptr<dmlc::Parser<uint64_t> > data_parser_;
+  std::unique_ptr<LibSVMRowParser> label_parser_;
+  std::unique_ptr<LibSVMRowParser> data_parser_;
 };
 
 
@@ -20,7 +20,8 @@
 /*!
  *  Copyright (c) 2015 by Contributors
  * \file iter_prefetcher.h
- * \brief define a prefetcher using threaditer to keep k batch fetched
+ * \brief define a prefetcher using threaditer to keep k batch fetched,
+ *  filled in place by a BatchLoader
  */
 #ifndef MXNET_IO_ITER_PREFETCHER_H_
 #define MXNET_IO_ITER_PREFETCHER_H_
@@ -32,6 +33,7 @@
 #include <dmlc/threadediter.h>
 #include <dmlc/optional.h>
 #include <mshadow/tensor.h>
+#include <atomic>
 #include <climits>
 #include <utility>
 #include <string>
@@ -40,6 +42,8 @@
 #include <algorithm>
 #include "./inst_vector.h"
 #include "./image_iter_common.h"
+#include "./iter_batchloader.h"
+#include "../profiler/profiler.h"
 
 namespace mxnet {
 namespace io {
@@ -47,7 +51,10 @@ namespace io {
 class PrefetcherIter : public IIterator<DataBatch> {
  public:
   explicit PrefetcherIter(IIterator<TBlobBatch>* base)
-      : loader_(base), out_(nullptr) {}
+      : loader_(base), out_(nullptr),
+        load_counter_("Load Time (us)", Domain()),
+        wait_counter_("Wait Time (us)", Domain()),
+        ready_counter_("Ready Batches", Domain()) {}
 
   ~PrefetcherIter() {
     while (recycle_queue_.size() != 0) {
@@ -73,42 +80,67 @@ class PrefetcherIter : public IIterator<DataBatch> {
     InitParams(kwargs);
     // use the kwarg to init batch loader
     loader_->Init(kwargs);
+    batch_loader_ = dynamic_cast<BatchLoader*>(loader_.get());
     iter.Init([this](DataBatch **dptr) {
+        const uint64_t start = profiler::ProfileStat::NowInMicrosec();
+        // once the shapes are known the batch loader writes into the batches directly
+        const bool direct = batch_loader_ != nullptr && !shapes_.empty();
+        if (direct) {
+          if (*dptr == nullptr) {
+            *dptr = AllocBatch(shapes_, types_, batch_loader_->Value().batch_size);
+          }
+          std::vector<TBlob> blobs;
+          for (NDArray& arr : (*dptr)->data) {
+            blobs.push_back(arr.data());
+          }
+          batch_loader_->SetOutputData(blobs);
+        }
         if (!loader_->Next()) return false;
         const TBlobBatch& batch = loader_->Value();
         if (*dptr == nullptr) {
-          // allocate databatch
-          *dptr = new DataBatch();
-          (*dptr)->num_batch_padd = batch.num_batch_padd;
-          (*dptr)->data.resize(batch.data.size());
-          (*dptr)->index.resize(batch.batch_size);
+          std::vector<TShape> shapes;
+          std::vector<int> types;
           for (size_t i = 0; i < batch.data.size(); ++i) {
-            auto dtype = param_.dtype
-                             ? param_.dtype.value()
-                             : batch.data[i].type_flag_;
-            (*dptr)->data.at(i) = NDArray(batch.data[i].shape_,
-                                          Context::CPU(), false,
-                                          dtype);
+            shapes.push_back(batch.data[i].shape_);
+            types.push_back(param_.dtype ? param_.dtype.value() : batch.data[i].type_flag_);
+          }
+          *dptr = AllocBatch(shapes, types, batch.batch_size);
+          if (batch_loader_ != nullptr &&
+              std::equal(types.begin(), types.end(), batch.data.begin(),
+                         [](int type, const TBlob &blob) { return type == blob.type_flag_; })) {
+            shapes_ = shapes;
+            types_ = types;
           }
         }
         CHECK(batch.data.size() == (*dptr)->data.size());
-        // copy data over
-        for (size_t i = 0; i < batch.data.size(); ++i) {
-          CHECK_EQ((*dptr)->data.at(i).shape(), batch.data[i].shape_);
-          MSHADOW_TYPE_SWITCH(batch.data[i].type_flag_, DType, {
-              mshadow::Copy(((*dptr)->data)[i].data().FlatTo2D<cpu, DType>(),
-                        batch.data[i].FlatTo2D<cpu, DType>());
-          });
-          (*dptr)->num_batch_padd = batch.num_batch_padd;
+        if (!direct) {
+          // copy data over
+          for (size_t i = 0; i < batch.data.size(); ++i) {
+            CHECK_EQ((*dptr)->data.at(i).shape(), batch.data[i].shape_);
+            MSHADOW_TYPE_SWITCH(batch.data[i].type_flag_, DType, {
+                mshadow::Copy(((*dptr)->data)[i].data().FlatTo2D<cpu, DType>(),
+                          batch.data[i].FlatTo2D<cpu, DType>());
+            });
+          }
         }
+        (*dptr)->num_batch_padd = batch.num_batch_padd;
         if (batch.inst_index) {
           std::copy(batch.inst_index,
                     batch.inst_index + batch.batch_size,
                     (*dptr)->index.begin());
         }
-       return true;
+        const uint64_t ready = ++num_ready_;
+        if (profiler::Profiler::Get()->GetState() == profiler::Profiler::kRunning) {
+          load_counter_ = profiler::ProfileStat::NowInMicrosec() - start;
+          ready_counter_ = ready;
+        }
+        return true;
       },
-      [this]() { loader_->BeforeFirst(); });
+      [this]() {
+        // the queued batches are dropped along
+        num_ready_ = 0;
+        loader_->BeforeFirst();
+      });
   }
 
   virtual void BeforeFirst(void) {
@@ -129,7 +161,14 @@ class PrefetcherIter : public IIterator<DataBatch> {
       recycle_queue_.pop();
       iter.Recycle(&old_batch);
     }
-    return iter.Next(&out_);
+    const uint64_t start = profiler::ProfileStat::NowInMicrosec();
+    if (!iter.Next(&out_)) return false;
+    const uint64_t ready = --num_ready_;
+    if (profiler::Profiler::Get()->GetState() == profiler::Profiler::kRunning) {
+      wait_counter_ = profiler::ProfileStat::NowInMicrosec() - start;
+      ready_counter_ = ready;
+    }
+    return true;
   }
   virtual const DataBatch &Value(void) const {
     return *out_;
@@ -144,10 +183,45 @@ class PrefetcherIter : public IIterator<DataBatch> {
   std::unique_ptr<IIterator<TBlobBatch> > loader_;
 
  private:
+  /*!
+   * \brief allocate a batch on the loader thread, so its memory is first touched on the
+   *  NUMA node the batches are filled on. Pinned when optimizing for the gpu.
+   */
+  DataBatch *AllocBatch(const std::vector<TShape> &shapes, const std::vector<int> &types,
+                        size_t batch_size) {
+    const Context ctx = param_.ctx == PrefetcherParam::kGPU && param_.device_id >= 0
+                        ? Context::CPUPinned(param_.device_id) : Context::CPU();
+    DataBatch *batch = new DataBatch();
+    batch->data.resize(shapes.size());
+    batch->index.resize(batch_size);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      batch->data.at(i) = NDArray(shapes[i], ctx, false, types[i]);
+    }
+    return batch;
+  }
+
+  static profiler::ProfileDomain *Domain() {
+    static profiler::ProfileDomain domain("PrefetcherIter");
+    return &domain;
+  }
+
   /*! \brief output data */
   DataBatch *out_;
   /*! \brief queue to be recycled */
   std::queue<DataBatch*> recycle_queue_;
+  /*! \brief the loader, if it can write into the batches */
+  BatchLoader *batch_loader_ = nullptr;
+  /*! \brief shapes and types of the batches written by the loader, empty until known */
+  std::vector<TShape> shapes_;
+  std::vector<int> types_;
+  /*! \brief batches loaded and not yet taken by Next() */
+  std::atomic<int64_t> num_ready_{0};
+  /*!
+   * \brief time the loader took for the last batch, time Next() waited for it and the
+   *  number of batches ready, reported while the profiler runs. A loader busy for longer
+   *  than the consumer between batches means the pipeline is bound by loading.
+   */
+  profiler::ProfileCounter load_counter_, wait_counter_, ready_counter_;
 };
 }  // namespace io
 }  // namespace mxnet
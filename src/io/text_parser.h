@@ -0,0 +1,267 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  Copyright (c) 2019 by Contributors
+ * \file text_parser.h
+ * \brief line aligned chunks of text files and the number tokenizer shared by the
+ *  CSV and LibSVM iterators, which parse the lines of a chunk in parallel
+ */
+#ifndef MXNET_IO_TEXT_PARSER_H_
+#define MXNET_IO_TEXT_PARSER_H_
+
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif  // !defined(_WIN32)
+#include "../common/mapped_file.h"
+
+namespace mxnet {
+namespace io {
+
+/*!
+ * \brief Chunks of whole lines of one part of a text file. A local regular file is memory
+ *  mapped and chunked in place, anything else (directories, remote URIs) is read through
+ *  a dmlc::InputSplit. Parts split the file at the same lines as the InputSplit does.
+ */
+class TextChunkSource {
+ public:
+  TextChunkSource(const std::string &uri, unsigned part_index, unsigned num_parts) {
+#if !defined(_WIN32)
+    struct stat st;
+    if (uri.find("://") == std::string::npos && stat(uri.c_str(), &st) == 0 &&
+        S_ISREG(st.st_mode)) {
+      file_.reset(new common::MappedFile(uri));
+      const size_t size = file_->size();
+      // the byte offsets of dmlc's InputSplitBase, whose text splitter has no alignment
+      const size_t step = (size + num_parts - 1) / num_parts;
+      part_begin_ = file_->data() + LineBegin(std::min(step * part_index, size));
+      part_end_ = file_->data() + LineBegin(std::min(step * (part_index + 1), size));
+      pos_ = part_begin_;
+      return;
+    }
+#endif  // !defined(_WIN32)
+    split_.reset(dmlc::InputSplit::Create(uri.c_str(), part_index, num_parts, "text"));
+  }
+
+  /*!
+   * \brief the next chunk, valid until the next call
+   * \return false at the end of the part
+   */
+  bool NextChunk(const char **begin, const char **end) {
+    if (split_ != nullptr) {
+      dmlc::InputSplit::Blob blob;
+      if (!split_->NextChunk(&blob)) return false;
+      *begin = static_cast<const char*>(blob.dptr);
+      *end = *begin + blob.size;
+      return true;
+    }
+    if (pos_ >= part_end_) return false;
+    const char *chunk_end = part_end_;
+    if (static_cast<size_t>(part_end_ - pos_) > kChunkSize) {
+      const char *nl = static_cast<const char*>(
+          memchr(pos_ + kChunkSize, '\n', part_end_ - pos_ - kChunkSize));
+      chunk_end = nl == nullptr ? part_end_ : nl + 1;
+    }
+    *begin = pos_;
+    *end = chunk_end;
+    pos_ = chunk_end;
+    return true;
+  }
+
+  void BeforeFirst() {
+    if (split_ != nullptr) {
+      split_->BeforeFirst();
+    } else {
+      pos_ = part_begin_;
+    }
+  }
+
+ private:
+  /*! \brief bytes per chunk of a mapped file */
+  static const size_t kChunkSize = 16 << 20;
+
+  /*! \brief start of the first line past offset, the rule of dmlc's line splitter */
+  size_t LineBegin(size_t offset) const {
+    const char *data = file_->data();
+    const size_t size = file_->size();
+    if (offset == 0 || offset >= size) return std::min(offset, size);
+    while (offset < size && data[offset] != '\n' && data[offset] != '\r') ++offset;
+    while (offset < size && (data[offset] == '\n' || data[offset] == '\r')) ++offset;
+    return offset;
+  }
+
+  std::unique_ptr<common::MappedFile> file_;
+  const char *part_begin_ = nullptr;
+  const char *part_end_ = nullptr;
+  const char *pos_ = nullptr;
+  std::unique_ptr<dmlc::InputSplit> split_;
+};
+
+/*! \brief the non-blank lines of [begin, end), without their line breaks */
+inline void FindLines(const char *begin, const char *end,
+                      std::vector<std::pair<const char*, const char*> > *lines) {
+  lines->clear();
+  const char *p = begin;
+  while (p < end) {
+    const char *nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    const char *line_end = nl == nullptr ? end : nl;
+    const char *q = p;
+    while (q < line_end && (*q == ' ' || *q == '\t' || *q == '\r')) ++q;
+    if (q < line_end) {
+      lines->emplace_back(p, line_end);
+    }
+    p = line_end + 1;
+  }
+}
+
+/*! \brief value converted to a floating point DType */
+template<typename DType, typename T>
+inline DType SaturateCast(const T value, std::false_type) {
+  return static_cast<DType>(value);
+}
+
+/*! \brief value converted to an integer DType, saturating out of its range, NaN gives 0 */
+template<typename DType, typename T>
+inline DType SaturateCast(const T value, std::true_type) {
+  // inclusive, as the bounds of int64_t are +-2^63 as doubles
+  if (value >= static_cast<T>(std::numeric_limits<DType>::max())) {
+    return std::numeric_limits<DType>::max();
+  }
+  if (value <= static_cast<T>(std::numeric_limits<DType>::min())) {
+    return std::numeric_limits<DType>::min();
+  }
+  return value == value ? static_cast<DType>(value) : DType(0);
+}
+
+template<typename DType, typename T>
+inline DType SaturateCast(const T value) {
+  return SaturateCast<DType>(value, std::is_integral<DType>());
+}
+
+/*!
+ * \brief parse the number at p, stopping at end. Plain decimals with an optional exponent
+ *  are converted directly when that rounds correctly, anything else (inf, nan, very long
+ *  mantissas) by strtod, or strtof for float. Integers out of the range of DType saturate.
+ * \return the end of the number, p if there is none
+ */
+template<typename DType>
+inline const char *ParseNumber(const char *p, const char *end, DType *out) {
+  const char *q = p;
+  const bool negative = q < end && *q == '-';
+  if (q < end && (*q == '-' || *q == '+')) ++q;
+  uint64_t mantissa = 0;
+  int num_digits = 0, exponent = 0;
+  bool exact = true, integral = true, has_digits = false;
+  for (; q < end && *q >= '0' && *q <= '9'; ++q) {
+    has_digits = true;
+    if (num_digits < 19) {
+      mantissa = mantissa * 10 + (*q - '0');
+      num_digits += mantissa != 0;
+    } else {
+      ++exponent;
+      exact = false;
+    }
+  }
+  if (q < end && *q == '.') {
+    integral = false;
+    for (++q; q < end && *q >= '0' && *q <= '9'; ++q) {
+      has_digits = true;
+      if (num_digits < 19) {
+        mantissa = mantissa * 10 + (*q - '0');
+        num_digits += mantissa != 0;
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+  }
+  if (has_digits && q < end && (*q == 'e' || *q == 'E')) {
+    integral = false;
+    const char *e = q + 1;
+    const bool negative_exp = e < end && *e == '-';
+    if (e < end && (*e == '-' || *e == '+')) ++e;
+    if (e < end && *e >= '0' && *e <= '9') {
+      int exp_value = 0;
+      for (; e < end && *e >= '0' && *e <= '9'; ++e) {
+        exp_value = std::min(exp_value * 10 + (*e - '0'), 100000);
+      }
+      exponent += negative_exp ? -exp_value : exp_value;
+      q = e;
+    } else {
+      exact = false;
+    }
+  }
+  if (has_digits && exact && integral && std::is_integral<DType>::value &&
+      mantissa <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+    const int64_t value = static_cast<int64_t>(mantissa);
+    *out = SaturateCast<DType>(negative ? -value : value);
+    return q;
+  }
+  // powers of ten exactly representable in a double
+  static const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  // Both operands are exact, so the division or product is correctly rounded. A float is
+  // only rounded once more from the double without error if the operands are exact floats,
+  // which are a mantissa below 2^24 and powers of ten up to 1e10.
+  const bool is_float = std::is_same<DType, float>::value;
+  const uint64_t max_mantissa = uint64_t(1) << (is_float ? 24 : 53);
+  const int max_exponent = is_float ? 10 : 22;
+  if (has_digits && exact && mantissa < max_mantissa &&
+      exponent >= -max_exponent && exponent <= max_exponent) {
+    double value = static_cast<double>(mantissa);
+    value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+    *out = SaturateCast<DType>(negative ? -value : value);
+    return q;
+  }
+  // everything else goes through a terminated copy of the token
+  char buf[64];
+  size_t len = 0;
+  while (p + len < end && len + 1 < sizeof(buf) && !strchr(",: \t\r\n", p[len])) ++len;
+  memcpy(buf, p, len);
+  buf[len] = '\0';
+  char *buf_end;
+  if (is_float) {
+    const float value = strtof(buf, &buf_end);
+    if (buf_end == buf) return p;
+    *out = static_cast<DType>(value);
+  } else {
+    const double value = strtod(buf, &buf_end);
+    if (buf_end == buf) return p;
+    *out = SaturateCast<DType>(value);
+  }
+  return p + (buf_end - buf);
+}
+
+}  // namespace io
+}  // namespace mxnet
+#endif  // MXNET_IO_TEXT_PARSER_H_
@@ -32,6 +32,7 @@
 #include <thread>
 #include "mxnet/ndarray.h"
 #include "gradient_compression.h"
+#include "./cpu_reduce.h"
 #include "../ndarray/ndarray_function.h"
 #include "../operator/tensor/sparse_retain-inl.h"
 #include "./kvstore_utils.h"
@@ -105,6 +106,7 @@ class CommCPU : public Comm {
   CommCPU() {
     nthread_reduction_ = dmlc::GetEnv("MXNET_KVSTORE_REDUCTION_NTHREADS", 4);
     bigarray_bound_ = dmlc::GetEnv("MXNET_KVSTORE_BIGARRAY_BOUND", 1000 * 1000);
+    reduction_fanin_ = std::max(2, dmlc::GetEnv("MXNET_KVSTORE_REDUCTION_FANIN", 8));
     // TODO(junwu) delete the following data member, now for benchmark only
     is_serial_push_ = dmlc::GetEnv("MXNET_KVSTORE_SERIAL_PUSH", 0);
   }
@@ -163,12 +165,16 @@ class CommCPU : public Comm {
         const_vars[i-1] = reduce[i].var();
       }
 
-      Engine::Get()->PushAsync(
-        [reduce, this](RunContext rctx, Engine::CallbackOnComplete on_complete) {
-          ReduceSumCPU(reduce);
-          on_complete();
-        }, Context::CPU(), const_vars, {reduce[0].var()},
-        FnProperty::kCPUPrioritized, priority, "KVStoreReduce");
+      if (reduce.size() > reduction_fanin_ && src[0].shape().Size() >= bigarray_bound_) {
+        ReduceSumTree(reduce, priority);
+      } else {
+        Engine::Get()->PushAsync(
+          [reduce, this](RunContext rctx, Engine::CallbackOnComplete on_complete) {
+            ReduceSumCPU(reduce);
+            on_complete();
+          }, Context::CPU(), const_vars, {reduce[0].var()},
+          FnProperty::kCPUPrioritized, priority, "KVStoreReduce");
+      }
 
     } else {
       // sparse reduce
@@ -355,57 +361,35 @@ class CommCPU : public Comm {
   }
 
   template<typename DType>
-  inline static void ReduceSumCPU(
-      const std::vector<DType*> &dptr, size_t offset, index_t size) {
-    using namespace mshadow;  // NOLINT(*)
-    Tensor<cpu, 1, DType> in_0(dptr[0] + offset, Shape1(size));
-    for (size_t i = 1; i < dptr.size(); i+=4) {
-      switch (dptr.size() - i) {
-        case 1: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          in_0 += in_1;
-          break;
-        }
-        case 2: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          in_0 += in_1 + in_2;
-          break;
-        }
-        case 3: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3;
-          break;
-        }
-        default: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_4(dptr[i+3] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3 + in_4;
-          break;
-        }
-      }
-    }
+  inline void ReduceSumCPUImpl(const std::vector<DType*> &dptr, size_t total) {
+    const size_t step = std::min(bigarray_bound_, static_cast<size_t>(4 << 10));
+    kvstore::ReduceSumCPU(dptr, total, step,
+                          total < bigarray_bound_ ? 1 : nthread_reduction_);
   }
 
-  template<typename DType>
-  inline void ReduceSumCPUImpl(std::vector<DType*> dptr, size_t total) {
-    const size_t step = std::min(bigarray_bound_, static_cast<size_t>(4 << 10));
-    long ntask = (total + step - 1) / step; // NOLINT(*)
-    if (total < bigarray_bound_ || nthread_reduction_ <= 1) {
-      ReduceSumCPU(dptr, 0, total);
-    } else {
-      #pragma omp parallel for schedule(static) num_threads(nthread_reduction_)
-      for (long j = 0; j < ntask; ++j) { // NOLINT(*)
-        size_t k = static_cast<size_t>(j);
-        size_t begin = std::min(k * step, total);
-        size_t end = std::min((k + 1) * step, total);
-        if (j == ntask - 1) CHECK_EQ(end, total);
-        ReduceSumCPU(dptr, begin, static_cast<index_t>(end - begin));
+  // Sum level[1..] into level[0] with a tree of engine ops, each summing at most
+  // reduction_fanin_ arrays into the first of them. The leaves only wait for the copies
+  // of their own inputs, so they run while the remaining copies are still in flight.
+  inline void ReduceSumTree(std::vector<NDArray> level, int priority) {
+    while (level.size() > 1) {
+      std::vector<NDArray> next;
+      for (size_t first = 0; first < level.size(); first += reduction_fanin_) {
+        const size_t last = std::min(first + reduction_fanin_, level.size());
+        std::vector<NDArray> group(level.begin() + first, level.begin() + last);
+        next.push_back(group[0]);
+        if (group.size() == 1) continue;
+        std::vector<Engine::VarHandle> const_vars;
+        for (size_t i = 1; i < group.size(); ++i) {
+          const_vars.push_back(group[i].var());
+        }
+        Engine::Get()->PushAsync(
+          [group, this](RunContext rctx, Engine::CallbackOnComplete on_complete) {
+            ReduceSumCPU(group);
+            on_complete();
+          }, Context::CPU(), const_vars, {group[0].var()},
+          FnProperty::kCPUPrioritized, priority, "KVStoreReduce");
       }
+      level.swap(next);
     }
   }
 
@@ -437,6 +421,7 @@ class CommCPU : public Comm {
   std::unordered_map<int, BufferEntry> merge_buf_;
   size_t bigarray_bound_;
   int nthread_reduction_;
+  size_t reduction_fanin_;
   bool is_serial_push_;
 };
 
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * Copyright (c) 2019 by Contributors
+ * \file cpu_reduce.h
+ * \brief Cache tiled summation of dense CPU buffers, used by CommCPU
+ */
+#ifndef MXNET_KVSTORE_CPU_REDUCE_H_
+#define MXNET_KVSTORE_CPU_REDUCE_H_
+
+#include <dmlc/omp.h>
+#include <mshadow/base.h>
+#include <algorithm>
+#include <vector>
+
+namespace mxnet {
+namespace kvstore {
+
+/**
+ * \brief type the sums of DType are accumulated in
+ */
+template<typename DType>
+struct ReduceAccType {
+  typedef DType type;
+};
+template<>
+struct ReduceAccType<mshadow::half::half_t> {
+  typedef float type;
+};
+
+/**
+ * \brief number of elements reduced at a time. The accumulator of a tile stays in L1 while
+ *  the sources stream through it.
+ */
+constexpr size_t kReduceTileSize = 1024;
+
+/**
+ * \brief add n elements of src to acc, four sources at a time
+ */
+template<typename AType, typename DType>
+inline void AccumulateTile(AType* __restrict acc, const std::vector<DType*> &src,
+                           size_t first, size_t offset, size_t n) {
+  size_t i = first;
+  for (; i + 4 <= src.size(); i += 4) {
+    const DType* __restrict in_0 = src[i] + offset;
+    const DType* __restrict in_1 = src[i + 1] + offset;
+    const DType* __restrict in_2 = src[i + 2] + offset;
+    const DType* __restrict in_3 = src[i + 3] + offset;
+    for (size_t j = 0; j < n; ++j) {
+      // pairwise, to keep the dependency chains short
+      acc[j] += (static_cast<AType>(in_0[j]) + static_cast<AType>(in_1[j])) +
+                (static_cast<AType>(in_2[j]) + static_cast<AType>(in_3[j]));
+    }
+  }
+  for (; i < src.size(); ++i) {
+    const DType* __restrict in = src[i] + offset;
+    for (size_t j = 0; j < n; ++j) {
+      acc[j] += static_cast<AType>(in[j]);
+    }
+  }
+}
+
+/**
+ * \brief dptr[0][offset, offset + size) += sum of dptr[i][offset, offset + size), i > 0.
+ *  Half precision inputs are accumulated in float and rounded once.
+ */
+template<typename DType>
+inline void ReduceSumTiled(const std::vector<DType*> &dptr, size_t offset, size_t size) {
+  typedef typename ReduceAccType<DType>::type AType;
+  AType acc[kReduceTileSize];
+  for (size_t begin = offset; begin < offset + size; begin += kReduceTileSize) {
+    const size_t n = std::min(kReduceTileSize, offset + size - begin);
+    DType *out = dptr[0] + begin;
+    for (size_t j = 0; j < n; ++j) {
+      acc[j] = static_cast<AType>(out[j]);
+    }
+    AccumulateTile(acc, dptr, 1, begin, n);
+    for (size_t j = 0; j < n; ++j) {
+      out[j] = static_cast<DType>(acc[j]);
+    }
+  }
+}
+
+/**
+ * \brief dptr[0] += sum of dptr[i], i > 0, over total elements.
+ * \param step number of elements per task when running in parallel
+ * \param nthreads number of OpenMP threads, no parallelism if <= 1
+ */
+template<typename DType>
+inline void ReduceSumCPU(const std::vector<DType*> &dptr, size_t total,
+                         size_t step, int nthreads) {
+  if (dptr.size() < 2) return;
+  if (nthreads <= 1 || total <= step) {
+    ReduceSumTiled(dptr, 0, total);
+    return;
+  }
+  const long ntask = (total + step - 1) / step;  // NOLINT(*)
+  #pragma omp parallel for schedule(static) num_threads(nthreads)
+  for (long j = 0; j < ntask; ++j) {  // NOLINT(*)
+    const size_t begin = static_cast<size_t>(j) * step;
+    ReduceSumTiled(dptr, begin, std::min(step, total - begin));
+  }
+}
+
+}  // namespace kvstore
+}  // namespace mxnet
+
+#endif  // MXNET_KVSTORE_CPU_REDUCE_H_
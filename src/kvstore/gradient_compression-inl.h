@@ -25,6 +25,10 @@
 #ifndef MXNET_KVSTORE_GRADIENT_COMPRESSION_INL_H_
 #define MXNET_KVSTORE_GRADIENT_COMPRESSION_INL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include "../operator/mxnet_op.h"
 
@@ -149,6 +153,241 @@ inline void Dequantize2BitImpl(mshadow::Stream<mshadow::cpu> *s,
                                const float threshold) {
   Dequantize2BitKernelLaunch(s, inputs, threshold);
 }
+/*!
+ * \brief Block sizes of the CPU compression types. Each block of the original array is
+ *  compressed into a fixed number of floats independently of the others, so a compressed
+ *  array can be split between servers at block boundaries.
+ */
+constexpr int kTopKBlockSize = 256;
+constexpr int kOneBitBlockSize = 1024;
+constexpr int kEightBitBlockSize = 256;
+
+inline uint32_t FloatBits(const float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+inline float BitsFloat(const uint32_t bits) {
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+/*!
+ * \brief Top-k sparsification. Of each block of kTopKBlockSize values of gradient plus
+ *  residual, the k largest in magnitude are sent, one float each. The low 8 bits of the
+ *  mantissa of a sent value hold its index in the block. What is not sent, including the
+ *  dropped mantissa bits, stays in the residual.
+ */
+struct quantize_topk {
+  static void Map(int block, int original_size, float *out, const float *grad,
+                  float *residual, const int k) {
+    const int start = block * kTopKBlockSize;
+    const int n = std::min(kTopKBlockSize, original_size - start);
+    float *res = residual + start;
+    const float *g = grad + start;
+    uint32_t *compr = reinterpret_cast<uint32_t*>(out) + static_cast<size_t>(block) * k;
+    uint8_t idx[kTopKBlockSize];
+    for (int i = 0; i < n; ++i) {
+      res[i] += g[i];
+      idx[i] = static_cast<uint8_t>(i);
+    }
+    const int kept = std::min(k, n);
+    std::nth_element(idx, idx + kept - 1, idx + n, [res](uint8_t a, uint8_t b) {
+      return std::fabs(res[a]) > std::fabs(res[b]);
+    });
+    for (int j = 0; j < kept; ++j) {
+      const int i = idx[j];
+      const uint32_t bits = FloatBits(res[i]) & ~0xffu;
+      if ((bits & 0x7fffffffu) == 0) {
+        // too small to be sent, 0 marks an empty slot
+        compr[j] = 0;
+        continue;
+      }
+      res[i] -= BitsFloat(bits);
+      compr[j] = bits | static_cast<uint32_t>(i);
+    }
+    for (int j = kept; j < k; ++j) {
+      compr[j] = 0;
+    }
+  }
+};
+
+struct dequantize_topk {
+  static void Map(int block, int original_size, float *out, const float *in, const int k) {
+    const int start = block * kTopKBlockSize;
+    const int n = std::min(kTopKBlockSize, original_size - start);
+    const uint32_t *compr = reinterpret_cast<const uint32_t*>(in) + static_cast<size_t>(block) * k;
+    float *o = out + start;
+    std::fill(o, o + n, 0.0f);
+    for (int j = 0; j < k; ++j) {
+      const uint32_t bits = compr[j];
+      const int i = bits & 0xffu;
+      if ((bits & 0x7fffffffu) == 0 || i >= n) continue;
+      o[i] = BitsFloat(bits & ~0xffu);
+    }
+  }
+};
+
+/*!
+ * \brief 1-bit compression. A block of kOneBitBlockSize values of gradient plus residual is
+ *  sent as the mean of their magnitudes followed by one sign bit per value. The difference
+ *  to the sent values stays in the residual.
+ */
+struct quantize_1bit {
+  static void Map(int block, int original_size, float *out, const float *grad,
+                  float *residual) {
+    const int start = block * kOneBitBlockSize;
+    const int n = std::min(kOneBitBlockSize, original_size - start);
+    float *res = residual + start;
+    const float *g = grad + start;
+    float *compr = out + static_cast<size_t>(block) * (1 + kOneBitBlockSize / 32);
+    float sum = 0;
+    for (int i = 0; i < n; ++i) {
+      res[i] += g[i];
+      sum += std::fabs(res[i]);
+    }
+    const float scale = sum / n;
+    compr[0] = scale;
+    uint32_t words[kOneBitBlockSize / 32] = {0};
+    for (int i = 0; i < n; ++i) {
+      const bool pos = res[i] >= 0;
+      words[i >> 5] |= static_cast<uint32_t>(pos) << (i & 31);
+      res[i] -= pos ? scale : -scale;
+    }
+    std::memcpy(compr + 1, words, sizeof(words));
+  }
+};
+
+struct dequantize_1bit {
+  static void Map(int block, int original_size, float *out, const float *in) {
+    const int start = block * kOneBitBlockSize;
+    const int n = std::min(kOneBitBlockSize, original_size - start);
+    const float *compr = in + static_cast<size_t>(block) * (1 + kOneBitBlockSize / 32);
+    const float scale = compr[0];
+    uint32_t words[kOneBitBlockSize / 32];
+    std::memcpy(words, compr + 1, sizeof(words));
+    float *o = out + start;
+    for (int i = 0; i < n; ++i) {
+      o[i] = ((words[i >> 5] >> (i & 31)) & 1) ? scale : -scale;
+    }
+  }
+};
+
+/*!
+ * \brief uniform number in [0, 1) for element i of quantization round seed
+ */
+inline float StochasticUniform(const uint32_t seed, const uint32_t i) {
+  // murmur3 finalizer
+  uint32_t h = seed * 0x9e3779b9u ^ i;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return (h >> 8) * (1.0f / (1 << 24));
+}
+
+/*!
+ * \brief 8-bit stochastic quantization. A block of kEightBitBlockSize values of gradient
+ *  plus residual is sent as its largest magnitude followed by one signed byte per value,
+ *  rounded up or down at random so that the sent value is unbiased. The rounding error
+ *  stays in the residual.
+ */
+struct quantize_8bit {
+  static void Map(int block, int original_size, float *out, const float *grad,
+                  float *residual, const uint32_t seed) {
+    const int start = block * kEightBitBlockSize;
+    const int n = std::min(kEightBitBlockSize, original_size - start);
+    float *res = residual + start;
+    const float *g = grad + start;
+    float *compr = out + static_cast<size_t>(block) * (1 + kEightBitBlockSize / 4);
+    float max_abs = 0;
+    for (int i = 0; i < n; ++i) {
+      res[i] += g[i];
+      max_abs = std::max(max_abs, std::fabs(res[i]));
+    }
+    compr[0] = max_abs;
+    int8_t levels[kEightBitBlockSize] = {0};
+    if (max_abs > 0) {
+      const float to_level = 127.0f / max_abs;
+      const float to_value = max_abs / 127.0f;
+      for (int i = 0; i < n; ++i) {
+        const float level = res[i] * to_level;
+        float q = std::floor(level);
+        if (StochasticUniform(seed, start + i) < level - q) q += 1.0f;
+        q = std::min(127.0f, std::max(-127.0f, q));
+        levels[i] = static_cast<int8_t>(q);
+        res[i] -= q * to_value;
+      }
+    }
+    std::memcpy(compr + 1, levels, sizeof(levels));
+  }
+};
+
+struct dequantize_8bit {
+  static void Map(int block, int original_size, float *out, const float *in) {
+    const int start = block * kEightBitBlockSize;
+    const int n = std::min(kEightBitBlockSize, original_size - start);
+    const float *compr = in + static_cast<size_t>(block) * (1 + kEightBitBlockSize / 4);
+    const float to_value = compr[0] / 127.0f;
+    int8_t levels[kEightBitBlockSize];
+    std::memcpy(levels, compr + 1, sizeof(levels));
+    float *o = out + start;
+    for (int i = 0; i < n; ++i) {
+      o[i] = levels[i] * to_value;
+    }
+  }
+};
+
+inline int NumBlocks(const mxnet::TBlob &original, const int block_size) {
+  return static_cast<int>((original.Size() + block_size - 1) / block_size);
+}
+
+// inputs are {original, residual, compressed} as for Quantize2BitImpl
+inline void QuantizeTopKImpl(mshadow::Stream<mshadow::cpu> *s,
+                             const std::vector<mxnet::TBlob> &inputs, const int k) {
+  mxnet::op::mxnet_op::Kernel<quantize_topk, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[0], kTopKBlockSize), inputs[0].Size(), inputs[2].dptr<float>(),
+      inputs[0].dptr<float>(), inputs[1].dptr<float>(), k);
+}
+
+inline void Quantize1BitImpl(mshadow::Stream<mshadow::cpu> *s,
+                             const std::vector<mxnet::TBlob> &inputs) {
+  mxnet::op::mxnet_op::Kernel<quantize_1bit, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[0], kOneBitBlockSize), inputs[0].Size(), inputs[2].dptr<float>(),
+      inputs[0].dptr<float>(), inputs[1].dptr<float>());
+}
+
+inline void Quantize8BitImpl(mshadow::Stream<mshadow::cpu> *s,
+                             const std::vector<mxnet::TBlob> &inputs, const uint32_t seed) {
+  mxnet::op::mxnet_op::Kernel<quantize_8bit, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[0], kEightBitBlockSize), inputs[0].Size(), inputs[2].dptr<float>(),
+      inputs[0].dptr<float>(), inputs[1].dptr<float>(), seed);
+}
+
+// inputs are {compressed, original} as for Dequantize2BitImpl
+inline void DequantizeTopKImpl(mshadow::Stream<mshadow::cpu> *s,
+                               const std::vector<mxnet::TBlob> &inputs, const int k) {
+  mxnet::op::mxnet_op::Kernel<dequantize_topk, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[1], kTopKBlockSize), inputs[1].Size(), inputs[1].dptr<float>(),
+      inputs[0].dptr<float>(), k);
+}
+
+inline void Dequantize1BitImpl(mshadow::Stream<mshadow::cpu> *s,
+                               const std::vector<mxnet::TBlob> &inputs) {
+  mxnet::op::mxnet_op::Kernel<dequantize_1bit, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[1], kOneBitBlockSize), inputs[1].Size(), inputs[1].dptr<float>(),
+      inputs[0].dptr<float>());
+}
+
+inline void Dequantize8BitImpl(mshadow::Stream<mshadow::cpu> *s,
+                               const std::vector<mxnet::TBlob> &inputs) {
+  mxnet::op::mxnet_op::Kernel<dequantize_8bit, mshadow::cpu>::Launch(
+      s, NumBlocks(inputs[1], kEightBitBlockSize), inputs[1].Size(), inputs[1].dptr<float>(),
+      inputs[0].dptr<float>());
+}
 }  // namespace kvstore
 }  // namespace mxnet
 
@@ -44,6 +44,12 @@ void GradientCompression::SetParams(const std::vector<std::pair<std::string, std
   CHECK_GT(params.threshold, 0) << "threshold must be greater than 0";
   if (params.type == "2bit") {
     SetTwoBitCompression(params.threshold);
+  } else if (params.type == "topk") {
+    SetTopKCompression(params.k);
+  } else if (params.type == "1bit") {
+    type_ = CompressionType::kOneBit;
+  } else if (params.type == "8bit") {
+    type_ = CompressionType::kEightBit;
   } else {
     LOG(FATAL) << "Unknown type for gradient compression " << params.type;
   }
@@ -62,11 +68,19 @@ void GradientCompression::SetTwoBitCompression(const float threshold) {
   threshold_ = threshold;
 }
 
+void GradientCompression::SetTopKCompression(const int k) {
+  CHECK(k >= 1 && k <= kTopKBlockSize) << "k must be in [1, " << kTopKBlockSize << "]";
+  type_ = CompressionType::kTopK;
+  k_ = k;
+}
+
 std::string GradientCompression::EncodeParams() {
   using namespace std;  // to reduce length of next line
   string rval = get_type_str();
   if (type_ == CompressionType::kTwoBit) {
     rval += "," + to_string(threshold_);
+  } else if (type_ == CompressionType::kTopK) {
+    rval += ",," + to_string(k_);
   }
   return rval;
 }
@@ -80,22 +94,48 @@ void GradientCompression::DecodeParams(const std::string &s) {
       threshold_ = stof(elems[1]);
     }
   }
+  if (elems.size() > 2) {
+    k_ = stoi(elems[2]);
+  }
 }
 
-int GradientCompression::GetCompressionFactor() {
-  if (type_ == CompressionType::kTwoBit) {
-    return 16;
-  } else {
-    LOG(FATAL) << "Unsupported compression type: " << get_type_str();
-    return 0;
+int64_t GradientCompression::GetBlockSize() {
+  switch (type_) {
+    case CompressionType::kTwoBit:
+      return 16;
+    case CompressionType::kTopK:
+      return kTopKBlockSize;
+    case CompressionType::kOneBit:
+      return kOneBitBlockSize;
+    case CompressionType::kEightBit:
+      return kEightBitBlockSize;
+    default:
+      LOG(FATAL) << "Unsupported compression type: " << get_type_str();
+      return 0;
+  }
+}
+
+int64_t GradientCompression::GetCompressedBlockSize() {
+  switch (type_) {
+    case CompressionType::kTwoBit:
+      return 1;
+    case CompressionType::kTopK:
+      return k_;
+    case CompressionType::kOneBit:
+      // scale and one bit per value
+      return 1 + kOneBitBlockSize / 32;
+    case CompressionType::kEightBit:
+      // scale and one byte per value
+      return 1 + kEightBitBlockSize / 4;
+    default:
+      LOG(FATAL) << "Unsupported compression type: " << get_type_str();
+      return 0;
   }
 }
 
 int64_t GradientCompression::GetCompressedSize(const int64_t original_size) {
-  const int bits = GetCompressionFactor();
-  return ((original_size % bits == 0) ?
-          original_size / bits :
-          original_size / bits + 1);
+  const int64_t block_size = GetBlockSize();
+  return (original_size + block_size - 1) / block_size * GetCompressedBlockSize();
 }
 
 void GradientCompression::Quantize(const mxnet::NDArray &from, mxnet::NDArray *to,
@@ -130,6 +170,24 @@ void GradientCompression::Quantize(const mxnet::NDArray &from, mxnet::NDArray *t
     LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
 #endif
     }
+  } else if (type_ != CompressionType::kNone) {
+    CHECK(a == mshadow::cpu::kDevMask && b == mshadow::cpu::kDevMask)
+      << "Gradient compression of type " << get_type_str() << " is only implemented for CPU";
+    const CompressionType type = type_;
+    const int k = k_;
+    const uint32_t seed = seed_++;
+    mxnet::Engine::Get()->PushSync([from, to, residual, type, k, seed](mxnet::RunContext ctx) {
+      std::vector<mxnet::TBlob> inputs = {from.data(), residual->data(), to->data()};
+      mshadow::Stream<mshadow::cpu> *s = ctx.get_stream<mshadow::cpu>();
+      if (type == CompressionType::kTopK) {
+        QuantizeTopKImpl(s, inputs, k);
+      } else if (type == CompressionType::kOneBit) {
+        Quantize1BitImpl(s, inputs);
+      } else {
+        Quantize8BitImpl(s, inputs, seed);
+      }
+    }, from.ctx(), {from.var()}, {to->var(), residual->var()},
+    mxnet::FnProperty::kNormal, priority, "QuantizeCPU");
   } else {
     LOG(FATAL) << "Unsupported quantization of type " << get_type_str();
   }
@@ -166,6 +224,23 @@ void GradientCompression::Dequantize(const mxnet::NDArray &from, mxnet::NDArray
       LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
 #endif
     }
+  } else if (type_ != CompressionType::kNone) {
+    CHECK(a == mshadow::cpu::kDevMask && b == mshadow::cpu::kDevMask)
+      << "Gradient compression of type " << get_type_str() << " is only implemented for CPU";
+    const CompressionType type = type_;
+    const int k = k_;
+    mxnet::Engine::Get()->PushSync([from, to, type, k](mxnet::RunContext ctx) {
+      std::vector<mxnet::TBlob> inputs = {from.data(), to->data()};
+      mshadow::Stream<mshadow::cpu> *s = ctx.get_stream<mshadow::cpu>();
+      if (type == CompressionType::kTopK) {
+        DequantizeTopKImpl(s, inputs, k);
+      } else if (type == CompressionType::kOneBit) {
+        Dequantize1BitImpl(s, inputs);
+      } else {
+        Dequantize8BitImpl(s, inputs);
+      }
+    }, from.ctx(), {from.var()}, {to->var()},
+    mxnet::FnProperty::kNormal, priority, "DequantizeCPU");
   } else {
     LOG(FATAL) << "Unsupported dequantization of type " << get_type_str();
   }
@@ -26,6 +26,7 @@
 #ifndef MXNET_KVSTORE_GRADIENT_COMPRESSION_H_
 #define MXNET_KVSTORE_GRADIENT_COMPRESSION_H_
 #include <dmlc/parameter.h>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -34,18 +35,23 @@
 namespace mxnet {
 namespace kvstore {
 
+// values are sent to the servers, append new types at the end
 enum class CompressionType {
-  kNone, kTwoBit
+  kNone, kTwoBit, kTopK, kOneBit, kEightBit
 };
 
 struct GradientCompressionParam : public dmlc::Parameter<GradientCompressionParam> {
   std::string type;
   float threshold;
+  int k;
   DMLC_DECLARE_PARAMETER(GradientCompressionParam) {
     DMLC_DECLARE_FIELD(type)
-      .describe("Type of gradient compression to use, like `2bit` for example");
+      .describe("Type of gradient compression to use, one of `2bit`, `1bit`, `8bit` "
+                "and `topk`");
     DMLC_DECLARE_FIELD(threshold).set_default(0.5)
       .describe("Threshold to use for 2bit gradient compression");
+    DMLC_DECLARE_FIELD(k).set_default(8)
+      .describe("Number of values sent of every 256 by topk gradient compression");
   }
 };
 
@@ -78,6 +84,12 @@ class GradientCompression {
    */
   void SetTwoBitCompression(const float threshold);
 
+  /*!
+   * \brief sets top-k sparsification
+   * \param k number of values sent of every block of 256, in [1, 256]
+   */
+  void SetTopKCompression(const int k);
+
   /*!
    * \brief encodes parameters of gc into a string
    */
@@ -89,10 +101,15 @@ class GradientCompression {
   void DecodeParams(const std::string &s);
 
   /*!
-   * \brief returns compression factor, which is the factor by which size of gradient
-   * reduces when using a particular type of compression
+   * \brief returns the number of original values compressed together. A gradient array
+   * can only be split for different servers at multiples of this size
+   */
+  int64_t GetBlockSize();
+
+  /*!
+   * \brief returns the number of floats one block of values is compressed into
    */
-  int GetCompressionFactor();
+  int64_t GetCompressedBlockSize();
 
   /*!
    * \brief returns the size of compressed gradients given an original sized gradient array
@@ -102,7 +119,8 @@ class GradientCompression {
   /*!
   * \brief Issues quantize operation to be scheduled by the engine
   * Compresses `from` into `to` and accumulates the quantization error
-  * into 'residual', using the quantization of type `type_`
+  * into 'residual', using the quantization of type `type_`.
+  * Types other than 2bit are only implemented for CPU arrays.
   * \param from the ndarray containing original data to be quantized
   * \param to the target ndarray which contains quantized data
   * \param residual the ndarray which accumulates quantization error
@@ -132,6 +150,16 @@ class GradientCompression {
    * all negative gradients will be thresholded to -1*`threshold_`
    */
   float threshold_ = 0;
+
+  /*!
+   * \brief number of values sent of every block of 256 with top-k sparsification
+   */
+  int k_ = 0;
+
+  /*!
+   * \brief distinguishes the random rounding of successive 8-bit quantizations
+   */
+  std::atomic<uint32_t> seed_{0};
 };
 }  // namespace kvstore
 }  // namespace mxnet
@@ -24,7 +24,11 @@
  */
 #ifndef MXNET_KVSTORE_KVSTORE_DIST_H_
 #define MXNET_KVSTORE_KVSTORE_DIST_H_
+#include <cstring>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <algorithm>
 #include <utility>
@@ -56,10 +60,12 @@ class KVStoreDist : public KVStoreLocal {
       }
     }
     bigarray_bound_ = dmlc::GetEnv("MXNET_KVSTORE_BIGARRAY_BOUND", 1000 * 1000);
+    fused_bucket_bytes_ = dmlc::GetEnv("MXNET_KVSTORE_DIST_FUSED_BUCKET_BYTES", 0);
     log_verbose_ = dmlc::GetEnv("MXNET_KVSTORE_DIST_ROW_SPARSE_VERBOSE", false);
   }
 
   virtual ~KVStoreDist() {
+    if (IsWorkerNode()) FlushFusedPushes(0);
     Engine::Get()->WaitForAll();
     customer_id_ = 0;
     if (IsWorkerNode()) {
@@ -103,6 +109,7 @@ class KVStoreDist : public KVStoreLocal {
 
 
   void Barrier() override {
+    FlushFusedPushes(0);
     ps::Postoffice::Get()->Barrier(ps_worker_->get_customer()->customer_id(), ps::kWorkerGroup);
   }
 
@@ -187,6 +194,38 @@ class KVStoreDist : public KVStoreLocal {
    */
   std::mutex mu_;
 
+  /**
+   * \brief pushes of small keys waiting to be sent together in one request
+   */
+  struct FusedBucket {
+    std::vector<int> keys;
+    std::vector<ps::Key> ps_keys;
+    std::vector<int> lens;
+    std::vector<NDArray> bufs;
+    size_t bytes = 0;
+  };
+  /**
+   * \brief open bucket of each dtype
+   */
+  std::unordered_map<int, FusedBucket> fused_push_;
+  /**
+   * \brief keys in the open buckets
+   */
+  std::unordered_set<int> fused_pending_keys_;
+  /**
+   * \brief keys of the bucket each key was last sent in, they are pulled together
+   */
+  std::unordered_map<int, std::shared_ptr<std::vector<int>>> fused_keys_;
+  /**
+   * \brief keys whose value was pulled along with another key of their bucket and has
+   * not been used yet. Each prefetched value serves one pull, and a push drops it.
+   */
+  std::unordered_set<int> fused_prefetched_;
+  /**
+   * \brief receive buffers of fused pulls
+   */
+  std::unordered_map<int, NDArray> fused_recv_buf_;
+
   void InitImpl(const std::vector<int>& keys,
                 const std::vector<NDArray>& values) override {
     CheckUnique(keys);
@@ -224,6 +263,7 @@ class KVStoreDist : public KVStoreLocal {
 
     for (size_t i = 0; i < uniq_keys.size(); ++i) {
       int key = uniq_keys[i];
+      if (fused_pending_keys_.count(key)) FlushFusedPushes(priority);
       // use the same array for merging to guarantee that pull always happens
       // after the previous push on this key
       auto& recv_buf = comm_buf_[key];
@@ -235,6 +275,14 @@ class KVStoreDist : public KVStoreLocal {
         recv_buf = NDArray(grouped_vals[i][0]->shape(), pinned_ctx_,
                            true, grouped_vals[i][0]->dtype());
       }
+      if (fused_bucket_bytes_ > 0 && fused_keys_.count(key) &&
+          gradient_compression_->get_type() == CompressionType::kNone) {
+        if (!fused_prefetched_.count(key)) PullFused(*fused_keys_[key], priority);
+        // the prefetched value is current for this pull only, later pulls fetch again
+        fused_prefetched_.erase(key);
+        comm_->Broadcast(key, fused_recv_buf_[key], grouped_vals[i], priority);
+        continue;
+      }
       auto pull_from_servers = [this, key, recv_buf](
           RunContext rctx, Engine::CallbackOnComplete cb) {
         // convert to ps keys
@@ -321,6 +369,10 @@ class KVStoreDist : public KVStoreLocal {
       // merge over devices
       int key = uniq_keys[i];
       const auto& vals = grouped_vals[i];
+      // a bucket still holding the previous push of this key has to be sent before the
+      // buffers are overwritten
+      if (fused_pending_keys_.count(key)) FlushFusedPushes(priority);
+      fused_prefetched_.erase(key);
       NDArray merged = do_merge ? comm_->Reduce(key, vals, priority) : vals[0];
 
       const auto storage_type = merged.storage_type();
@@ -347,7 +399,12 @@ class KVStoreDist : public KVStoreLocal {
       if (storage_type == kDefaultStorage) {
         if (gradient_compression_->get_type() == CompressionType::kNone) {
           PSKV& pskv = EncodeDefaultKey(key, comm_buf.shape().Size(), num_bytes);
-          PushDefault(key, comm_buf, pskv, priority);
+          if (do_merge && fused_bucket_bytes_ > 0 && pskv.keys.size() == 1) {
+            AddFusedPush(key, comm_buf, pskv, priority);
+          } else {
+            fused_keys_.erase(key);
+            PushDefault(key, comm_buf, pskv, priority);
+          }
         } else {
           CHECK_EQ(dtype, mshadow::kFloat32) << "Gradient compression is only supported for "
                                              << "float32 type of parameters";
@@ -433,6 +490,123 @@ class KVStoreDist : public KVStoreLocal {
         "KVStoreDistDefaultPush");
   }
 
+  // queue the push of a small key into the bucket of its dtype
+  void AddFusedPush(int key, const NDArray& send_buf, const PSKV& pskv, int priority) {
+    FusedBucket& bucket = fused_push_[send_buf.dtype()];
+    bucket.keys.push_back(key);
+    bucket.ps_keys.push_back(pskv.keys[0]);
+    bucket.lens.push_back(pskv.lens[0]);
+    bucket.bufs.push_back(send_buf);
+    bucket.bytes += pskv.lens[0];
+    fused_pending_keys_.insert(key);
+    if (bucket.bytes >= fused_bucket_bytes_) FlushFusedPushes(priority);
+  }
+
+  // send every non-empty bucket as one push request
+  void FlushFusedPushes(int priority) {
+    if (fused_pending_keys_.empty()) return;
+    for (auto& entry : fused_push_) {
+      const int dtype = entry.first;
+      FusedBucket& bucket = entry.second;
+      if (bucket.keys.empty()) continue;
+      // ps-lite expects the keys of a request in increasing order
+      std::vector<size_t> order(bucket.keys.size());
+      for (size_t j = 0; j < order.size(); ++j) order[j] = j;
+      std::sort(order.begin(), order.end(), [&bucket](size_t a, size_t b) {
+        return bucket.ps_keys[a] < bucket.ps_keys[b];
+      });
+      ps::SArray<ps::Key> keys;
+      ps::SArray<int> lens;
+      std::vector<NDArray> bufs;
+      std::vector<Engine::VarHandle> const_vars;
+      auto members = std::make_shared<std::vector<int>>();
+      for (size_t j : order) {
+        keys.push_back(bucket.ps_keys[j]);
+        lens.push_back(bucket.lens[j]);
+        bufs.push_back(bucket.bufs[j]);
+        const_vars.push_back(bucket.bufs[j].var());
+        members->push_back(bucket.keys[j]);
+        fused_keys_[bucket.keys[j]] = members;
+      }
+      const size_t total_bytes = bucket.bytes;
+      auto push_to_servers = [this, dtype, keys, lens, bufs, total_bytes](
+          RunContext rctx, Engine::CallbackOnComplete cb) {
+        ps::SArray<char> vals(total_bytes);
+        size_t offset = 0;
+        for (size_t j = 0; j < bufs.size(); ++j) {
+          std::memcpy(vals.data() + offset, bufs[j].data().dptr_, lens[j]);
+          offset += lens[j];
+        }
+        const int cmd = GetCommandType(RequestType::kFusedPushPull, dtype);
+        CHECK_NOTNULL(ps_worker_)->ZPush(keys, vals, lens, cmd, [cb]() { cb(); });
+      };
+      Engine::Get()->PushAsync(
+          push_to_servers,
+          pinned_ctx_,
+          const_vars,
+          {},
+          FnProperty::kNormal,
+          priority,
+          "KVStoreDistFusedPush");
+      bucket = FusedBucket();
+    }
+    fused_pending_keys_.clear();
+  }
+
+  // Pull all keys last pushed in one bucket with one request. The values go to
+  // fused_recv_buf_, and the next pull of each of the other keys is served from there
+  // unless the key is pushed first.
+  void PullFused(const std::vector<int>& members, int priority) {
+    // the pull has to be issued after the pushes of these keys
+    FlushFusedPushes(priority);
+    ps::SArray<ps::Key> keys;
+    std::vector<NDArray> recv_bufs;
+    std::vector<Engine::VarHandle> mutable_vars;
+    size_t total_bytes = 0;
+    int dtype = -1;
+    for (int key : members) {
+      const NDArray& comm_buf = comm_buf_[key];
+      NDArray& recv_buf = fused_recv_buf_[key];
+      if (recv_buf.is_none()) {
+        recv_buf = NDArray(comm_buf.shape(), pinned_ctx_, false, comm_buf.dtype());
+      }
+      const PSKV& pskv = EncodeDefaultKey(key, recv_buf.shape().Size(),
+                                          mshadow::mshadow_sizeof(recv_buf.dtype()));
+      keys.push_back(pskv.keys[0]);
+      total_bytes += pskv.size;
+      dtype = recv_buf.dtype();
+      recv_bufs.push_back(recv_buf);
+      // as for unfused pulls, mutating comm_buf orders the pull after the previous push
+      mutable_vars.push_back(comm_buf.var());
+      mutable_vars.push_back(recv_buf.var());
+      fused_prefetched_.insert(key);
+    }
+    auto pull_from_servers = [this, keys, recv_bufs, dtype, total_bytes](
+        RunContext rctx, Engine::CallbackOnComplete cb) {
+      auto vals = new ps::SArray<char>(total_bytes);
+      auto lens = new ps::SArray<int>();
+      const int cmd = GetCommandType(RequestType::kFusedPushPull, dtype);
+      CHECK_NOTNULL(ps_worker_)->ZPull(keys, vals, lens, cmd, [vals, lens, recv_bufs, cb]() {
+        size_t offset = 0;
+        for (size_t j = 0; j < recv_bufs.size(); ++j) {
+          std::memcpy(recv_bufs[j].data().dptr_, vals->data() + offset, (*lens)[j]);
+          offset += (*lens)[j];
+        }
+        delete vals;
+        delete lens;
+        cb();
+      });
+    };
+    CHECK_NOTNULL(Engine::Get())->PushAsync(
+        pull_from_servers,
+        pinned_ctx_,
+        {},
+        mutable_vars,
+        FnProperty::kNormal,
+        priority,
+        "KVStoreDistFusedPull");
+  }
+
   // push row sparse gradient
   void PushRowSparse(int key, const NDArray &send_buf, int priority) {
     using namespace rowsparse;
@@ -627,9 +801,12 @@ class KVStoreDist : public KVStoreLocal {
         push_pskv.size = compr_size;
         pull_pskv.size = original_size;
       } else {
-        // partition it to all servers
+        // partition it to all servers, at boundaries of compressed blocks
         push_pskv.size = 0;
         pull_pskv.size = 0;
+        const size_t block_orig = gradient_compression_->GetBlockSize();
+        const size_t block_compr = gradient_compression_->GetCompressedBlockSize();
+        const size_t num_blocks = compr_num_elem / block_compr;
 
         for (int i = 0; i < num_servers; ++i) {
           size_t part_compr, part_orig;
@@ -637,10 +814,11 @@ class KVStoreDist : public KVStoreLocal {
             part_compr = compr_num_elem - push_pskv.size;
             part_orig = original_num_elem - pull_pskv.size;
           } else {
-            part_compr =
-              static_cast<size_t> (round(static_cast<double>(compr_num_elem)/num_servers*(i+1))) -
-              static_cast<size_t> (round(static_cast<double>(compr_num_elem)/num_servers*(i)));
-            part_orig = part_compr * gradient_compression_->GetCompressionFactor();
+            const size_t part_blocks =
+              static_cast<size_t> (round(static_cast<double>(num_blocks)/num_servers*(i+1))) -
+              static_cast<size_t> (round(static_cast<double>(num_blocks)/num_servers*(i)));
+            part_compr = part_blocks * block_compr;
+            part_orig = part_blocks * block_orig;
           }
 
           // meta info
@@ -744,6 +922,10 @@ class KVStoreDist : public KVStoreLocal {
    * \brief threshold for partition
    */
   size_t bigarray_bound_;
+  /**
+   * \brief size at which a bucket of fused small pushes is sent, 0 to disable fusion
+   */
+  size_t fused_bucket_bytes_;
   /**
    * \brief buffer for non-compressed data.
    * When gradient compression is active, this is used
@@ -30,10 +30,15 @@
 #include <queue>
 #include <string>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <functional>
 #include <future>
+#include <map>
+#include <thread>
+#include <tuple>
 #include <vector>
 #include "../profiler/profiler.h"
 #include "../operator/tensor/elemwise_binary_op-inl.h"
@@ -49,7 +54,7 @@ enum class CommandType {
 };
 
 enum class RequestType {
-  kDefaultPushPull, kRowSparsePushPull, kCompressedPushPull
+  kDefaultPushPull, kRowSparsePushPull, kCompressedPushPull, kFusedPushPull
 };
 
 struct DataHandleType {
@@ -152,6 +157,96 @@ class Executor {
   std::condition_variable cond_;
 };
 
+/**
+ * \brief runs functions asynchronously on a fixed number of threads. Each function is
+ * bound to a shard, and the functions of one shard run one after another in the order
+ * they were added.
+ */
+class ShardedExecutor {
+ public:
+  typedef std::function<void()> Func;
+
+  explicit ShardedExecutor(size_t num_shards) {
+    CHECK_GT(num_shards, 0);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(new Shard());
+    }
+    for (auto& shard : shards_) {
+      threads_.emplace_back(&ShardedExecutor::Run, this, shard.get());
+    }
+  }
+
+  /**
+   * \brief finish all queued functions and join the threads
+   */
+  ~ShardedExecutor() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lk(shard->mu);
+      shard->stop = true;
+      shard->cond.notify_one();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  size_t num_shards() const {
+    return shards_.size();
+  }
+
+  /**
+   * \brief queue a function on a shard and return without waiting for it. threadsafe
+   */
+  void Exec(size_t shard, Func func) {
+    {
+      std::lock_guard<std::mutex> lk(idle_mu_);
+      ++num_pending_;
+    }
+    Shard* s = shards_[shard % shards_.size()].get();
+    std::lock_guard<std::mutex> lk(s->mu);
+    s->queue.push(std::move(func));
+    s->cond.notify_one();
+  }
+
+  /**
+   * \brief block until all queued functions are done. threadsafe
+   */
+  void WaitAll() {
+    std::unique_lock<std::mutex> lk(idle_mu_);
+    idle_cond_.wait(lk, [this]{ return num_pending_ == 0; });
+  }
+
+ private:
+  struct Shard {
+    std::queue<Func> queue;
+    std::mutex mu;
+    std::condition_variable cond;
+    bool stop = false;
+  };
+
+  void Run(Shard* shard) {
+    while (true) {
+      Func func;
+      {
+        std::unique_lock<std::mutex> lk(shard->mu);
+        shard->cond.wait(lk, [shard]{ return shard->stop || !shard->queue.empty(); });
+        if (shard->queue.empty()) return;
+        func = std::move(shard->queue.front());
+        shard->queue.pop();
+      }
+      func();
+      std::lock_guard<std::mutex> lk(idle_mu_);
+      if (--num_pending_ == 0) idle_cond_.notify_all();
+    }
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<std::thread> threads_;
+  size_t num_pending_ = 0;
+  std::mutex idle_mu_;
+  std::condition_variable idle_cond_;
+};
+
 class KVStoreDistServer {
  public:
   KVStoreDistServer() {
@@ -164,10 +259,16 @@ class KVStoreDistServer {
     sync_mode_ = false;
     gradient_compression_ = std::make_shared<GradientCompression>();
     log_verbose_ = dmlc::GetEnv("MXNET_KVSTORE_DIST_ROW_SPARSE_VERBOSE", false);
+    const int num_threads = dmlc::GetEnv("MXNET_KVSTORE_SERVER_THREADS", 1);
+    if (num_threads > 1) {
+      shards_.reset(new ShardedExecutor(num_threads));
+    }
   }
 
   ~KVStoreDistServer() {
     profiler::Profiler::Get()->SetState(profiler::Profiler::ProfilerState(0));
+    // workers have finalized before the server is stopped, nothing is queued anymore
+    shards_.reset();
     delete ps_server_;
   }
 
@@ -198,6 +299,8 @@ class KVStoreDistServer {
 
   void CommandHandle(const ps::SimpleData& recved, ps::SimpleApp* app) {
     CommandType recved_type = static_cast<CommandType>(recved.head);
+    // commands change the state the data handlers read, let queued requests finish first
+    if (shards_) shards_->WaitAll();
     switch (recved_type) {
       case CommandType::kStopServer:
         exec_.Stop();
@@ -243,7 +346,7 @@ class KVStoreDistServer {
       const int key = stored_entry.first;
       const NDArray &stored = stored_entry.second;
       if (stored.dtype() != mshadow::kFloat32) {
-        auto &stored_realt = store_realt_[key];
+        auto &stored_realt = Entry(&store_realt_, key);
         if (stored.storage_type() == kRowSparseStorage) {
           stored_realt = NDArray(kRowSparseStorage, stored.shape(), stored.ctx(),
                                  true, mshadow::kFloat32);
@@ -251,7 +354,7 @@ class KVStoreDistServer {
           stored_realt = NDArray(stored.shape(), stored.ctx(), false, mshadow::kFloat32);
         }
 
-        auto &update = update_buf_[key];
+        auto &update = Entry(&update_buf_, key);
         if (!update.merged.is_none()) {
           if (update.merged.storage_type() == kRowSparseStorage) {
             update.merged = NDArray(kRowSparseStorage, update.merged.shape(), update.merged.ctx(),
@@ -325,6 +428,57 @@ class KVStoreDistServer {
   void DataHandleEx(const ps::KVMeta& req_meta,
                     const ps::KVPairs<char>& req_data,
                     ps::KVServer<char>* server) {
+    if (!shards_) {
+      DataHandle(req_meta, req_data, server);
+      return;
+    }
+    // Requests on a key are handled by the thread of its shard in the order they arrived,
+    // requests on different shards in parallel. The copies share the received buffers.
+    DataHandleType type = DepairDataHandleType(req_meta.cmd);
+    if (type.requestType == RequestType::kFusedPushPull && req_meta.push) {
+      CHECK_EQ(req_data.lens.size(), req_data.keys.size());
+      SetFusedPending(req_meta, req_data.keys.size());
+      size_t offset = 0;
+      for (size_t i = 0; i < req_data.keys.size(); ++i) {
+        const int key = DecodeKey(req_data.keys[i]);
+        const int len = req_data.lens[i];
+        ps::SArray<char> vals = req_data.vals;
+        shards_->Exec(key, [this, type, key, vals, offset, len, req_meta, server]() {
+          DefaultStoragePush(type, key, vals.data() + offset, len, req_meta, server);
+        });
+        offset += len;
+      }
+      CHECK_EQ(offset, req_data.vals.size());
+      return;
+    }
+    if (type.requestType == RequestType::kFusedPushPull) {
+      // Each key is read by the thread of its shard, after the requests queued on it before.
+      // The thread reading the last key answers with all of them.
+      auto parts = std::make_shared<std::vector<ps::SArray<char>>>(req_data.keys.size());
+      auto remaining = std::make_shared<std::atomic<size_t>>(req_data.keys.size());
+      for (size_t i = 0; i < req_data.keys.size(); ++i) {
+        const int key = DecodeKey(req_data.keys[i]);
+        shards_->Exec(key, [this, type, key, i, parts, remaining, req_meta, req_data, server]() {
+          (*parts)[i] = StoredValue(type, key);
+          if (remaining->fetch_sub(1) == 1) {
+            FusedPullResponse(req_meta, req_data.keys, *parts, server);
+          }
+        });
+      }
+      return;
+    }
+    // the first key of a compressed push is the original size
+    const bool size_first = type.requestType == RequestType::kCompressedPushPull &&
+                            req_meta.push;
+    const int key = DecodeKey(req_data.keys[size_first ? 1 : 0]);
+    shards_->Exec(key, [this, req_meta, req_data, server]() {
+      DataHandle(req_meta, req_data, server);
+    });
+  }
+
+  void DataHandle(const ps::KVMeta& req_meta,
+                  const ps::KVPairs<char>& req_data,
+                  ps::KVServer<char>* server) {
     DataHandleType type = DepairDataHandleType(req_meta.cmd);
     switch (type.requestType) {
       case RequestType::kRowSparsePushPull:
@@ -336,6 +490,9 @@ class KVStoreDistServer {
       case RequestType::kDefaultPushPull:
         DataHandleDefault(type, req_meta, req_data, server);
         break;
+      case RequestType::kFusedPushPull:
+        DataHandleFused(type, req_meta, req_data, server);
+        break;
     }
   }
 
@@ -347,7 +504,8 @@ class KVStoreDistServer {
                            UpdateBuf *update_buf, ps::KVServer<char>* server) {
     if (!sync_mode_ || update_buf->request.size() == (size_t) ps::NumWorkers()) {
       // let the main thread to execute updater_, which is necessary for python
-      auto& stored = has_multi_precision_copy(type) ? store_realt_[key] : store_[key];
+      auto& stored = has_multi_precision_copy(type) ? Entry(&store_realt_, key)
+                                                    : Entry(&store_, key);
       auto& update =  sync_mode_ ? update_buf->merged : update_buf->temp_array;
       if (updater_) {
         exec_.Exec([this, key, &update, &stored](){
@@ -360,14 +518,15 @@ class KVStoreDistServer {
         CopyFromTo(update_buf->merged, &stored);
       }
 
+      // answer once the value served to pulls is updated, a worker may pull right away
+      if (has_multi_precision_copy(type)) CopyFromTo(stored, Entry(&store_, key));
       if (log_verbose_)  {
         LOG(INFO) << "sent response to " << update_buf->request.size() << " workers";
       }
       for (const auto& req : update_buf->request) {
-        server->Response(req);
+        Respond(req, server);
       }
       update_buf->request.clear();
-      if (has_multi_precision_copy(type)) CopyFromTo(stored, store_[key]);
       stored.WaitToRead();
     } else {
       update_buf->merged.WaitToRead();
@@ -419,7 +578,7 @@ class KVStoreDistServer {
       server->Response(req_meta, response);
       return;
     }
-    const NDArray& stored = store_[master_key];
+    const NDArray& stored = Entry(&store_, master_key);
     if (has_multi_precision_copy(type)) stored.WaitToRead();
     CHECK(!stored.is_none()) << "init " << master_key << " first";
     auto shape = stored.shape();
@@ -453,7 +612,8 @@ class KVStoreDistServer {
                            const ps::KVMeta& req_meta,
                            const ps::KVPairs<char>& req_data,
                            ps::KVServer<char>* server) {
-    auto& stored = has_multi_precision_copy(type) ? store_realt_[master_key] : store_[master_key];
+    auto& stored = has_multi_precision_copy(type) ? Entry(&store_realt_, master_key)
+                                                  : Entry(&store_, master_key);
     int dtype = type.dtype;
     int num_bytes = mshadow::mshadow_sizeof(dtype);
     auto unit_len = req_data.lens[1] / num_bytes;
@@ -469,7 +629,8 @@ class KVStoreDistServer {
     stored = NDArray(kRowSparseStorage, dshape, Context(), true,
                      has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
     if (has_multi_precision_copy(type)) {
-      store_[master_key] = NDArray(kRowSparseStorage, dshape, Context(), true, type.dtype);
+      Entry(&store_, master_key) = NDArray(kRowSparseStorage, dshape, Context(), true,
+                                           type.dtype);
     }
     Engine::Get()->PushAsync(
     [this, recved, stored, type](RunContext ctx, Engine::CallbackOnComplete on_complete) {
@@ -489,8 +650,9 @@ class KVStoreDistServer {
     }, recved.ctx(), {recved.var()}, {stored.var()},
     FnProperty::kNormal, 0, PROFILER_MESSAGE_FUNCNAME);
     if (has_multi_precision_copy(type)) {
-      CopyFromTo(stored, store_[master_key]);
-      store_[master_key].WaitToRead();
+      auto& stored_dtype = Entry(&store_, master_key);
+      CopyFromTo(stored, stored_dtype);
+      stored_dtype.WaitToRead();
     }
     stored.WaitToRead();
     server->Response(req_meta);
@@ -501,7 +663,7 @@ class KVStoreDistServer {
                            ps::KVServer<char>* server) {
     int master_key = DecodeKey(req_data.keys[0]);
     auto num_rows = req_data.keys.size() - 1;
-    auto& stored = store_[master_key];
+    auto& stored = Entry(&store_, master_key);
     if (req_meta.push) {
       CHECK_GT(req_data.lens.size(), 0) << "req_data.lens cannot be empty";
       CHECK_EQ(req_data.lens[0], 0);
@@ -513,7 +675,7 @@ class KVStoreDistServer {
         return;
       } else {
         if (log_verbose_) LOG(INFO) << "push: " << master_key << " " << req_data.keys;
-        auto& updates = update_buf_[master_key];
+        auto& updates = Entry(&update_buf_, master_key);
         if (sync_mode_ && updates.merged.is_none()) {
           updates.merged = NDArray(kRowSparseStorage, stored.shape(), Context(), true,
                                    has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
@@ -585,7 +747,7 @@ class KVStoreDistServer {
                               const ps::KVPairs<char> &req_data,
                               ps::KVServer<char>* server) {
     ps::KVPairs<char> response;
-    const NDArray& stored = store_[key];
+    const NDArray& stored = Entry(&store_, key);
     CHECK(!stored.is_none()) << "init " << key << " first";
 
     // as server returns when store_realt is ready in this case
@@ -617,14 +779,14 @@ class KVStoreDistServer {
 
       int original_size = DecodeKey(req_data.keys[0]);
       int key = DecodeKey(req_data.keys[1]);
-      auto& stored = store_[key];
+      auto& stored = Entry(&store_, key);
 
       size_t ds[] = {(size_t)req_data.lens[1] / mshadow::mshadow_sizeof(type.dtype)};
       TShape dshape(ds, ds + 1);
       TBlob recv_blob(reinterpret_cast<real_t*>(req_data.vals.data()), dshape, cpu::kDevMask);
       NDArray recved = NDArray(recv_blob, 0);
 
-      NDArray decomp_buf = decomp_buf_[key];
+      NDArray decomp_buf = Entry(&decomp_buf_, key);
       dshape = TShape{(int64_t) original_size};
 
       if (decomp_buf.is_none()) {
@@ -638,7 +800,7 @@ class KVStoreDistServer {
         stored.WaitToRead();
       } else if (sync_mode_) {
         // synced push
-        auto& merged = update_buf_[key];
+        auto& merged = Entry(&update_buf_, key);
         if (merged.merged.is_none()) {
           merged.merged = NDArray(dshape, Context());
         }
@@ -678,67 +840,178 @@ class KVStoreDistServer {
       CHECK_EQ(req_data.vals.size(), (size_t)req_data.lens[0]);
     }
     int key = DecodeKey(req_data.keys[0]);
-    auto& stored = has_multi_precision_copy(type) ? store_realt_[key] : store_[key];
+    if (req_meta.push) {
+      DefaultStoragePush(type, key, req_data.vals.data(), req_data.lens[0], req_meta, server);
+    } else {
+      DefaultStorageResponse(type, key, req_meta, req_data, server);
+    }
+  }
+
+  /**
+   * \brief Push or pull of several small dense keys packed into one request by a worker.
+   *  Every key is handled as if it was pushed alone. The push is answered when all of its
+   *  keys are done, the pull with the values of all keys concatenated.
+   */
+  void DataHandleFused(const DataHandleType type, const ps::KVMeta& req_meta,
+                       const ps::KVPairs<char> &req_data,
+                       ps::KVServer<char>* server) {
+    if (req_meta.push) {
+      CHECK_EQ(req_data.lens.size(), req_data.keys.size());
+      SetFusedPending(req_meta, req_data.keys.size());
+      size_t offset = 0;
+      for (size_t i = 0; i < req_data.keys.size(); ++i) {
+        DefaultStoragePush(type, DecodeKey(req_data.keys[i]), req_data.vals.data() + offset,
+                           req_data.lens[i], req_meta, server);
+        offset += req_data.lens[i];
+      }
+      CHECK_EQ(offset, req_data.vals.size());
+    } else {
+      std::vector<ps::SArray<char>> parts;
+      for (const ps::Key ps_key : req_data.keys) {
+        parts.push_back(StoredValue(type, DecodeKey(ps_key)));
+      }
+      FusedPullResponse(req_meta, req_data.keys, parts, server);
+    }
+  }
+
+  /**
+   * \brief copy of the value of a key as served to pulls. With server threads, only
+   *  call it from the thread of the key's shard.
+   */
+  ps::SArray<char> StoredValue(const DataHandleType type, const int key) {
+    const NDArray& stored = Entry(&store_, key);
+    CHECK(!stored.is_none()) << "init " << key << " first";
+    // as server returns when store_realt is ready in this case
+    if (has_multi_precision_copy(type)) stored.WaitToRead();
+    ps::SArray<char> value;
+    value.CopyFrom(static_cast<const char*>(stored.data().dptr_),
+                   stored.shape().Size() * mshadow::mshadow_sizeof(stored.dtype()));
+    return value;
+  }
+
+  /**
+   * \brief answer a fused pull with the values of its keys concatenated
+   */
+  void FusedPullResponse(const ps::KVMeta& req_meta, const ps::SArray<ps::Key>& keys,
+                         const std::vector<ps::SArray<char>>& parts,
+                         ps::KVServer<char>* server) {
+    ps::KVPairs<char> response;
+    std::vector<int> lens;
+    size_t total = 0;
+    for (const auto& part : parts) {
+      lens.push_back(static_cast<int>(part.size()));
+      total += part.size();
+    }
+    response.keys = keys;
+    response.lens.CopyFrom(lens.begin(), lens.end());
+    response.vals.resize(total);
+    size_t offset = 0;
+    for (const auto& part : parts) {
+      std::memcpy(response.vals.data() + offset, part.data(), part.size());
+      offset += part.size();
+    }
+    server->Response(req_meta, response);
+  }
+
+  void DefaultStoragePush(const DataHandleType type, const int key, char* data,
+                          const int len, const ps::KVMeta& req_meta,
+                          ps::KVServer<char>* server) {
+    auto& stored = has_multi_precision_copy(type) ? Entry(&store_realt_, key)
+                                                  : Entry(&store_, key);
     // there used several WaitToRead, this is because \a recved's memory
     // could be deallocated when this function returns. so we need to make sure
     // the operators with \a NDArray are actually finished
-    if (req_meta.push) {
-      size_t ds[] = {(size_t) req_data.lens[0] / mshadow::mshadow_sizeof(type.dtype)};
-      TShape dshape(ds, ds + 1);
-      TBlob recv_blob;
-      MSHADOW_REAL_TYPE_SWITCH(type.dtype, DType, {
-        recv_blob = TBlob(reinterpret_cast<DType*>(req_data.vals.data()), dshape, cpu::kDevMask);
-      })
-      NDArray recved = NDArray(recv_blob, 0);
-      if (stored.is_none()) {
-        // initialization
-        stored = NDArray(dshape, Context(), false,
-                         has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
-        CopyFromTo(recved, &stored, 0);
-        server->Response(req_meta);
-        if (has_multi_precision_copy(type)) {
-          auto& stored_dtype = store_[key];
-          stored_dtype = NDArray(dshape, Context(), false, type.dtype);
-          CopyFromTo(stored, stored_dtype);
-          stored_dtype.WaitToRead();
-        }
-        stored.WaitToRead();
-      } else {
-        auto &updates = update_buf_[key];
-        if (sync_mode_ && updates.merged.is_none()) {
-          updates.merged = NDArray(dshape, Context(), false,
-                                   has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
-        }
-        if (has_multi_precision_copy(type) && updates.temp_array.is_none()) {
-          updates.temp_array = NDArray(dshape, Context(), false, mshadow::kFloat32);
-        }
-        if (updates.request.empty()) {
-          if (sync_mode_) {
-            CopyFromTo(recved, updates.merged);
-          } else {
-            if (has_multi_precision_copy(type)) {
-              CopyFromTo(recved, updates.temp_array);
-            } else {
-              updates.temp_array = recved;
-            }
-          }
+    size_t ds[] = {(size_t) len / mshadow::mshadow_sizeof(type.dtype)};
+    TShape dshape(ds, ds + 1);
+    TBlob recv_blob;
+    MSHADOW_REAL_TYPE_SWITCH(type.dtype, DType, {
+      recv_blob = TBlob(reinterpret_cast<DType*>(data), dshape, cpu::kDevMask);
+    })
+    NDArray recved = NDArray(recv_blob, 0);
+    if (stored.is_none()) {
+      // initialization
+      stored = NDArray(dshape, Context(), false,
+                       has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
+      CopyFromTo(recved, &stored, 0);
+      if (has_multi_precision_copy(type)) {
+        auto& stored_dtype = Entry(&store_, key);
+        stored_dtype = NDArray(dshape, Context(), false, type.dtype);
+        CopyFromTo(stored, stored_dtype);
+        stored_dtype.WaitToRead();
+      }
+      Respond(req_meta, server);
+      stored.WaitToRead();
+    } else {
+      auto &updates = Entry(&update_buf_, key);
+      if (sync_mode_ && updates.merged.is_none()) {
+        updates.merged = NDArray(dshape, Context(), false,
+                                 has_multi_precision_copy(type) ? mshadow::kFloat32 : type.dtype);
+      }
+      if (has_multi_precision_copy(type) && updates.temp_array.is_none()) {
+        updates.temp_array = NDArray(dshape, Context(), false, mshadow::kFloat32);
+      }
+      if (updates.request.empty()) {
+        if (sync_mode_) {
+          CopyFromTo(recved, updates.merged);
         } else {
-          CHECK(sync_mode_);
           if (has_multi_precision_copy(type)) {
             CopyFromTo(recved, updates.temp_array);
-            updates.merged += updates.temp_array;
           } else {
-            updates.merged += recved;
+            updates.temp_array = recved;
           }
         }
-        updates.request.push_back(req_meta);
-        ApplyUpdates(type, key, &updates, server);
+      } else {
+        CHECK(sync_mode_);
+        if (has_multi_precision_copy(type)) {
+          CopyFromTo(recved, updates.temp_array);
+          updates.merged += updates.temp_array;
+        } else {
+          updates.merged += recved;
+        }
       }
-    } else {
-      DefaultStorageResponse(type, key, req_meta, req_data, server);
+      updates.request.push_back(req_meta);
+      ApplyUpdates(type, key, &updates, server);
     }
   }
 
+  /**
+   * \brief identifies a request among the outstanding ones
+   */
+  static std::tuple<int, int, int> RequestId(const ps::KVMeta& req) {
+    return std::make_tuple(req.sender, req.customer_id, req.timestamp);
+  }
+
+  /**
+   * \brief Answer a push. A fused push is only answered with the last of its keys.
+   */
+  inline void Respond(const ps::KVMeta& req, ps::KVServer<char>* server) {
+    std::unique_lock<std::mutex> lk(fused_mu_);
+    if (!fused_pending_.empty()) {
+      auto it = fused_pending_.find(RequestId(req));
+      if (it != fused_pending_.end()) {
+        if (--it->second > 0) return;
+        fused_pending_.erase(it);
+      }
+    }
+    lk.unlock();
+    server->Response(req);
+  }
+
+  void SetFusedPending(const ps::KVMeta& req, size_t num_keys) {
+    std::lock_guard<std::mutex> lk(fused_mu_);
+    fused_pending_[RequestId(req)] = num_keys;
+  }
+
+  /**
+   * \brief find or insert the entry of a key. Threads of different shards look up
+   * different keys concurrently, the references stay valid when the map grows.
+   */
+  template<typename T>
+  T& Entry(std::unordered_map<int, T>* map, int key) {
+    std::lock_guard<std::mutex> lk(entry_mu_);
+    return (*map)[key];
+  }
+
   int DecodeKey(ps::Key key) {
     auto kr = ps::Postoffice::Get()->GetServerKeyRanges()[ps::MyRank()];
     return key - kr.begin();
@@ -771,7 +1044,22 @@ class KVStoreDistServer {
    */
   std::unordered_map<int, NDArray> decomp_buf_;
 
+  /**
+   * \brief number of keys of each fused push that are not updated yet
+   */
+  std::map<std::tuple<int, int, int>, size_t> fused_pending_;
+  std::mutex fused_mu_;
+  /**
+   * \brief guards insertions into store_, store_realt_, update_buf_ and decomp_buf_
+   */
+  std::mutex entry_mu_;
+
   Executor exec_;
+  /**
+   * \brief threads handling the requests, keys are assigned to them by key modulo
+   * MXNET_KVSTORE_SERVER_THREADS. null to handle requests on the ps-lite receiving thread.
+   */
+  std::unique_ptr<ShardedExecutor> shards_;
   ps::KVServer<char>* ps_server_;
 
   // whether to LOG verbose information
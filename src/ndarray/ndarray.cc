@@ -35,6 +35,7 @@
 #include <mkldnn.hpp>
 #endif
 #include "./ndarray_function.h"
+#include "../common/mapped_file.h"
 #include "../common/utils.h"
 #include "../operator/tensor/matrix_op-inl.h"
 #include "../operator/tensor/init_op.h"
@@ -1781,6 +1782,15 @@ bool NDArray::Load(dmlc::Stream *strm) {
 }
 
 const uint64_t kMXAPINDArrayListMagic = 0x112;
+/*!
+ * \brief magic of lists saved by SaveAligned. After the magic and a reserved word come the
+ *  offset and the size in bytes of every array record, the names, and then the records,
+ *  each in the format of NDArray::Save and placed so that the data of dense arrays starts
+ *  at a multiple of kNDArrayDataAlign, or kNDArrayPageSize for arrays of a page or more.
+ */
+const uint64_t kMXAPINDArrayListMagicV3 = 0x113;
+const size_t kNDArrayDataAlign = 64;
+const size_t kNDArrayPageSize = 4096;
 
 void NDArray::Save(dmlc::Stream* fo,
                    const std::vector<NDArray>& data,
@@ -1792,12 +1802,152 @@ void NDArray::Save(dmlc::Stream* fo,
   fo->Write(names);
 }
 
+/*!
+ * \brief the bytes NDArray::Save writes for a dense array before its data
+ */
+static std::string DenseRecordHeader(const NDArray& nd) {
+  std::string head;
+  dmlc::MemoryStringStream strm(&head);
+  strm.Write(NDARRAY_V2_MAGIC);
+  int32_t stype = kDefaultStorage;
+  strm.Write(&stype, sizeof(stype));
+  nd.shape().Save(&strm);
+  nd.ctx().Save(&strm);
+  int32_t type_flag = nd.dtype();
+  strm.Write(&type_flag, sizeof(type_flag));
+  return head;
+}
+
+static size_t RoundUp(size_t value, size_t align) {
+  return (value + align - 1) / align * align;
+}
+
+void NDArray::SaveAligned(dmlc::Stream* fo,
+                          const std::vector<NDArray>& data,
+                          const std::vector<std::string>& names) {
+  // sparse and empty arrays are serialized up front, dense arrays are written in place
+  std::vector<std::string> records(data.size());
+  std::vector<uint64_t> offsets(data.size()), sizes(data.size());
+  std::vector<size_t> data_bytes(data.size(), 0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    const NDArray& nd = data[i];
+    if (nd.storage_type() == kDefaultStorage && !nd.is_none()) {
+      records[i] = DenseRecordHeader(nd);
+      data_bytes[i] = nd.shape().Size() * mshadow::mshadow_sizeof(nd.dtype());
+    } else {
+      dmlc::MemoryStringStream strm(&records[i]);
+      nd.Save(&strm);
+    }
+    sizes[i] = records[i].size() + data_bytes[i];
+  }
+  // the index does not depend on the values of the offsets
+  std::string index;
+  {
+    dmlc::MemoryStringStream strm(&index);
+    strm.Write(offsets);
+    strm.Write(sizes);
+    strm.Write(names);
+  }
+  size_t pos = RoundUp(2 * sizeof(uint64_t) + index.size(), kNDArrayPageSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (data_bytes[i] > 0) {
+      const size_t align = data_bytes[i] >= kNDArrayPageSize ? kNDArrayPageSize
+                                                             : kNDArrayDataAlign;
+      offsets[i] = RoundUp(pos + records[i].size(), align) - records[i].size();
+    } else {
+      offsets[i] = RoundUp(pos, kNDArrayDataAlign);
+    }
+    pos = offsets[i] + sizes[i];
+  }
+  index.clear();
+  {
+    dmlc::MemoryStringStream strm(&index);
+    strm.Write(offsets);
+    strm.Write(sizes);
+    strm.Write(names);
+  }
+
+  uint64_t header = kMXAPINDArrayListMagicV3, reserved = 0;
+  fo->Write(&header, sizeof(header));
+  fo->Write(&reserved, sizeof(reserved));
+  fo->Write(index.data(), index.size());
+  pos = 2 * sizeof(uint64_t) + index.size();
+  const std::vector<char> padding(kNDArrayPageSize, 0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    // the gap before the first record spans the rest of the index page and may be longer
+    for (size_t gap = offsets[i] - pos; gap > 0; ) {
+      const size_t n = std::min(gap, padding.size());
+      fo->Write(padding.data(), n);
+      gap -= n;
+    }
+    if (data_bytes[i] > 0) {
+      // writes records[i] followed by the data
+      data[i].Save(fo);
+    } else {
+      fo->Write(records[i].data(), records[i].size());
+    }
+    pos = offsets[i] + sizes[i];
+  }
+}
+
+/*!
+ * \brief read the offsets and sizes of the array records of a list saved by SaveAligned,
+ *  after its magic
+ */
+static void LoadAlignedIndex(dmlc::Stream* fi,
+                             std::vector<uint64_t>* offsets,
+                             std::vector<uint64_t>* sizes,
+                             std::vector<std::string>* keys) {
+  uint64_t reserved;
+  CHECK(fi->Read(&reserved))
+      << "Invalid NDArray file format";
+  CHECK(fi->Read(offsets))
+      << "Invalid NDArray file format";
+  CHECK(fi->Read(sizes))
+      << "Invalid NDArray file format";
+  CHECK(fi->Read(keys))
+      << "Invalid NDArray file format";
+  CHECK(offsets->size() == sizes->size())
+      << "Invalid NDArray file format";
+  CHECK(keys->size() == 0 || keys->size() == offsets->size())
+      << "Invalid NDArray file format";
+}
+
+/*! \brief the bytes of the list index read by LoadAlignedIndex, including the magic */
+static size_t AlignedIndexSize(const std::vector<uint64_t>& offsets,
+                               const std::vector<std::string>& keys) {
+  size_t size = 4 * sizeof(uint64_t) + 2 * offsets.size() * sizeof(uint64_t) + sizeof(uint64_t);
+  for (const auto& key : keys) {
+    size += sizeof(uint64_t) + key.size();
+  }
+  return size;
+}
+
 void NDArray::Load(dmlc::Stream* fi,
                    std::vector<NDArray>* data,
                    std::vector<std::string>* keys) {
   uint64_t header, reserved;
   CHECK(fi->Read(&header))
       << "Invalid NDArray file format";
+  if (header == kMXAPINDArrayListMagicV3) {
+    std::vector<uint64_t> offsets, sizes;
+    LoadAlignedIndex(fi, &offsets, &sizes, keys);
+    // skip the padding of the records, the stream may not be seekable
+    size_t pos = AlignedIndexSize(offsets, *keys);
+    std::vector<char> padding;
+    data->resize(offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      CHECK(offsets[i] >= pos)
+          << "Invalid NDArray file format";
+      padding.resize(offsets[i] - pos);
+      CHECK(fi->Read(padding.data(), padding.size()) == padding.size())
+          << "Invalid NDArray file format";
+      CHECK((*data)[i].Load(fi))
+          << "Invalid NDArray file format";
+      pos = offsets[i] + sizes[i];
+    }
+    return;
+  }
   CHECK(fi->Read(&reserved))
       << "Invalid NDArray file format";
   CHECK(header == kMXAPINDArrayListMagic)
@@ -1810,6 +1960,102 @@ void NDArray::Load(dmlc::Stream* fi,
       << "Invalid NDArray file format";
 }
 
+/*!
+ * \brief Refer to the data of a dense CPU array saved by NDArray::Save, at the current
+ *  position of strm reading buffer.
+ * \return false if the array has to be loaded by copying, strm is then left anywhere
+ */
+static bool LoadDenseFromMemory(dmlc::MemoryFixedSizeStream *strm, char *buffer, size_t size,
+                                const std::shared_ptr<void>& owner, NDArray *out) {
+  uint32_t magic;
+  if (strm->Read(&magic, sizeof(magic)) != sizeof(magic)) return false;
+  if (magic != NDARRAY_V2_MAGIC) return false;
+  int32_t stype;
+  if (strm->Read(&stype, sizeof(stype)) != sizeof(stype)) return false;
+  if (stype != kDefaultStorage) return false;
+  TShape shape;
+  if (!shape.Load(strm) || shape.ndim() == 0) return false;
+  Context ctx;
+  if (!ctx.Load(strm) || ctx.dev_mask() != cpu::kDevMask) return false;
+  int32_t type_flag;
+  if (strm->Read(&type_flag, sizeof(type_flag)) != sizeof(type_flag)) return false;
+  const size_t type_size = mshadow::mshadow_sizeof(type_flag);
+  const size_t offset = strm->Tell();
+  const size_t nbytes = type_size * shape.Size();
+  if (offset + nbytes > size) return false;
+  char *dptr = buffer + offset;
+  if (reinterpret_cast<uintptr_t>(dptr) % type_size != 0) return false;
+  *out = NDArray(TBlob(dptr, shape, cpu::kDevMask, type_flag), 0, [owner]() {});
+  strm->Seek(offset + nbytes);
+  return true;
+}
+
+/*! \brief load the array record at the current position of fi, in place if possible */
+static void LoadRecordFromMemory(dmlc::MemoryFixedSizeStream *fi, char *buffer, size_t size,
+                           const std::shared_ptr<void>& owner, NDArray *out) {
+  const size_t begin = fi->Tell();
+  if (!LoadDenseFromMemory(fi, buffer, size, owner, out)) {
+    fi->Seek(begin);
+    CHECK(out->Load(fi))
+        << "Invalid NDArray file format";
+  }
+}
+
+void NDArray::LoadFromMemory(char* buffer, size_t size,
+                             const std::shared_ptr<void>& owner,
+                             std::vector<NDArray>* data,
+                             std::vector<std::string>* keys) {
+  dmlc::MemoryFixedSizeStream fi(buffer, size);
+  uint64_t header, reserved, num_arrays;
+  CHECK(fi.Read(&header))
+      << "Invalid NDArray file format";
+  if (header == kMXAPINDArrayListMagicV3) {
+    std::vector<uint64_t> offsets, sizes;
+    LoadAlignedIndex(&fi, &offsets, &sizes, keys);
+    data->resize(offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      CHECK(offsets[i] + sizes[i] <= size)
+          << "Invalid NDArray file format";
+      fi.Seek(offsets[i]);
+      LoadRecordFromMemory(&fi, buffer, size, owner, &(*data)[i]);
+    }
+    return;
+  }
+  CHECK(fi.Read(&reserved))
+      << "Invalid NDArray file format";
+  CHECK(header == kMXAPINDArrayListMagic)
+      << "Invalid NDArray file format";
+  CHECK(fi.Read(&num_arrays))
+      << "Invalid NDArray file format";
+  data->resize(num_arrays);
+  for (auto& array : *data) {
+    LoadRecordFromMemory(&fi, buffer, size, owner, &array);
+  }
+  CHECK(fi.Read(keys))
+      << "Invalid NDArray file format";
+  CHECK(keys->size() == 0 || keys->size() == data->size())
+      << "Invalid NDArray file format";
+}
+
+void NDArray::LoadFile(const std::string& fname,
+                       std::vector<NDArray>* data,
+                       std::vector<std::string>* keys) {
+  if (fname.find("://") == std::string::npos) {
+    uint64_t header = 0;
+    {
+      std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(fname.c_str(), "r"));
+      fi->Read(&header, sizeof(header));
+    }
+    if (header == kMXAPINDArrayListMagicV3) {
+      auto file = std::make_shared<common::MappedFile>(fname);
+      LoadFromMemory(file->data(), file->size(), file, data, keys);
+      return;
+    }
+  }
+  std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(fname.c_str(), "r"));
+  Load(fi.get(), data, keys);
+}
+
 NDArray NDArray::Copy(Context ctx) const {
   NDArray ret;
   if (kDefaultStorage == storage_type()) {
@@ -24,13 +24,81 @@
  * \author Chen Zhu
 */
 #include "./count_sketch-inl.h"
+#include <vector>
+#include "../../engine/openmp.h"
+namespace mshadow {
+
+// the output rows are disjoint, so samples are sketched in parallel without atomics and
+// processing_batch_size, which bounds the GPU launches, does not apply
+template<typename DType>
+inline void CountSketchForward(const Tensor<cpu, 2, DType> &out,
+                               const Tensor<cpu, 2, DType> &in,
+                               const Tensor<cpu, 1, DType> &h,
+                               const Tensor<cpu, 1, DType> &s,
+                               const int n_samples,
+                               const int processing_batch_size,
+                               const int in_dim,
+                               const int out_dim) {
+  std::vector<int> target(in_dim);
+  for (int i = 0; i < in_dim; ++i) {
+    target[i] = static_cast<int>(h.dptr_[i]);
+    CHECK(target[i] >= 0 && target[i] < out_dim)
+      << "h must be in [0, out_dim), got " << h.dptr_[i] << " at " << i;
+  }
+  const DType *s_ptr = s.dptr_;
+  #pragma omp parallel for num_threads(mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int n = 0; n < n_samples; ++n) {
+    const DType *in_row = in.dptr_ + static_cast<size_t>(n) * in_dim;
+    DType *out_row = out.dptr_ + static_cast<size_t>(n) * out_dim;
+    for (int i = 0; i < in_dim; ++i) {
+      out_row[target[i]] += s_ptr[i] * in_row[i];
+    }
+  }
+}
+
+template<typename DType>
+inline void CountSketchBackward(const Tensor<cpu, 2, DType> &in_grad,
+                                const Tensor<cpu, 2, DType> &out_grad,
+                                const Tensor<cpu, 1, DType> &h,
+                                const Tensor<cpu, 1, DType> &s,
+                                const int n_samples,
+                                const int processing_batch_size,
+                                const int in_dim,
+                                const int out_dim) {
+  std::vector<int> target(in_dim);
+  for (int i = 0; i < in_dim; ++i) {
+    target[i] = static_cast<int>(h.dptr_[i]);
+    CHECK(target[i] >= 0 && target[i] < out_dim)
+      << "h must be in [0, out_dim), got " << h.dptr_[i] << " at " << i;
+  }
+  const DType *s_ptr = s.dptr_;
+  #pragma omp parallel for num_threads(mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int n = 0; n < n_samples; ++n) {
+    DType *in_grad_row = in_grad.dptr_ + static_cast<size_t>(n) * in_dim;
+    const DType *out_grad_row = out_grad.dptr_ + static_cast<size_t>(n) * out_dim;
+    for (int i = 0; i < in_dim; ++i) {
+      in_grad_row[i] = out_grad_row[target[i]] * s_ptr[i];
+    }
+  }
+}
+}  // namespace mshadow
 namespace mxnet {
 namespace op {
 
 template<>
 Operator *CreateOp<cpu>(CountSketchParam param, int dtype) {
-    LOG(FATAL) << "CountSketch is only available for GPU.";
-    return nullptr;
+  Operator *op = nullptr;
+  switch (dtype) {
+    case mshadow::kFloat32:
+      op = new CountSketchOp<cpu, float>(param);
+      break;
+    case mshadow::kFloat64:
+      op = new CountSketchOp<cpu, double>(param);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported type " << dtype;
+  }
+  return op;
 }
 Operator *CountSketchProp::CreateOperatorEx(Context ctx, std::vector<TShape> *in_shape,
                                             std::vector<int> *in_type) const {
@@ -45,7 +113,7 @@ DMLC_REGISTER_PARAMETER(CountSketchParam);
 MXNET_REGISTER_OP_PROPERTY(_contrib_count_sketch, CountSketchProp)
 .describe(R"code(Apply CountSketch to input: map a d-dimension data to k-dimension data"
 
-.. note:: `count_sketch` is only available on GPU.
+.. note:: `count_sketch` supports float32 and float64 only.
 
 Assume input data has shape (N, d), sign hash table s has shape (N, d),
 index hash table h has shape (N, d) and mapping dimension out_dim = k,
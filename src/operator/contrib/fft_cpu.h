@@ -0,0 +1,260 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  Copyright (c) 2019 by Contributors
+ *  \file fft_cpu.h
+ *  \brief Batched 1D complex FFT on the CPU, shared by the fft and ifft operators
+ */
+#ifndef MXNET_OPERATOR_CONTRIB_FFT_CPU_H_
+#define MXNET_OPERATOR_CONTRIB_FFT_CPU_H_
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include "../operator_common.h"
+#include "../../engine/openmp.h"
+
+namespace mxnet {
+namespace op {
+namespace fft {
+
+/*!
+ * \brief An unnormalized complex to complex transform of one length, with the sign
+ *  conventions of hipFFT: forward uses exp(-2 pi i jk / n), inverse exp(+2 pi i jk / n).
+ *  The length is factored into radix 4, 2, 3 and 5 stages, then any other prime, and each
+ *  stage is a Stockham pass, so no bit reversal is needed and the innermost loop of the
+ *  later stages runs over contiguous elements. A prime length is a single O(n^2) stage.
+ */
+template<typename DType>
+class CPUFFTPlan {
+ public:
+  typedef std::complex<DType> Complex;
+
+  explicit CPUFFTPlan(const int n) : n_(n) {
+    CHECK_GT(n, 0) << "FFT length must be positive";
+    int rest = n;
+    for (const int radix : {4, 2, 3, 5}) {
+      while (rest % radix == 0) {
+        AddStage(radix, &rest);
+      }
+    }
+    for (int radix = 7; rest > 1; radix += 2) {
+      while (rest % radix == 0) {
+        AddStage(radix, &rest);
+      }
+    }
+  }
+
+  int size() const { return n_; }
+
+  /*!
+   * \brief transform the n values at x in place
+   * \param work scratch space for n values
+   */
+  void Execute(Complex *x, Complex *work, const bool inverse) const {
+    // the inverse is the conjugate of the forward transform of the conjugate
+    if (inverse) {
+      for (int i = 0; i < n_; ++i) x[i] = std::conj(x[i]);
+    }
+    // inputs of one generic butterfly, on the heap only for radices above 5
+    Complex small[5];
+    std::vector<Complex> large(max_radix_ > 5 ? max_radix_ : 0);
+    Complex *butterfly = max_radix_ > 5 ? large.data() : small;
+    Complex *src = x, *dst = work;
+    for (const Stage& stage : stages_) {
+      const Complex *tw = twiddles_.data() + stage.twiddle_offset;
+      switch (stage.radix) {
+        case 2:
+          Radix2(stage, src, dst, tw);
+          break;
+        case 4:
+          Radix4(stage, src, dst, tw);
+          break;
+        default:
+          RadixGeneric(stage, src, dst, tw, butterfly);
+          break;
+      }
+      std::swap(src, dst);
+    }
+    if (src != x) {
+      std::copy(src, src + n_, x);
+    }
+    if (inverse) {
+      for (int i = 0; i < n_; ++i) x[i] = std::conj(x[i]);
+    }
+  }
+
+ private:
+  /*!
+   * \brief one pass of a length len = radix * m sub-transform over stride interleaved
+   *  sequences: y[t + stride * (radix * q + j)] = w^(qj) * DFT_radix(x[t + stride * (q + km)])_j
+   */
+  struct Stage {
+    int radix, m, stride;
+    size_t twiddle_offset, root_offset;
+  };
+
+  void AddStage(const int radix, int *rest) {
+    Stage stage;
+    stage.radix = radix;
+    stage.m = *rest / radix;
+    stage.stride = n_ / *rest;
+    stage.twiddle_offset = twiddles_.size();
+    const double theta = -2.0 * M_PI / *rest;
+    for (int q = 0; q < stage.m; ++q) {
+      for (int j = 1; j < radix; ++j) {
+        // reduce the exponent first to keep the angle accurate
+        const double angle = theta * ((static_cast<int64_t>(q) * j) % *rest);
+        twiddles_.emplace_back(static_cast<DType>(std::cos(angle)),
+                               static_cast<DType>(std::sin(angle)));
+      }
+    }
+    stage.root_offset = roots_.size();
+    if (radix != 2 && radix != 4) {
+      for (int r = 0; r < radix; ++r) {
+        const double angle = -2.0 * M_PI * r / radix;
+        roots_.emplace_back(static_cast<DType>(std::cos(angle)),
+                            static_cast<DType>(std::sin(angle)));
+      }
+    }
+    max_radix_ = std::max(max_radix_, radix);
+    stages_.push_back(stage);
+    *rest = stage.m;
+  }
+
+  /*! \brief complex product without the inf/nan recovery of std::complex */
+  static Complex Mul(const Complex& a, const Complex& b) {
+    return Complex(a.real() * b.real() - a.imag() * b.imag(),
+                   a.real() * b.imag() + a.imag() * b.real());
+  }
+
+  /*! \brief -i * a */
+  static Complex MulNegI(const Complex& a) {
+    return Complex(a.imag(), -a.real());
+  }
+
+  static void Radix2(const Stage& st, const Complex *x, Complex *y, const Complex *tw) {
+    const int s = st.stride, m = st.m;
+    for (int q = 0; q < m; ++q) {
+      const Complex w1 = tw[q];
+      const Complex *x0 = x + s * q, *x1 = x + s * (q + m);
+      Complex *y0 = y + s * (2 * q), *y1 = y + s * (2 * q + 1);
+      for (int t = 0; t < s; ++t) {
+        const Complex a = x0[t], b = x1[t];
+        y0[t] = a + b;
+        y1[t] = Mul(a - b, w1);
+      }
+    }
+  }
+
+  static void Radix4(const Stage& st, const Complex *x, Complex *y, const Complex *tw) {
+    const int s = st.stride, m = st.m;
+    for (int q = 0; q < m; ++q) {
+      const Complex w1 = tw[3 * q], w2 = tw[3 * q + 1], w3 = tw[3 * q + 2];
+      const Complex *x0 = x + s * q, *x1 = x + s * (q + m);
+      const Complex *x2 = x + s * (q + 2 * m), *x3 = x + s * (q + 3 * m);
+      Complex *y0 = y + s * (4 * q);
+      for (int t = 0; t < s; ++t) {
+        const Complex a0 = x0[t], a1 = x1[t], a2 = x2[t], a3 = x3[t];
+        const Complex s02 = a0 + a2, d02 = a0 - a2;
+        const Complex s13 = a1 + a3, d13 = MulNegI(a1 - a3);
+        y0[t] = s02 + s13;
+        y0[t + s] = Mul(d02 + d13, w1);
+        y0[t + 2 * s] = Mul(s02 - s13, w2);
+        y0[t + 3 * s] = Mul(d02 - d13, w3);
+      }
+    }
+  }
+
+  void RadixGeneric(const Stage& st, const Complex *x, Complex *y, const Complex *tw,
+                    Complex *a) const {
+    const int s = st.stride, m = st.m, p = st.radix;
+    const Complex *roots = roots_.data() + st.root_offset;
+    for (int q = 0; q < m; ++q) {
+      for (int t = 0; t < s; ++t) {
+        for (int k = 0; k < p; ++k) {
+          a[k] = x[t + s * (q + k * m)];
+        }
+        for (int j = 0; j < p; ++j) {
+          Complex sum = a[0];
+          for (int k = 1, r = j; k < p; ++k, r = (r + j) % p) {
+            sum += Mul(a[k], roots[r]);
+          }
+          y[t + s * (p * q + j)] = j == 0 ? sum : Mul(sum, tw[q * (p - 1) + j - 1]);
+        }
+      }
+    }
+  }
+
+  int n_;
+  int max_radix_ = 1;
+  std::vector<Stage> stages_;
+  /*! \brief w^(qj) of every stage, w the root of unity of the stage's sub-length */
+  std::vector<Complex> twiddles_;
+  /*! \brief roots of unity of the generic radix stages */
+  std::vector<Complex> roots_;
+};
+
+/*!
+ * \brief Transform rows of length plan.size() in parallel. Rows of in and out are either
+ *  interleaved complex values [re0, im0, re1, im1, ...] or real values; a real input is
+ *  taken with zero imaginary part and a real output is the real part of the transform.
+ * \param workspace 4 * plan.size() values per thread
+ */
+template<typename DType>
+void FFTRowsCPU(const CPUFFTPlan<DType>& plan, const int rows,
+                const DType *in, const bool complex_in, DType *out, const bool complex_out,
+                const bool inverse, const OpReqType req, const int nthreads, DType *workspace) {
+  typedef std::complex<DType> Complex;
+  if (req == kNullOp) return;
+  const int n = plan.size();
+  const int block = (rows + nthreads - 1) / nthreads;
+  #pragma omp parallel for num_threads(nthreads)
+  for (int tid = 0; tid < nthreads; ++tid) {
+    Complex *x = reinterpret_cast<Complex*>(workspace) + 2 * n * tid;
+    Complex *work = x + n;
+    const int end = std::min(rows, (tid + 1) * block);
+    for (int r = tid * block; r < end; ++r) {
+      const DType *src = in + static_cast<size_t>(r) * n * (complex_in ? 2 : 1);
+      DType *dst = out + static_cast<size_t>(r) * n * (complex_out ? 2 : 1);
+      for (int j = 0; j < n; ++j) {
+        x[j] = complex_in ? Complex(src[2 * j], src[2 * j + 1]) : Complex(src[j], 0);
+      }
+      plan.Execute(x, work, inverse);
+      if (complex_out) {
+        const DType *res = reinterpret_cast<const DType*>(x);
+        for (int j = 0; j < 2 * n; ++j) {
+          dst[j] = req == kAddTo ? dst[j] + res[j] : res[j];
+        }
+      } else {
+        for (int j = 0; j < n; ++j) {
+          dst[j] = req == kAddTo ? dst[j] + x[j].real() : x[j].real();
+        }
+      }
+    }
+  }
+}
+
+}  // namespace fft
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CONTRIB_FFT_CPU_H_
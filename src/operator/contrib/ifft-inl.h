@@ -29,11 +29,13 @@
 #include <dmlc/logging.h>
 #include <dmlc/parameter.h>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <utility>
 #include "../operator_common.h"
 #include "../mshadow_op.h"
+#include "./fft_cpu.h"
 
 #if MXNET_USE_GPU
 #include <hipfft.h>
@@ -55,6 +57,9 @@ struct IFFTParam : public dmlc::Parameter<IFFTParam> {
   }
 };
 
+template<typename xpu, typename DType>
+class IFFTOp;
+
 #if MXNET_USE_GPU
 template<typename xpu, typename DType>
 class IFFTOp : public Operator {
@@ -206,6 +211,71 @@ class IFFTOp : public Operator {
 
 #endif  // MXNET_USE_GPU
 
+/*!
+ * \brief ifft on the CPU, with the same unnormalized transforms as the GPU operator.
+ *  The rows are transformed in parallel with one plan of the row length.
+ */
+template<typename DType>
+class IFFTOp<cpu, DType> : public Operator {
+ public:
+  explicit IFFTOp(IFFTParam p) {
+    this->param_ = p;
+  }
+
+  virtual void Forward(const OpContext &ctx,
+                       const std::vector<TBlob> &in_data,
+                       const std::vector<OpReqType> &req,
+                       const std::vector<TBlob> &out_data,
+                       const std::vector<TBlob> &aux_args) {
+    CHECK_EQ(in_data.size(), 1);
+    CHECK_EQ(out_data.size(), 1);
+    const TBlob &data = in_data[ifft::kData];
+    // interleaved complex rows to the real part of their inverse transform
+    const int dim = data.shape_[data.ndim() - 1] / 2;
+    const int n_iffts = data.shape_.ProdShape(0, data.ndim() - 1);
+    Transform(ctx, dim, n_iffts, data.dptr<DType>(), true,
+              out_data[ifft::kOut].dptr<DType>(), false, true, req[ifft::kOut]);
+  }
+
+  virtual void Backward(const OpContext &ctx,
+                        const std::vector<TBlob> &out_grad,
+                        const std::vector<TBlob> &in_data,
+                        const std::vector<TBlob> &out_data,
+                        const std::vector<OpReqType> &req,
+                        const std::vector<TBlob> &in_grad,
+                        const std::vector<TBlob> &aux_args) {
+    CHECK_EQ(out_grad.size(), 1);
+    CHECK(in_data.size() == 1 && in_grad.size() == 1);
+    CHECK_EQ(req.size(), 1);
+    const TBlob &data = in_data[ifft::kData];
+    // the forward transform of the real gradient
+    const int dim = data.shape_[data.ndim() - 1] / 2;
+    const int n_iffts = data.shape_.ProdShape(0, data.ndim() - 1);
+    Transform(ctx, dim, n_iffts, out_grad[ifft::kOut].dptr<DType>(), false,
+              in_grad[ifft::kData].dptr<DType>(), true, false, req[ifft::kData]);
+  }
+
+ private:
+  void Transform(const OpContext &ctx, const int dim, const int rows,
+                 const DType *in, const bool complex_in, DType *out, const bool complex_out,
+                 const bool inverse, const OpReqType req) {
+    using namespace mshadow;
+    if (plan_ == nullptr || plan_->size() != dim) {
+      plan_.reset(new fft::CPUFFTPlan<DType>(dim));
+    }
+    const int nthreads = std::max(1, std::min(
+      engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), rows));
+    Tensor<cpu, 1, DType> workspace =
+      ctx.requested[ifft::kTempSpace].get_space_typed<cpu, 1, DType>(
+        Shape1(nthreads * 4 * dim), ctx.get_stream<cpu>());
+    fft::FFTRowsCPU(*plan_, rows, in, complex_in, out, complex_out, inverse, req,
+                    nthreads, workspace.dptr_);
+  }
+
+  IFFTParam param_;
+  std::unique_ptr<fft::CPUFFTPlan<DType> > plan_;
+};  // class IFFTOp<cpu, DType>
+
 // Declare Factory Function, used for dispatch specialization
 template<typename xpu>
 Operator* CreateOp(IFFTParam param, int dtype);
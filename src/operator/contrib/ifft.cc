@@ -30,8 +30,18 @@ namespace op {
 
 template<>
 Operator *CreateOp<cpu>(IFFTParam param, int dtype) {
-  LOG(FATAL) << "ifft is only available for GPU.";
-  return nullptr;
+  Operator *op = nullptr;
+  switch (dtype) {
+    case mshadow::kFloat32:
+      op = new IFFTOp<cpu, float>(param);
+      break;
+    case mshadow::kFloat64:
+      op = new IFFTOp<cpu, double>(param);
+      break;
+    default:
+      LOG(FATAL) << "ifft on CPU supports only float32 and float64, got type " << dtype;
+  }
+  return op;
 }
 
 Operator *IFFTProp::CreateOperatorEx(Context ctx, std::vector<TShape> *in_shape,
@@ -44,7 +54,7 @@ DMLC_REGISTER_PARAMETER(IFFTParam);
 MXNET_REGISTER_OP_PROPERTY(_contrib_ifft, IFFTProp)
 .describe(R"code(Apply 1D ifft to input"
 
-.. note:: `ifft` is only available on GPU.
+.. note:: `ifft` on CPU supports float32 and float64 only.
 
 Currently accept 2 input data shapes: (N, d) or (N1, N2, N3, d). Data is in format: [real0, imag0, real1, imag1, ...].
 Last dimension must be an even number.
@@ -53,7 +63,7 @@ The output data has shape: (N, d/2) or (N1, N2, N3, d/2). It is only the real pa
 Example::
 
    data = np.random.normal(0,1,(3,4))
-   out = mx.contrib.ndarray.ifft(data = mx.nd.array(data,ctx = mx.gpu(0)))
+   out = mx.contrib.ndarray.ifft(data = mx.nd.array(data))
 
 )code" ADD_FILELINE)
 .add_argument("data", "NDArray-or-Symbol", "Input data to the IFFTOp.")
@@ -25,6 +25,7 @@
 
 #include "layer_norm-inl.h"
 #include <nnvm/op_attr_types.h>
+#include <cmath>
 #include "../elemwise_op_common.h"
 
 namespace mxnet {
@@ -32,6 +33,209 @@ namespace op {
 
 DMLC_REGISTER_PARAMETER(LayerNormParam);
 
+namespace layernorm {
+/*! \brief number of interleaved accumulators of the row moments */
+const int kLanes = 8;
+
+/*!
+ * \brief mean and (biased) variance of a row in a single pass. Lane l keeps a Welford
+ *  update of the elements l, l + kLanes, ..., so the lanes share their count and the update
+ *  of all lanes vectorizes. The lanes and the leftover tail are merged with Chan's formula.
+ */
+template<typename DType, typename AccReal>
+inline void RowMoments(const DType *x, const index_t n, AccReal *mean, AccReal *var) {
+  AccReal lane_mean[kLanes] = {0}, lane_m2[kLanes] = {0};
+  const index_t steps = n / kLanes;
+  for (index_t k = 0; k < steps; ++k) {
+    const DType *block = x + k * kLanes;
+    const AccReal scale = AccReal(1) / static_cast<AccReal>(k + 1);
+    for (int l = 0; l < kLanes; ++l) {
+      const AccReal v = static_cast<AccReal>(block[l]);
+      const AccReal delta = v - lane_mean[l];
+      lane_mean[l] += delta * scale;
+      lane_m2[l] += delta * (v - lane_mean[l]);
+    }
+  }
+  AccReal m = 0, m2 = 0;
+  index_t count = 0;
+  if (steps > 0) {
+    for (int l = 0; l < kLanes; ++l) {
+      const AccReal delta = lane_mean[l] - m;
+      const AccReal ratio = static_cast<AccReal>(steps) / static_cast<AccReal>(count + steps);
+      m += delta * ratio;
+      m2 += lane_m2[l] + delta * delta * static_cast<AccReal>(count) * ratio;
+      count += steps;
+    }
+  }
+  for (index_t i = steps * kLanes; i < n; ++i) {
+    const AccReal v = static_cast<AccReal>(x[i]);
+    const AccReal delta = v - m;
+    m += delta / static_cast<AccReal>(++count);
+    m2 += delta * (v - m);
+  }
+  *mean = m;
+  *var = n > 0 ? m2 / static_cast<AccReal>(n) : AccReal(0);
+}
+
+/*!
+ * \brief out = (in - mean) / std * gamma + beta for rows of length cols, with the moments
+ *  and the normalization of a row done while it is in cache. out may alias in.
+ */
+template<typename DType, typename AccReal>
+void LayerNormRowsCPU(const index_t rows, const index_t cols, const AccReal eps,
+                      const DType *in, const DType *gamma, const DType *beta,
+                      DType *out, DType *mean, DType *std) {
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int64_t r = 0; r < static_cast<int64_t>(rows); ++r) {
+    const DType *x = in + r * cols;
+    DType *y = out + r * cols;
+    AccReal m, var;
+    RowMoments(x, cols, &m, &var);
+    const AccReal sd = std::sqrt(var + eps);
+    const AccReal inv_std = AccReal(1) / sd;
+    for (index_t j = 0; j < cols; ++j) {
+      y[j] = static_cast<DType>((static_cast<AccReal>(x[j]) - m) * inv_std *
+                                static_cast<AccReal>(gamma[j]) + static_cast<AccReal>(beta[j]));
+    }
+    mean[r] = static_cast<DType>(m);
+    std[r] = static_cast<DType>(sd);
+  }
+}
+
+/*!
+ * \brief Gradients of LayerNormRowsCPU. Each thread takes a block of rows, computes the
+ *  data gradient of a row from two sweeps over it and accumulates the gamma and beta
+ *  gradients of its rows into its own slice of workspace (2 * cols per thread), which
+ *  are summed at the end.
+ */
+template<typename DType, typename AccReal>
+void LayerNormGradRowsCPU(const index_t rows, const index_t cols,
+                          const DType *ograd, const DType *in, const DType *gamma,
+                          const DType *mean, const DType *std,
+                          const std::vector<OpReqType>& req,
+                          DType *grad_in, DType *grad_gamma, DType *grad_beta,
+                          const int nthreads, AccReal *workspace) {
+  const index_t block = (rows + nthreads - 1) / nthreads;
+  const bool param_grad = req[1] != kNullOp || req[2] != kNullOp;
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    AccReal *sum_xhat_og = workspace + t * 2 * cols;
+    AccReal *sum_og = sum_xhat_og + cols;
+    std::fill(sum_xhat_og, sum_og + cols, AccReal(0));
+    const index_t end = std::min(rows, (t + 1) * block);
+    for (index_t r = t * block; r < end; ++r) {
+      const DType *og = ograd + r * cols;
+      const DType *x = in + r * cols;
+      const AccReal m = static_cast<AccReal>(mean[r]);
+      const AccReal inv_std = AccReal(1) / static_cast<AccReal>(std[r]);
+      // w = og * gamma, the sums of w and w * (x - mean) over the row
+      AccReal sum_w = 0, sum_wx = 0;
+      for (index_t j = 0; j < cols; ++j) {
+        const AccReal w = static_cast<AccReal>(og[j]) * static_cast<AccReal>(gamma[j]);
+        const AccReal xc = static_cast<AccReal>(x[j]) - m;
+        sum_w += w;
+        sum_wx += w * xc;
+      }
+      if (param_grad) {
+        for (index_t j = 0; j < cols; ++j) {
+          const AccReal g = static_cast<AccReal>(og[j]);
+          sum_xhat_og[j] += g * (static_cast<AccReal>(x[j]) - m) * inv_std;
+          sum_og[j] += g;
+        }
+      }
+      if (req[0] != kNullOp) {
+        // grad_in = (w - mean(w) - (x - mean) * mean(w * (x - mean)) / std^2) / std
+        DType *dx = grad_in + r * cols;
+        const AccReal mean_w = sum_w / static_cast<AccReal>(cols);
+        const AccReal mean_wx = sum_wx * inv_std * inv_std / static_cast<AccReal>(cols);
+        for (index_t j = 0; j < cols; ++j) {
+          const AccReal w = static_cast<AccReal>(og[j]) * static_cast<AccReal>(gamma[j]);
+          const AccReal xc = static_cast<AccReal>(x[j]) - m;
+          const AccReal v = (w - mean_w - xc * mean_wx) * inv_std;
+          dx[j] = req[0] == kAddTo ? static_cast<DType>(static_cast<AccReal>(dx[j]) + v)
+                                   : static_cast<DType>(v);
+        }
+      }
+    }
+  }
+  if (!param_grad) return;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int64_t j = 0; j < static_cast<int64_t>(cols); ++j) {
+    AccReal gg = 0, gb = 0;
+    for (int t = 0; t < nthreads; ++t) {
+      gg += workspace[t * 2 * cols + j];
+      gb += workspace[t * 2 * cols + cols + j];
+    }
+    if (req[1] != kNullOp) {
+      if (req[1] == kAddTo) gg += static_cast<AccReal>(grad_gamma[j]);
+      grad_gamma[j] = static_cast<DType>(gg);
+    }
+    if (req[2] != kNullOp) {
+      if (req[2] == kAddTo) gb += static_cast<AccReal>(grad_beta[j]);
+      grad_beta[j] = static_cast<DType>(gb);
+    }
+  }
+}
+
+/*! \brief the normalized axis, or -1 when it is not the last one */
+inline int LastAxisOrNone(const LayerNormParam& param, const TShape& shape) {
+  const int ndim = shape.ndim();
+  const int axis = param.axis < 0 ? param.axis + ndim : param.axis;
+  return axis == ndim - 1 ? axis : -1;
+}
+}  // namespace layernorm
+
+template<>
+void LayerNormCompute<cpu>(const nnvm::NodeAttrs& attrs,
+                           const OpContext& ctx, const std::vector<TBlob>& inputs,
+                           const std::vector<OpReqType>& req,
+                           const std::vector<TBlob>& outputs) {
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  if (req[0] == kNullOp) return;
+  CHECK_NE(req[0], kAddTo);
+  CHECK_EQ(inputs.size(), 3U);
+  const TBlob& data = inputs[layernorm::kData];
+  if (layernorm::LastAxisOrNone(param, data.shape_) < 0) {
+    return LayerNormComputeGeneral<cpu>(attrs, ctx, inputs, req, outputs);
+  }
+  const index_t cols = data.shape_[data.ndim() - 1];
+  const index_t rows = data.shape_.Size() / cols;
+  MSHADOW_REAL_TYPE_SWITCH_EX(data.type_flag_, DType, AccReal, {
+    layernorm::LayerNormRowsCPU<DType, AccReal>(
+      rows, cols, static_cast<AccReal>(param.eps), data.dptr<DType>(),
+      inputs[layernorm::kGamma].dptr<DType>(), inputs[layernorm::kBeta].dptr<DType>(),
+      outputs[layernorm::kOut].dptr<DType>(), outputs[layernorm::kMean].dptr<DType>(),
+      outputs[layernorm::kStd].dptr<DType>());
+  });
+}
+
+template<>
+void LayerNormGradCompute<cpu>(const nnvm::NodeAttrs& attrs,
+                               const OpContext& ctx, const std::vector<TBlob>& inputs,
+                               const std::vector<OpReqType>& req,
+                               const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  CHECK_EQ(inputs.size(), 5U);
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  const TBlob& data = inputs[1];
+  if (layernorm::LastAxisOrNone(param, data.shape_) < 0) {
+    return LayerNormGradComputeGeneral<cpu>(attrs, ctx, inputs, req, outputs);
+  }
+  const index_t cols = data.shape_[data.ndim() - 1];
+  const index_t rows = data.shape_.Size() / cols;
+  const int nthreads = std::max(1, std::min<int>(
+    engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), rows));
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+  MSHADOW_REAL_TYPE_SWITCH_EX(data.type_flag_, DType, AccReal, {
+    Tensor<cpu, 1, AccReal> workspace = ctx.requested[0].get_space_typed<cpu, 1, AccReal>(
+      Shape1(nthreads * 2 * cols), s);
+    layernorm::LayerNormGradRowsCPU<DType, AccReal>(
+      rows, cols, inputs[0].dptr<DType>(), data.dptr<DType>(), inputs[2].dptr<DType>(),
+      inputs[3].dptr<DType>(), inputs[4].dptr<DType>(), req, outputs[0].dptr<DType>(),
+      outputs[1].dptr<DType>(), outputs[2].dptr<DType>(), nthreads, workspace.dptr_);
+  });
+}
+
 static bool LayerNormShape(const nnvm::NodeAttrs& attrs,
                            std::vector<TShape> *in_shape,
                            std::vector<TShape> *out_shape) {
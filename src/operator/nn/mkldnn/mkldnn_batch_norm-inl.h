@@ -33,6 +33,7 @@
 #include "../batch_norm-inl.h"
 #include "./mkldnn_ops-inl.h"
 #include "./mkldnn_base-inl.h"
+#include "./mkldnn_primitive_cache.h"
 
 #define VARIANCE_TO_INVSTD(__var$,    __eps$)   (1.0/std::sqrt((__var$) + DType(__eps$)))
 #define INVSTD_TO_VARIANCE(__invstd$, __eps$)   ((1.0 / ((__invstd$) * (__invstd$))) - (__eps$))
@@ -181,26 +182,24 @@ class MKLDNNBNForward {
 };
 
 template<typename DType>
-static MKLDNNBNForward &GetBNForward(const BatchNormParam& param,
-                                     const OpContext &ctx, const NDArray &in_data,
-                                     unsigned flags) {
-#if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNBNSignature, MKLDNNBNForward, OpHash> fwds;
-#else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNBNSignature, MKLDNNBNForward, OpHash> fwds;
-#endif
+static MKLDNNCachedPrimitive<MKLDNNBNForward> GetBNForward(const BatchNormParam& param,
+                                                           const OpContext &ctx,
+                                                           const NDArray &in_data,
+                                                           unsigned flags) {
+  static MKLDNNPrimitiveCache<MKLDNNBNSignature, MKLDNNBNForward, OpHash> fwds("BatchNorm");
   MKLDNNBNSignature key(param);
   key.AddSign(ctx.is_train);
   key.AddSign(in_data);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
+  return fwds.Get(key, [&]() -> MKLDNNBNForward {
     auto fwd_pd = _GetFwd(*in_data.GetMKLDNNData(), ctx.is_train,
                           (DType) param.eps, flags);
-    MKLDNNBNForward fwd(fwd_pd, ctx.is_train);
-    it = AddToCache(&fwds, key, fwd);
-  }
-  return it->second;
+    return MKLDNNBNForward(fwd_pd, ctx.is_train);
+  }, [](const MKLDNNBNForward &fwd) {
+    return fwd.GetPd().src_primitive_desc().get_size() +
+           fwd.GetPd().weights_primitive_desc().get_size() +
+           fwd.GetPd().dst_primitive_desc().get_size();
+  });
 }
 
 template <typename DType>
@@ -213,7 +212,8 @@ void MKLDNNBatchNormForward(const OpContext &ctx, const BatchNormParam &param,
   unsigned flags      = _GetFlags(in_data, aux_states, param, ctx.is_train);
   const NDArray &data = in_data[batchnorm::kData];
 
-  auto &fwd = GetBNForward<DType>(param, ctx, data, flags);
+  auto cached_fwd = GetBNForward<DType>(param, ctx, data, flags);
+  auto &fwd = *cached_fwd;
   const NDArray &out  = out_data[batchnorm::kOut];
 
   // for output memory
@@ -32,6 +32,7 @@
 #include "../convolution-inl.h"
 #include "./mkldnn_ops-inl.h"
 #include "./mkldnn_base-inl.h"
+#include "./mkldnn_primitive_cache.h"
 
 namespace mxnet {
 namespace op {
@@ -116,10 +117,13 @@ class MKLDNNConvForward {
 
 typedef ParamOpSign<ConvolutionParam> MKLDNNConvSignature;
 
-MKLDNNConvForward &GetConvFwd(const ConvolutionParam &param,
-                              const bool is_train, const NDArray &data,
-                              const NDArray &weights, const NDArray *bias,
-                              const NDArray &output);
+/*! \brief the cached forward of a convolution, locked until the handle is destroyed */
+MKLDNNCachedPrimitive<MKLDNNConvForward> GetConvFwd(const ConvolutionParam &param,
+                                                    const bool is_train,
+                                                    const NDArray &data,
+                                                    const NDArray &weights,
+                                                    const NDArray *bias,
+                                                    const NDArray &output);
 
 void MKLDNNConvolutionForwardFullFeature(const MKLDNNConvFullParam &param,
                                          const OpContext &ctx,
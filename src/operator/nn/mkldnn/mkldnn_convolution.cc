@@ -312,15 +312,14 @@ void MKLDNNConvForward::SetNewMem(const mkldnn::memory &data,
   }
 }
 
-MKLDNNConvForward &GetConvFwd(const ConvolutionParam &param,
-                              const bool is_train, const NDArray &data,
-                              const NDArray &weights, const NDArray *bias,
-                              const NDArray &output) {
-#if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNConvSignature, MKLDNNConvForward, OpHash> fwds;
-#else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNConvSignature, MKLDNNConvForward, OpHash> fwds;
-#endif
+MKLDNNCachedPrimitive<MKLDNNConvForward> GetConvFwd(const ConvolutionParam &param,
+                                                    const bool is_train,
+                                                    const NDArray &data,
+                                                    const NDArray &weights,
+                                                    const NDArray *bias,
+                                                    const NDArray &output) {
+  static MKLDNNPrimitiveCache<MKLDNNConvSignature, MKLDNNConvForward, OpHash> fwds(
+      "Convolution");
   MKLDNNConvSignature key(param);
   key.AddSign(is_train);
   // Here we can sign the conv op with NDArray because conv primitive will
@@ -332,15 +331,16 @@ MKLDNNConvForward &GetConvFwd(const ConvolutionParam &param,
   if (bias)
     key.AddSign(*bias);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
+  return fwds.Get(key, [&]() -> MKLDNNConvForward {
     MKLDNNConvFullParam full_param;
     full_param.conv_param = param;
     full_param.mkldnn_param.Init(std::unordered_map<std::string, std::string>());
-    MKLDNNConvForward fwd(full_param, is_train, data, weights, bias, output);
-    it = AddToCache(&fwds, key, fwd);
-  }
-  return it->second;
+    return MKLDNNConvForward(full_param, is_train, data, weights, bias, output);
+  }, [](const MKLDNNConvForward &fwd) {
+    return fwd.fwd_pd.src_primitive_desc().get_size() +
+           fwd.fwd_pd.weights_primitive_desc().get_size() +
+           fwd.fwd_pd.dst_primitive_desc().get_size();
+  });
 }
 
 void MKLDNNConvolutionForwardFullFeature(const MKLDNNConvFullParam &param,
@@ -350,17 +350,13 @@ void MKLDNNConvolutionForwardFullFeature(const MKLDNNConvFullParam &param,
                                          const std::vector<OpReqType> &req,
                                          const std::vector<NDArray> &out_data) {
   TmpMemMgr::Get()->Init(ctx.requested[conv::kTempSpace]);
-
   auto data = in_data[conv::kData];
   if (data.IsView() && data.IsMKLDNNData())
     data = data.Reorder2Default();
-
   auto weight = in_data[conv::kWeight];
   if (weight.IsView() && weight.IsMKLDNNData())
     weight = weight.Reorder2Default();
-
   bool no_bias = param.conv_param.no_bias && !param.mkldnn_param.with_bn;
-
   auto data_mem = data.GetMKLDNNDataReorder(
       fwd->fwd_pd.src_primitive_desc());
   const mkldnn::memory *weight_mem;
@@ -396,14 +392,12 @@ void MKLDNNConvolutionForwardFullFeature(const MKLDNNConvFullParam &param,
     out_mem = CreateMKLDNNMem(out_data[conv::kOut],
                               fwd->fwd_pd.dst_primitive_desc(), req[conv::kOut]);
   }
-
   const mkldnn::memory *bias_mem = nullptr;
   if (!no_bias) {
     bias_mem = in_data[conv::kBias].GetMKLDNNData();
   }
   fwd->SetNewMem(*data_mem, *weight_mem, bias_mem, *out_mem.second);
   MKLDNNStream::Get()->RegisterPrim(fwd->GetFwd());
-
   CommitOutput(out_data[conv::kOut], out_mem);
   MKLDNNStream::Get()->Submit();
 }
@@ -416,11 +410,11 @@ void MKLDNNConvolutionForward(const nnvm::NodeAttrs &attrs,
   MKLDNNConvFullParam param;
   param.conv_param = nnvm::get<ConvolutionParam>(attrs.parsed);
   param.mkldnn_param.Init(std::unordered_map<std::string, std::string>());
-  auto &fwd = GetConvFwd(
+  auto fwd = GetConvFwd(
       param.conv_param, ctx.is_train, in_data[conv::kData], in_data[conv::kWeight],
       param.conv_param.no_bias ? nullptr : &in_data[conv::kBias],
       out_data[conv::kOut]);
-  MKLDNNConvolutionForwardFullFeature(param, ctx, &fwd, in_data, req, out_data);
+  MKLDNNConvolutionForwardFullFeature(param, ctx, &*fwd, in_data, req, out_data);
 }
 
 class MKLDNNConvBackward {
@@ -30,6 +30,7 @@
 #include <mkldnn.hpp>
 #include "../pooling-inl.h"
 #include "./mkldnn_base-inl.h"
+#include "./mkldnn_primitive_cache.h"
 
 namespace mxnet {
 namespace op {
@@ -59,6 +60,8 @@ class MKLDNNPoolingFwd {
                  const OpReqType& req,
                  const mxnet::NDArray *workspace = nullptr);
   void Execute(const NDArray& out_data);
+  /*! \brief bytes of the memory the primitive reads and writes */
+  size_t GetMemSize() const;
 
  private:
   bool is_train_;
@@ -134,10 +137,10 @@ void MKLDNNPoolingGradCompute(const OpContext &ctx, const PoolingParam &param,
                               const NDArray &out_grad, const NDArray &in_data,
                               const NDArray *workspace, const OpReqType req,
                               const NDArray &in_grad);
-MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
-                                const bool is_train,
-                                const NDArray &data,
-                                const NDArray &output);
+MKLDNNCachedPrimitive<MKLDNNPoolingFwd> GetPoolingFwd(const PoolingParam &param,
+                                                      const bool is_train,
+                                                      const NDArray &data,
+                                                      const NDArray &output);
 }  // namespace op
 }  // namespace mxnet
 #endif  // MXNET_USE_MKLDNN == 1
@@ -116,6 +116,14 @@ void MKLDNNPoolingFwd::Execute(const NDArray& out_data) {
   }
 }
 
+size_t MKLDNNPoolingFwd::GetMemSize() const {
+  size_t size = fwd_pd_->src_primitive_desc().get_size() +
+                fwd_pd_->dst_primitive_desc().get_size();
+  if (with_workspace_)
+    size += fwd_pd_->workspace_primitive_desc().get_size();
+  return size;
+}
+
 mkldnn::algorithm GetMKLDNNPoolAlgo(const PoolingParam &param) {
   switch (param.pool_type) {
     case pool_enum::kMaxPooling:
@@ -199,19 +207,12 @@ mkldnn::pooling_forward::primitive_desc GetPoolingFwdPdesc(
   return mkldnn::pooling_forward::primitive_desc(poolingFwd_desc, engine);
 }
 
-MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
-                                const bool is_train,
-                                const NDArray &data,
-                                const NDArray &output) {
-#if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNPoolingSignature,
-                                         MKLDNNPoolingFwd,
-                                         OpHash> pooling_fwds;
-#else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNPoolingSignature,
-                                            MKLDNNPoolingFwd,
-                                            OpHash> pooling_fwds;
-#endif
+MKLDNNCachedPrimitive<MKLDNNPoolingFwd> GetPoolingFwd(const PoolingParam &param,
+                                                      const bool is_train,
+                                                      const NDArray &data,
+                                                      const NDArray &output) {
+  static MKLDNNPrimitiveCache<MKLDNNPoolingSignature, MKLDNNPoolingFwd, OpHash> pooling_fwds(
+      "Pooling");
 
   bool with_workspace = is_train && MKLDNNRequireWorkspace(param);
   MKLDNNPoolingSignature key(param);
@@ -220,8 +221,7 @@ MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
   key.AddSign(data);
   key.AddSign(output);
 
-  auto it = pooling_fwds.find(key);
-  if (it == pooling_fwds.end()) {
+  return pooling_fwds.Get(key, [&]() -> MKLDNNPoolingFwd {
     CHECK_EQ(param.kernel.ndim(), 2) << "Not Implemented";
     auto data_md = data.GetMKLDNNData()->get_primitive_desc().desc();
     int kernel_h_, kernel_w_;
@@ -259,19 +259,19 @@ MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
     }
 
     const mkldnn::algorithm alg = GetMKLDNNPoolAlgo(param);
-    MKLDNNPoolingFwd fwd(data, output, kernel_h_, kernel_w_, stride_h_, stride_w_,
-                         pad_t_, pad_b_, pad_l_, pad_r_, alg, with_workspace, is_train);
-    it = AddToCache(&pooling_fwds, key, fwd);
-  }
-  return it->second;
+    return MKLDNNPoolingFwd(data, output, kernel_h_, kernel_w_, stride_h_, stride_w_,
+                            pad_t_, pad_b_, pad_l_, pad_r_, alg, with_workspace, is_train);
+  }, [](const MKLDNNPoolingFwd &fwd) {
+    return fwd.GetMemSize();
+  });
 }
 
 void MKLDNNPoolingCompute(const OpContext &ctx, const PoolingParam &param,
                           const NDArray &in_data, const OpReqType req,
                           const NDArray &out_data, const NDArray *workspace) {
-  auto &fwd = GetPoolingFwd(param, ctx.is_train, in_data, out_data);
-  fwd.SetNewMem(in_data, out_data, req, workspace);
-  fwd.Execute(out_data);
+  auto fwd = GetPoolingFwd(param, ctx.is_train, in_data, out_data);
+  fwd->SetNewMem(in_data, out_data, req, workspace);
+  fwd->Execute(out_data);
 }
 
 MKLDNNPoolingBwd::MKLDNNPoolingBwd(
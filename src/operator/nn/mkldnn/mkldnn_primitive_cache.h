@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file mkldnn_primitive_cache.h
+ * \brief LRU cache of MKLDNN primitives shared by all threads
+*/
+#ifndef MXNET_OPERATOR_NN_MKLDNN_MKLDNN_PRIMITIVE_CACHE_H_
+#define MXNET_OPERATOR_NN_MKLDNN_MKLDNN_PRIMITIVE_CACHE_H_
+
+#include <dmlc/parameter.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "../../../profiler/profiler.h"
+
+namespace mxnet {
+
+/*!
+ * \brief A primitive taken from a MKLDNNPrimitiveCache. Primitives keep the memory they
+ *  are run with, so the primitive is locked for its holder until the handle is destroyed,
+ *  which has to be after the stream running it is submitted. It stays valid when evicted.
+ *  A handle may also own a private primitive, made when the cached one was in use.
+ */
+template<typename P>
+class MKLDNNCachedPrimitive {
+ public:
+  struct Entry {
+    explicit Entry(P p) : primitive(std::move(p)) {}
+    P primitive;
+    std::mutex mutex;
+    size_t bytes = 0;
+  };
+
+  MKLDNNCachedPrimitive(std::shared_ptr<Entry> entry, std::unique_lock<std::mutex> lock)
+      : entry_(std::move(entry)), lock_(std::move(lock)) {}
+
+  /*! \brief whether the primitive is the cached one rather than a private one */
+  bool cached() const {
+    return lock_.owns_lock();
+  }
+
+  P &operator*() const {
+    return entry_->primitive;
+  }
+
+  P *operator->() const {
+    return &entry_->primitive;
+  }
+
+ private:
+  std::shared_ptr<Entry> entry_;
+  std::unique_lock<std::mutex> lock_;
+};
+
+/*!
+ * \brief Least recently used primitives of one operator, shared by all engine threads.
+ *  Holds at most MXNET_MKLDNN_CACHE_NUM primitives and MXNET_MKLDNN_CACHE_BYTES estimated
+ *  bytes, no limit when -1. Hits, misses and evictions are reported as profiler counters.
+ */
+template<typename Key, typename P, typename Hash>
+class MKLDNNPrimitiveCache {
+ public:
+  typedef MKLDNNCachedPrimitive<P> Handle;
+
+  explicit MKLDNNPrimitiveCache(const std::string &name)
+      : max_entries_(dmlc::GetEnv("MXNET_MKLDNN_CACHE_NUM", -1)),
+        max_bytes_(dmlc::GetEnv("MXNET_MKLDNN_CACHE_BYTES", static_cast<int64_t>(-1))),
+        hit_counter_((name + " Hits").c_str(), Domain()),
+        miss_counter_((name + " Misses").c_str(), Domain()),
+        evict_counter_((name + " Evictions").c_str(), Domain()),
+        bytes_counter_((name + " Bytes").c_str(), Domain()) {}
+
+  /*!
+   * \brief the primitive of key, made by create() if it is not cached
+   * \param bytes estimates the memory held by a primitive made by create
+   */
+  template<typename Create, typename Bytes>
+  Handle Get(const Key &key, Create create, Bytes bytes) {
+    // the entry is locked for the caller only after the cache is unlocked, so a primitive
+    // in use by another thread does not block lookups of other primitives
+    EntryPtr entry = Find(key, create, bytes);
+    std::unique_lock<std::mutex> lock(entry->mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      return Handle(std::move(entry), std::move(lock));
+    }
+    // Another thread runs the cached primitive. Waiting for it would serialize
+    // concurrent calls of the same shape, so the caller gets a primitive of its own.
+    ++contentions_;
+    return Handle(std::make_shared<typename Handle::Entry>(create()),
+                  std::unique_lock<std::mutex>());
+  }
+
+  uint64_t hits() const {
+    return hits_;
+  }
+
+  uint64_t misses() const {
+    return misses_;
+  }
+
+  uint64_t evictions() const {
+    return evictions_;
+  }
+
+  /*! \brief number of private primitives made because the cached one was in use */
+  uint64_t contentions() const {
+    return contentions_;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+  }
+
+ private:
+  typedef std::shared_ptr<typename Handle::Entry> EntryPtr;
+  typedef std::list<std::pair<Key, EntryPtr>> LRUList;
+
+  template<typename Create, typename Bytes>
+  EntryPtr Find(const Key &key, Create create, Bytes bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++hits_;
+        UpdateCounters();
+        return it->second->second;
+      }
+    }
+    // made without the lock, another thread may make the same primitive meanwhile
+    auto entry = std::make_shared<typename Handle::Entry>(create());
+    entry->bytes = bytes(entry->primitive);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++misses_;
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      UpdateCounters();
+      return it->second->second;
+    }
+    lru_.emplace_front(key, entry);
+    index_.emplace(key, lru_.begin());
+    total_bytes_ += entry->bytes;
+    // the new primitive is kept even if it is over the budget by itself
+    while (lru_.size() > 1 &&
+           ((max_entries_ >= 0 && lru_.size() > static_cast<size_t>(max_entries_)) ||
+            (max_bytes_ >= 0 && total_bytes_ > static_cast<uint64_t>(max_bytes_)))) {
+      total_bytes_ -= lru_.back().second->bytes;
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+      ++evictions_;
+    }
+    UpdateCounters();
+    return entry;
+  }
+
+  static profiler::ProfileDomain *Domain() {
+    static profiler::ProfileDomain domain("MKLDNN Primitive Cache");
+    return &domain;
+  }
+
+  /*! \brief publish the statistics to the profiler, called with mutex_ held */
+  void UpdateCounters() {
+    if (profiler::Profiler::Get()->IsProfiling(profiler::Profiler::kMemory)) {
+      hit_counter_ = hits_;
+      miss_counter_ = misses_;
+      evict_counter_ = evictions_;
+      bytes_counter_ = total_bytes_;
+    }
+  }
+
+  const int max_entries_;
+  const int64_t max_bytes_;
+  mutable std::mutex mutex_;
+  /*! \brief most recently used first */
+  LRUList lru_;
+  std::unordered_map<Key, typename LRUList::iterator, Hash> index_;
+  uint64_t total_bytes_ = 0;
+  std::atomic<uint64_t> hits_{0}, misses_{0}, evictions_{0}, contentions_{0};
+  profiler::ProfileCounter hit_counter_, miss_counter_, evict_counter_, bytes_counter_;
+};
+
+}  // namespace mxnet
+
+#endif  // MXNET_OPERATOR_NN_MKLDNN_MKLDNN_PRIMITIVE_CACHE_H_
@@ -39,8 +39,8 @@ static void MKLDNNQuantizedPoolingForward(const nnvm::NodeAttrs& attrs, const Op
     << "mkldnn_quantized_pooling op only supports uint8 and int8 as input type";
   const PoolingParam& param = nnvm::get<PoolingParam>(attrs.parsed);
   auto fwd = GetPoolingFwd(param, ctx.is_train, in_data[0], out_data[0]);
-  fwd.SetNewMem(in_data[0], out_data[0], req[0]);
-  fwd.Execute(out_data[0]);
+  fwd->SetNewMem(in_data[0], out_data[0], req[0]);
+  fwd->Execute(out_data[0]);
   out_data[1].data().dptr<float>()[0] = in_data[1].data().dptr<float>()[0];
   out_data[2].data().dptr<float>()[0] = in_data[2].data().dptr<float>()[0];
 }
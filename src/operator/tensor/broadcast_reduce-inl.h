@@ -143,8 +143,8 @@ MSHADOW_XINLINE void assign(DType* dst, const bool addto, const DType src) {
 
 template<int ndim, typename DType, typename OP>
 MSHADOW_XINLINE void binary_broadcast_assign(const int idx, const bool addto,
-                                             const DType* __restrict lhs,
-                                             const DType* __restrict rhs, DType* out,
+                                             const DType *lhs,
+                                             const DType *rhs, DType* out,
                                              const Shape<ndim>& lshape, const Shape<ndim>& rshape,
                                              const Shape<ndim>& oshape) {
   const Shape<ndim> coord = unravel(idx, oshape);
@@ -175,12 +175,93 @@ MSHADOW_XINLINE void seq_reduce_assign(const int idx, const int M, const bool ad
 
 #else
 
+/*!
+ * \brief out[i] (+)= OP(lhs[i * lstep], rhs[i * rstep]) for one run of the innermost
+ *  dimension. A step is 1, or 0 for an operand broadcast along that dimension, and each
+ *  case gets its own loop so the compiler can vectorize it.
+ */
+template<typename DType, typename OP>
+inline void binary_broadcast_run(const index_t n, const bool addto,
+                                 const DType *lhs, const index_t lstep,
+                                 const DType *rhs, const index_t rstep,
+                                 DType *out) {
+  if (lstep != 0 && rstep != 0) {
+    if (addto) {
+      for (index_t i = 0; i < n; ++i) out[i] += OP::Map(lhs[i], rhs[i]);
+    } else {
+      for (index_t i = 0; i < n; ++i) out[i] = OP::Map(lhs[i], rhs[i]);
+    }
+  } else if (rstep != 0) {
+    const DType l = lhs[0];
+    if (addto) {
+      for (index_t i = 0; i < n; ++i) out[i] += OP::Map(l, rhs[i]);
+    } else {
+      for (index_t i = 0; i < n; ++i) out[i] = OP::Map(l, rhs[i]);
+    }
+  } else if (lstep != 0) {
+    const DType r = rhs[0];
+    if (addto) {
+      for (index_t i = 0; i < n; ++i) out[i] += OP::Map(lhs[i], r);
+    } else {
+      for (index_t i = 0; i < n; ++i) out[i] = OP::Map(lhs[i], r);
+    }
+  } else {
+    const DType v = OP::Map(lhs[0], rhs[0]);
+    for (index_t i = 0; i < n; ++i) assign(&out[i], addto, v);
+  }
+}
+
+/*!
+ * \brief compute out[begin, end) as runs along the innermost dimension that is not 1,
+ *  moving the operands to the next run once per run instead of once per element
+ */
+template<int ndim, typename DType, typename OP>
+void binary_broadcast_range(const index_t begin, const index_t end, const bool addto,
+                            const DType *lhs, const DType *rhs, DType *out,
+                            const Shape<ndim>& lshape, const Shape<ndim>& rshape,
+                            const Shape<ndim>& oshape) {
+  // shapes compacted by BinaryBroadcastShapeCompact are padded with trailing 1s
+  int last = ndim - 1;
+  while (last > 0 && oshape[last] == 1) --last;
+  const index_t lstep = lshape[last] > 1, rstep = rshape[last] > 1;
+  const Shape<ndim> lstride = calc_stride(lshape), rstride = calc_stride(rshape);
+  Shape<ndim> coord = unravel(begin, oshape);
+  for (index_t idx = begin; idx < end;) {
+    const index_t n = std::min<index_t>(oshape[last] - coord[last], end - idx);
+    binary_broadcast_run<DType, OP>(n, addto, lhs + dot(coord, lstride), lstep,
+                                    rhs + dot(coord, rstride), rstep, out + idx);
+    idx += n;
+    // carry into the outer dimensions
+    coord[last] = 0;
+    for (int i = last - 1; i >= 0 && ++coord[i] >= oshape[i]; --i) {
+      coord[i] = 0;
+    }
+  }
+}
+
+/*!
+ * \brief Broadcast a binary op on the CPU. The scalar, row, column and general patterns
+ *  all reduce to unit stride runs of the innermost dimension, with one operand held when
+ *  it is broadcast along it, and the output is split into contiguous blocks per thread.
+ */
 template<int ndim, typename DType, typename OP>
-void binary_broadcast_compute(const int N, const bool addto, const DType *lhs,
+void binary_broadcast_compute(const index_t N, const bool addto, const DType *lhs,
                               const DType *rhs, DType *out, const Shape<ndim> lshape,
                               const Shape<ndim> rshape, const Shape<ndim> oshape) {
-  for (int idx = 0; idx < N; ++idx) {
-    binary_broadcast_assign<ndim, DType, OP>(idx, addto, lhs, rhs, out, lshape, rshape, oshape);
+  // below this many elements per thread, starting the threads costs more than it saves
+  const index_t kMinBlock = 4096;
+  const int omp_threads = std::max(1, std::min<int>(
+    engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), N / kMinBlock));
+  if (omp_threads < 2) {
+    binary_broadcast_range<ndim, DType, OP>(0, N, addto, lhs, rhs, out, lshape, rshape, oshape);
+    return;
+  }
+  const index_t block = (N + omp_threads - 1) / omp_threads;
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int i = 0; i < omp_threads; ++i) {
+    const index_t begin = i * block;
+    binary_broadcast_range<ndim, DType, OP>(begin, std::min(begin + block, N), addto,
+                                            lhs, rhs, out, lshape, rshape, oshape);
   }
 }
 
@@ -188,7 +269,7 @@ template<int ndim, typename DType, typename OP>
 void BinaryBroadcastComputeImpl(Stream<cpu> *s, const OpReqType req,
                                 const TBlob& lhs, const TBlob& rhs, const TBlob& out) {
   if (req == kNullOp) return;
-  int N = out.shape_.Size();
+  index_t N = out.shape_.Size();
   binary_broadcast_compute<ndim, DType, OP>(N, req == kAddTo, lhs.dptr<DType>(), rhs.dptr<DType>(),
                            out.dptr<DType>(), lhs.shape_.get<ndim>(), rhs.shape_.get<ndim>(),
                            out.shape_.get<ndim>());
@@ -273,8 +354,8 @@ size_t ReduceWorkspaceSize(Stream<cpu> *s, const TShape& small, const OpReqType
 
 template<typename Reducer, int ndim, typename DType, typename OP1, typename OP2>
 MSHADOW_XINLINE void seq_reduce_assign(const int idx, const int M, const bool addto,
-                                       const DType* __restrict big, const DType* __restrict lhs,
-                                       const DType* __restrict rhs, DType *small,
+                                       const DType* __restrict big, const DType *lhs,
+                                       const DType *rhs, DType *small,
                                        const Shape<ndim>& big_shape, const Shape<ndim>& lhs_shape0,
                                        const Shape<ndim>& rhs_shape0,
                                        const Shape<ndim>& small_shape, const Shape<ndim>& rshape,
@@ -340,6 +340,123 @@ void TakeOpForward<cpu>(const nnvm::NodeAttrs& attrs,
   });
 }
 
+/*!
+ * \brief Counting sort of the positions of data by the weight row they index, clipped to
+ *  [0, num_rows) as in the forward take. Afterwards the positions of row v are
+ *  order[v ? row_end[v - 1] : 0, row_end[v]), in increasing order.
+ * \return the number of distinct rows
+ */
+template<typename IType>
+inline nnvm::dim_t BucketEmbeddingRows(const IType* data, const nnvm::dim_t data_size,
+                                       const nnvm::dim_t num_rows, nnvm::dim_t* row_end,
+                                       nnvm::dim_t* order) {
+  using nnvm::dim_t;
+  auto row_of = [num_rows](const IType idx) {
+    const dim_t v = static_cast<dim_t>(idx);
+    return v <= 0 ? 0 : (v >= num_rows ? num_rows - 1 : v);
+  };
+  std::fill(row_end, row_end + num_rows, 0);
+  for (dim_t i = 0; i < data_size; ++i) {
+    ++row_end[row_of(data[i])];
+  }
+  // counts to the start of each bucket
+  dim_t start = 0, num_nonzero = 0;
+  for (dim_t v = 0; v < num_rows; ++v) {
+    const dim_t count = row_end[v];
+    row_end[v] = start;
+    start += count;
+    num_nonzero += count > 0;
+  }
+  // filling a bucket moves its start to its end
+  for (dim_t i = 0; i < data_size; ++i) {
+    order[row_end[row_of(data[i])]++] = i;
+  }
+  return num_nonzero;
+}
+
+/*!
+ * \brief dst (+)= the sum of the rows of src at positions order[begin, end)
+ */
+template<typename DType>
+inline void SumEmbeddingRows(DType* dst, const DType* src, const nnvm::dim_t* order,
+                             nnvm::dim_t begin, const nnvm::dim_t end,
+                             const nnvm::dim_t row_length, const bool addto) {
+  using nnvm::dim_t;
+  if (!addto) {
+    if (begin == end) {
+      std::fill(dst, dst + row_length, DType(0));
+      return;
+    }
+    std::copy(src + order[begin] * row_length, src + (order[begin] + 1) * row_length, dst);
+    ++begin;
+  }
+  for (dim_t k = begin; k < end; ++k) {
+    const DType* row = src + order[k] * row_length;
+    for (dim_t j = 0; j < row_length; ++j) {
+      dst[j] += row[j];
+    }
+  }
+}
+
+/*!
+ * \brief Reduce the buckets of BucketEmbeddingRows into num_out rows of grad in parallel.
+ *  Row k of grad is the weight row rows[k], or k when rows is null.
+ */
+template<typename DType, typename RType>
+void SumEmbeddingBuckets(DType* grad, const DType* ograd, const RType* rows,
+                         const nnvm::dim_t num_out, const nnvm::dim_t* row_end,
+                         const nnvm::dim_t* order, const nnvm::dim_t row_length,
+                         const bool addto) {
+  using nnvm::dim_t;
+  // rows differ in their number of positions, so they are handed out dynamically
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount()) \
+    schedule(dynamic, 64)
+  for (dim_t k = 0; k < num_out; ++k) {
+    const dim_t v = rows == nullptr ? k : static_cast<dim_t>(rows[k]);
+    SumEmbeddingRows(grad + k * row_length, ograd, order, v ? row_end[v - 1] : 0, row_end[v],
+                     row_length, addto);
+  }
+}
+
+template<>
+void EmbeddingOpBackward<cpu>(const nnvm::NodeAttrs& attrs,
+                              const OpContext& ctx,
+                              const std::vector<TBlob>& inputs,
+                              const std::vector<OpReqType>& req,
+                              const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using nnvm::dim_t;
+  CHECK_EQ(inputs.size(), 2U);
+  CHECK_EQ(outputs.size(), 2U);
+  CHECK_EQ(req[embedding::kData], kNullOp)
+          << "Embedding layer doesn't support calculate data gradient";
+  CHECK_EQ(outputs[1].type_flag_, inputs[0].type_flag_);
+  const OpReqType req_weight = req[embedding::kWeight];
+  if (req_weight == kNullOp) return;
+  CHECK(req_weight == kWriteTo || req_weight == kAddTo) << "wrong req";
+
+  const TBlob& ograd = inputs[0];
+  const TBlob& data = inputs[1];
+  const TBlob& grad = outputs[1];
+  const dim_t num_rows = grad.shape_[0];
+  const dim_t row_length = grad.shape_[1];
+  const dim_t data_size = data.shape_.Size();
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+  Tensor<cpu, 1, dim_t> workspace =
+    ctx.requested[embedding::kTempSpace].get_space_typed<cpu, 1, dim_t>(
+      Shape1(num_rows + data_size), s);
+  dim_t* row_end = workspace.dptr_;
+  dim_t* order = row_end + num_rows;
+  MSHADOW_TYPE_SWITCH(grad.type_flag_, DType, {
+    MSHADOW_TYPE_SWITCH(data.type_flag_, IType, {
+      BucketEmbeddingRows(data.dptr<IType>(), data_size, num_rows, row_end, order);
+      SumEmbeddingBuckets<DType, dim_t>(grad.dptr<DType>(), ograd.dptr<DType>(), nullptr,
+                                        num_rows, row_end, order, row_length,
+                                        req_weight == kAddTo);
+    });
+  });
+}
+
 template<>
 inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
                                                   const OpContext& ctx,
@@ -348,27 +465,25 @@ inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
                                                   const OpReqType req,
                                                   const NDArray& output) {
   using namespace mshadow;
-  using namespace mxnet_op;
-  using namespace mshadow::expr;
   using namespace rowsparse;
   using nnvm::dim_t;
   if (req == kNullOp) return;
   CHECK_EQ(req, kWriteTo) << "SparseEmbedding layer doesn't support "
                           << "weight gradient calculation with req != write";
 
-  // Request temporary storage for marking non-zero rows and prefix sum
+  // Request temporary storage for the bucket ends and the bucketed positions
   Stream<cpu> *s = ctx.get_stream<cpu>();
   dim_t num_rows = output.shape()[0];
   dim_t row_length = output.shape()[1];
-  size_t workspace_size = num_rows * sizeof(dim_t);
-  Tensor<cpu, 1, char> workspace =
-    ctx.requested[embedding::kTempSpace].get_space_typed<cpu, 1, char>(
-      Shape1(workspace_size), s);
-  dim_t* row_flg = reinterpret_cast<dim_t*>(workspace.dptr_);
-  // prefix sum array re-uses the row_flg array temp space
-  dim_t* prefix_sum = row_flg;
   dim_t data_size = static_cast<dim_t>(data.shape_.Size());
-
+  Tensor<cpu, 1, dim_t> workspace =
+    ctx.requested[embedding::kTempSpace].get_space_typed<cpu, 1, dim_t>(
+      Shape1(num_rows + data_size), s);
+  dim_t* row_end = workspace.dptr_;
+  dim_t* order = row_end + num_rows;
+
+  // the result is the same whether or not deterministic is set: the positions of a row
+  // are always summed in increasing order
   MSHADOW_TYPE_SWITCH(data.type_flag_, IType, {
     MSHADOW_SGL_DBL_TYPE_SWITCH(ograd.type_flag_, DType, {
       MSHADOW_IDX_TYPE_SWITCH(output.aux_type(kIdx), RType, {
@@ -381,37 +496,23 @@ inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
           bool is_valid = CheckIndexOutOfBound(data_ptr, data.shape_.Size(), min, max);
           CHECK(is_valid) << "Embedding input contains data out of bound";
         }
-        // mark row flags
-        Fill<false>(s, TBlob(row_flg, Shape1(num_rows), cpu::kDevMask), kWriteTo, 0);
-        Kernel<MarkRowFlgKernel, cpu>::Launch(s, data_size, row_flg, data.dptr<IType>());
-        // calculate inclusive prefix sum
-        // TODO(haibin) ideally this is should be done in parallel
-        prefix_sum[0] = row_flg[0];
-        for (dim_t i = 1; i < num_rows; i++) {
-          prefix_sum[i] = prefix_sum[i - 1] + row_flg[i];
-        }
         // total number of non-zero rows
-        dim_t nnr = prefix_sum[num_rows - 1];
+        const dim_t nnr = BucketEmbeddingRows(data.dptr<IType>(), data_size, num_rows,
+                                              row_end, order);
         if (nnr == 0) {
           FillZerosRspImpl(s, output);
           return;
         }
         output.CheckAndAlloc({Shape1(nnr)});
         RType* grad_row_idx = output.aux_data(kIdx).dptr<RType>();
-        // fill row_idx array of output matrix, using the row_flg values
-        Kernel<FillRspRowIdxKernel, cpu>::Launch(s, num_rows,
-            grad_row_idx, prefix_sum, num_rows);
-        // prefill with zeros
-        DType* grad_data = output.data().dptr<DType>();
-        Fill<false>(s, TBlob(grad_data, Shape1(nnr * row_length),
-            cpu::kDevMask), kWriteTo, 0);
-        // add the final gradients
-        const int num_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-        dim_t segment_len = (nnr + num_threads - 1) / num_threads;
-        Kernel<AddTakeGradRspKernel, cpu>::Launch(s, num_threads, grad_data, prefix_sum,
-                                                  ograd.dptr<DType>(), row_length,
-                                                  data.dptr<IType>(), data_size, segment_len,
-                                                  num_rows);
+        for (dim_t v = 0, k = 0; v < num_rows; ++v) {
+          if (row_end[v] > (v ? row_end[v - 1] : 0)) {
+            grad_row_idx[k++] = static_cast<RType>(v);
+          }
+        }
+        // each non-zero row is written once
+        SumEmbeddingBuckets(output.data().dptr<DType>(), ograd.dptr<DType>(), grad_row_idx,
+                            nnr, row_end, order, row_length, false);
       });
     });
   });
@@ -193,42 +193,65 @@ struct fill_ind {
   }
 };
 
+/*!
+ * \brief Selects the top K of each of the rows of N values in `work` into the first K slots of
+ *  the rows of `dat` and `ind`, in sorted order. Ties are broken by the lower index, as the stable
+ *  sort of the gpu path does. Small K scan the row once with a heap of the K best positions,
+ *  medium K use nth_element and only the K winners are sorted.
+ */
 template<typename DType>
 MSHADOW_FORCE_INLINE void TopKSort(const Tensor<cpu, 1, DType>& dat,
                                    const Tensor<cpu, 1, int>& ind,
                                    const Tensor<cpu, 1, char>& work,
                                    int K, int N, bool is_ascend,
                                    Stream<cpu> *s) {
-  // Use full sort when K is relatively large.
+  // Use full sort when K is relatively large, and a heap when it is tiny.
   const bool full_sort(K*8 > N);
+  const bool heap_select(K*64 <= N);
   // Batch size.
   const int M(work.size(0)/(sizeof(DType)*N));
   const int omp_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
   #pragma omp parallel for num_threads(omp_threads)
   for (int i = 0; i < M; ++i) {
     // Tensor `work` stores the flattened source data, while `dat` stores the sorted result.
-    DType *vals = reinterpret_cast<DType*>(work.dptr_);
+    const DType *vals = reinterpret_cast<const DType*>(work.dptr_)+i*N;
     DType *sorted_vals = dat.dptr_+i*N;
     int *indices = ind.dptr_+i*N;
-    if (is_ascend) {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
+    // Whether position i1 of the row ranks before position i2.
+    auto before = [&](int i1, int i2) {
+      return (is_ascend ? vals[i1] < vals[i2] : vals[i1] > vals[i2]) ||
+             (vals[i1] == vals[i2] && i1 < i2);
+    };
+    if (heap_select) {
+      // Heap of the K best positions seen so far with the worst of them on top.
+      for (int j = 0; j < K; ++j) {
+        indices[j] = j;
+      }
+      std::make_heap(indices, indices+K, before);
+      // Later positions lose ties, so a strict comparison with the worst value decides.
+      DType worst(vals[indices[0]]);
+      for (int j = K; j < N; ++j) {
+        if (is_ascend ? vals[j] < worst : vals[j] > worst) {
+          std::pop_heap(indices, indices+K, before);
+          indices[K-1] = j;
+          std::push_heap(indices, indices+K, before);
+          worst = vals[indices[0]];
+        }
       }
+      std::sort_heap(indices, indices+K, before);
     } else {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
+      for (int j = 0; j < N; ++j) {
+        indices[j] = j;
       }
+      if (!full_sort) {
+        std::nth_element(indices, indices+K-1, indices+N, before);
+      }
+      std::sort(indices, indices+(full_sort ? N : K), before);
     }
     for (int j = 0; j < K; ++j) {
       sorted_vals[j] = vals[indices[j]];
+      // Indices into the flattened batch, as the gpu sort produces them.
+      indices[j] += i*N;
     }
   }
 }
@@ -453,8 +476,11 @@ void TopKImpl(const RunContext &ctx,
     workspace_curr_ptr += temp_size;
   }
 
-  mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
-    kWriteTo, indices.dptr_);
+  // The cpu sort numbers the positions of each batch itself.
+  if (!std::is_same<xpu, cpu>::value) {
+    mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
+      kWriteTo, indices.dptr_);
+  }
   CHECK_EQ(indices.CheckContiguous(), true);
 
   // 2. Perform inplace batch sort.
@@ -23,11 +23,13 @@
  * \brief implements profiler
  */
 #include <dmlc/base.h>
+#include <dmlc/json.h>
 #include <dmlc/logging.h>
 #include <mxnet/base.h>
 #include <fstream>
 #include <thread>
 #include <iomanip>
+#include <cmath>
 #include "./profiler.h"
 
 namespace mxnet {
@@ -38,9 +40,44 @@ inline float MicroToMilli(const DType micro) {
   return static_cast<float>(static_cast<double>(micro) / 1000);
 }
 
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr uint64_t LatencyHistogram::kLinearLimit;
+constexpr size_t LatencyHistogram::kNumBuckets;
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  if (!count_) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(
+    std::ceil(percentile * static_cast<double>(count_))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      uint64_t value = i;
+      if (i >= kLinearLimit) {
+        // middle of the bucket
+        const size_t octave = (i - kLinearLimit) >> kSubBucketBits;
+        const uint64_t mantissa = ((i - kLinearLimit) & ((1 << kSubBucketBits) - 1))
+                                  + (1 << kSubBucketBits);
+        value = (mantissa << (octave + 1)) + (uint64_t(1) << octave);
+      }
+      return std::min(std::max(value, min_), max_);
+    }
+  }
+  return max_;
+}
+
 void AggregateStats::OnProfileStat(const ProfileStat& stat) {
   std::unique_lock<std::mutex> lk(m_);
-  stat.SaveAggregate(&stats_[stat.categories_.c_str()][stat.name_.c_str()]);
+  StatData &data = stats_[stat.categories_.c_str()][stat.name_.c_str()];
+  stat.SaveAggregate(&data);
+  if (data.type_ == StatData::kDuration) {
+    const char *device = stat.DeviceName();
+    histograms_[stat.categories_.c_str()][std::make_pair(stat.name_.c_str(),
+                                                         device ? device : "")]
+      .Add(stat.items_[1].timestamp_ - stat.items_[0].timestamp_);
+  }
 }
 
 void AggregateStats::Dump(std::ostream& os, bool clear) {
@@ -116,12 +153,78 @@ void AggregateStats::Dump(std::ostream& os, bool clear) {
       }
       os << std::endl;
     }
+    auto hist = histograms_.find(type);
+    if (hist != histograms_.end() && !hist->second.empty()) {
+      os << type << " latency" << std::endl << "=================" << std::endl;
+      os << std::setw(25) << std::left  << "Name"
+         << std::setw(16) << std::left  << "Device";
+      for (const char *title : {"P50 (ms)", "P90 (ms)", "P99 (ms)", "P999 (ms)"}) {
+        os << " " << std::setw(16) << std::right << title;
+      }
+      os << std::endl;
+      os << std::setw(25) << std::left  << "----"
+         << std::setw(16) << std::left  << "------";
+      for (const char *title : {"--------", "--------", "--------", "---------"}) {
+        os << " " << std::setw(16) << std::right << title;
+      }
+      os << std::endl;
+      for (const auto& iter : hist->second) {
+        os << std::setw(25) << std::left << iter.first.first
+           << std::setw(16) << std::left << iter.first.second;
+        for (double p : {0.5, 0.9, 0.99, 0.999}) {
+          os << " " << std::fixed << std::setw(16) << std::setprecision(4) << std::right
+             << MicroToMilli(iter.second.Percentile(p));
+        }
+        os << std::endl;
+      }
+      os << std::endl;
+    }
   }
   os << std::flush;
   os.copyfmt(state);
   if (clear) {
     stats_.clear();
+    histograms_.clear();
+  }
+}
+
+void AggregateStats::DumpLatency(std::ostream& os, bool reset) {
+  std::map<std::string, HistogramMap> histograms;
+  {
+    std::unique_lock<std::mutex> lk(m_);
+    if (reset) {
+      histograms.swap(histograms_);
+    } else {
+      histograms = histograms_;
+    }
+  }
+  // names of operators, tasks and domains are set by users and may need escaping
+  dmlc::JSONWriter writer(&os);
+  os << "{";
+  bool first_type = true;
+  for (const auto& stat : histograms) {
+    os << (first_type ? "" : ",");
+    writer.WriteString(stat.first);
+    os << ":[";
+    first_type = false;
+    bool first = true;
+    for (const auto& iter : stat.second) {
+      const LatencyHistogram &h = iter.second;
+      os << (first ? "" : ",") << "{\"name\":";
+      writer.WriteString(iter.first.first);
+      os << ",\"device\":";
+      writer.WriteString(iter.first.second);
+      os << ",\"count\":" << h.count()
+         << ",\"mean\":" << static_cast<double>(h.sum()) / h.count()
+         << ",\"min\":" << h.min() << ",\"max\":" << h.max()
+         << ",\"p50\":" << h.Percentile(0.5) << ",\"p90\":" << h.Percentile(0.9)
+         << ",\"p99\":" << h.Percentile(0.99) << ",\"p999\":" << h.Percentile(0.999)
+         << "}";
+      first = false;
+    }
+    os << "]";
   }
+  os << "}";
 }
 
 }  // namespace profiler
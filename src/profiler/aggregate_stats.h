@@ -20,11 +20,14 @@
 #ifndef MXNET_PROFILER_AGGREGATE_STATS_H_
 #define MXNET_PROFILER_AGGREGATE_STATS_H_
 
+#include <algorithm>
 #include <string>
 #include <map>
 #include <cstdint>
 #include <ostream>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "./profiler.h"
 
 namespace mxnet {
@@ -32,6 +35,64 @@ namespace profiler {
 
 struct ProfileStat;
 
+/*!
+ * \brief Log-bucketed latency histogram in the style of HdrHistogram. Values below 64 have
+ *        their own buckets, larger values share 32 buckets per power of two, so reported
+ *        percentiles are within about 3% of the recorded values.
+ */
+class LatencyHistogram {
+ public:
+  /*! \brief Record one value */
+  inline void Add(uint64_t value) {
+    if (buckets_.empty()) {
+      buckets_.resize(kNumBuckets, 0);
+    }
+    ++buckets_[BucketIndex(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  /*!
+   * \brief Value at a percentile
+   * \param percentile Percentile between 0 and 1
+   * \return Representative value of the bucket holding the percentile, 0 if empty
+   */
+  uint64_t Percentile(double percentile) const;
+
+  uint64_t count() const { return count_; }
+  uint64_t sum() const { return sum_; }
+  uint64_t min() const { return count_ ? min_ : 0; }
+  uint64_t max() const { return max_; }
+
+ private:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr uint64_t kLinearLimit = 2 << kSubBucketBits;
+  static constexpr int kMaxBits = 48;
+  static constexpr size_t kNumBuckets =
+    kLinearLimit + (kMaxBits - kSubBucketBits - 1) * (1 << kSubBucketBits);
+
+  static inline size_t BucketIndex(uint64_t value) {
+    if (value < kLinearLimit) {
+      return static_cast<size_t>(value);
+    }
+    int msb = 63;
+    while (!(value >> msb)) --msb;
+    if (msb >= kMaxBits) {
+      return kNumBuckets - 1;
+    }
+    const int shift = msb - kSubBucketBits;
+    return static_cast<size_t>(kLinearLimit + (msb - kSubBucketBits - 1) * (1 << kSubBucketBits)
+                               + ((value >> shift) - (1 << kSubBucketBits)));
+  }
+
+  std::vector<uint64_t> buckets_;
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
 class AggregateStats {
  public:
   struct StatData {
@@ -61,12 +122,24 @@ class AggregateStats {
    * \param clear Delete all of the current statistics after printing
    */
   void Dump(std::ostream& os, bool clear);
+  /*!
+   * \brief Write the latency percentiles of durations, in microseconds, as json:
+   *        { category: [ { "name", "device", "count", "mean", "min", "max",
+   *        "p50", "p90", "p99", "p999" }, ... ], ... }
+   * \param reset Delete the latency histograms after the snapshot
+   */
+  void DumpLatency(std::ostream& os, bool reset);
 
  private:
+  /*! \brief Latency histograms of a category by (name, device) */
+  typedef std::map<std::pair<std::string, std::string>, LatencyHistogram> HistogramMap;
+
   /*! \brief Should rarely collide, so most locks should occur only in user-space (futex) */
   std::mutex m_;
   /* !\brief Stat type -> State name -> Stats */
   std::map<std::string, std::unordered_map<std::string, StatData>> stats_;
+  /* !\brief Stat type -> Latency histograms of durations */
+  std::map<std::string, HistogramMap> histograms_;
 };
 
 }  // namespace profiler
@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file binary_trace.cc
+ * \brief implements the binary trace writer
+ */
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <dmlc/thread_local.h>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include "./binary_trace.h"
+
+namespace mxnet {
+namespace profiler {
+
+constexpr uint32_t TraceRecord::kCategoryPid;
+
+namespace {
+
+struct ThreadTraceRing {
+  std::shared_ptr<TraceRing> ring;
+};
+
+constexpr char kTraceMagic[8] = {'M', 'X', 'T', 'R', 'A', 'C', 'E', '1'};
+
+template<typename T>
+void WritePOD(std::ofstream *file, const T &value) {
+  file->write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}  // namespace
+
+BinaryTraceWriter::BinaryTraceWriter()
+  : ring_size_(dmlc::GetEnv("MXNET_PROFILER_RING_SIZE", static_cast<size_t>(1 << 14))) {
+  buffer_.resize(1024);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter() {
+  Close();
+}
+
+void BinaryTraceWriter::Open(const std::string &filename,
+                             const std::vector<std::string> &device_names,
+                             float flush_period) {
+  Close();
+  {
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    // records from before this trace are not part of it
+    std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+    for (const auto &ring : rings_) {
+      while (ring->Pop(buffer_.data(), buffer_.size())) {}
+    }
+    file_.open(filename, std::ios::binary | std::ios::trunc | std::ios::out);
+    CHECK(file_.is_open()) << "Cannot open " << filename;
+    file_.write(kTraceMagic, sizeof(kTraceMagic));
+    WritePOD(&file_, static_cast<uint32_t>(sizeof(TraceRecord)));
+    WritePOD(&file_, static_cast<uint32_t>(device_names.size()));
+    for (const std::string &name : device_names) {
+      WritePOD(&file_, static_cast<uint32_t>(name.size()));
+      file_.write(name.data(), name.size());
+    }
+    dropped_base_ = dropped_released_;
+    for (const auto &ring : rings_) dropped_base_ += ring->dropped();
+    dropped_written_ = dropped_base_;
+  }
+  std::lock_guard<std::mutex> lock(thread_mutex_);
+  stop_ = false;
+  const auto period = std::chrono::milliseconds(static_cast<int64_t>(flush_period * 1000.0f));
+  thread_ = std::thread([this, period]() {
+    std::unique_lock<std::mutex> lock(thread_mutex_);
+    while (!stop_) {
+      thread_cv_.wait_for(lock, period, [this]() { return stop_; });
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  });
+}
+
+void BinaryTraceWriter::Close() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_ = true;
+  }
+  thread_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  if (file_.is_open()) {
+    WriteRecords();
+    file_.close();
+  }
+}
+
+void BinaryTraceWriter::Flush() {
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  if (file_.is_open()) {
+    WriteRecords();
+    file_.flush();
+  }
+}
+
+void BinaryTraceWriter::Record(const TraceRecord &record) {
+  ThreadRing()->Push(record);
+}
+
+TraceRing *BinaryTraceWriter::ThreadRing() {
+  std::shared_ptr<TraceRing> &ring = dmlc::ThreadLocalStore<ThreadTraceRing>::Get()->ring;
+  if (!ring) {
+    ring = std::make_shared<TraceRing>(ring_size_);
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.push_back(ring);
+  }
+  return ring.get();
+}
+
+void BinaryTraceWriter::WriteRecords() {
+  std::vector<std::shared_ptr<TraceRing>> rings;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings = rings_;
+  }
+  uint64_t dropped = dropped_released_;
+  for (const auto &ring : rings) {
+    size_t n;
+    while ((n = ring->Pop(buffer_.data(), buffer_.size())) > 0) {
+      file_.write(reinterpret_cast<const char*>(buffer_.data()), n * sizeof(TraceRecord));
+    }
+    dropped += ring->dropped();
+  }
+  rings.clear();
+  if (dropped > dropped_written_) {
+    // lost records show up as a counter in the trace
+    TraceRecord record;
+    memset(&record, 0, sizeof(record));
+    record.timestamp[0] = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    record.thread_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    record.arg = dropped - dropped_base_;
+    record.process_id = TraceRecord::kCategoryPid;
+    record.event_type[0] = 'C';
+    strncpy(record.categories, "profiler", sizeof(record.categories) - 1);
+    strncpy(record.name, "Dropped Records", sizeof(record.name) - 1);
+    file_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    dropped_written_ = dropped;
+  }
+  // rings of exited threads are released once drained
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                              [this](const std::shared_ptr<TraceRing> &ring) {
+                                if (ring.use_count() == 1 && ring->Empty()) {
+                                  dropped_released_ += ring->dropped();
+                                  return true;
+                                }
+                                return false;
+                              }), rings_.end());
+}
+
+}  // namespace profiler
+}  // namespace mxnet
@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file binary_trace.h
+ * \brief Streams profile statistics to a compact binary trace file through per-thread
+ *  ring buffers, written by a background thread.
+ */
+#ifndef MXNET_PROFILER_BINARY_TRACE_H_
+#define MXNET_PROFILER_BINARY_TRACE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mxnet {
+namespace profiler {
+
+/*!
+ * \brief One profile statistic in a binary trace, holding up to two sub-events (ie the
+ *  begin and end of a duration). Layout of the file:
+ *    char[8] magic "MXTRACE1", uint32 record size, uint32 number of devices,
+ *    per device: uint32 name length, name characters,
+ *    then records until the end of the file.
+ *  mxnet.profiler.convert_trace turns a binary trace into chrome://tracing json.
+ */
+struct TraceRecord {
+  /*! \brief pid of statistics not on a device, the process is named after the category */
+  static constexpr uint32_t kCategoryPid = 0xffffffff;
+  /*! \brief sub-event timestamps in microseconds */
+  uint64_t timestamp[2];
+  /*! \brief hash of the thread id */
+  uint64_t thread_id;
+  /*! \brief counter value, or scope of an instant marker */
+  uint64_t arg;
+  /*! \brief device index, or kCategoryPid */
+  uint32_t process_id;
+  /*! \brief sub-event types, '\0' if there is no second sub-event */
+  char event_type[2];
+  char padding[2];
+  char categories[24];
+  char name[128];
+};
+
+static_assert(sizeof(TraceRecord) == 192, "TraceRecord layout is part of the file format");
+
+/*!
+ * \brief Bounded single producer, single consumer queue of records. Records pushed while
+ *  it is full are dropped and counted, so recording never blocks or allocates.
+ */
+class TraceRing {
+ public:
+  explicit TraceRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    records_.reset(new TraceRecord[size]);
+    mask_ = size - 1;
+  }
+
+  /*! \brief called by the owning thread only */
+  inline bool Push(const TraceRecord &record) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    records_[head & mask_] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief move up to max_records records to out, called by one consumer at a time
+   * \return number of records moved
+   */
+  inline size_t Pop(TraceRecord *out, size_t max_records) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(head - tail, max_records));
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = records_[(tail + i) & mask_];
+    }
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  inline bool Empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+  }
+
+  inline uint64_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::unique_ptr<TraceRecord[]> records_;
+  uint64_t mask_;
+  /*! \brief on separate cache lines, written by the producer and the consumer */
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+/*!
+ * \brief Writes the records of all threads to a binary trace file. Each recording thread
+ *  gets a ring of MXNET_PROFILER_RING_SIZE records, drained every flush period and on Flush().
+ */
+class BinaryTraceWriter {
+ public:
+  BinaryTraceWriter();
+  ~BinaryTraceWriter();
+
+  /*!
+   * \brief start a new trace file and the background writer
+   * \param filename trace file, truncated
+   * \param device_names names of the devices, indexed by TraceRecord::process_id
+   * \param flush_period seconds between background flushes
+   */
+  void Open(const std::string &filename, const std::vector<std::string> &device_names,
+            float flush_period);
+  /*! \brief flush, stop the background writer and close the file */
+  void Close();
+  /*! \brief write all recorded records to the file */
+  void Flush();
+  /*! \brief record from the calling thread, dropped if its ring is full */
+  void Record(const TraceRecord &record);
+
+ private:
+  /*! \brief ring of the calling thread, made on first use */
+  TraceRing *ThreadRing();
+  /*! \brief drain the rings to the file, called with file_mutex_ held */
+  void WriteRecords();
+
+  const size_t ring_size_;
+  /*! \brief rings of all threads, kept until drained after their thread exits */
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<TraceRing>> rings_;
+  std::mutex file_mutex_;
+  std::ofstream file_;
+  std::vector<TraceRecord> buffer_;
+  /*! \brief records dropped before the file was opened, and up to the last counter written */
+  uint64_t dropped_base_ = 0;
+  /*! \brief records dropped by the released rings */
+  uint64_t dropped_released_ = 0;
+  uint64_t dropped_written_ = 0;
+  /*! \brief background writer */
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable thread_cv_;
+  bool stop_ = true;
+};
+
+}  // namespace profiler
+}  // namespace mxnet
+
+#endif  // MXNET_PROFILER_BINARY_TRACE_H_
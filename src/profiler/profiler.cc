@@ -82,6 +82,10 @@ Profiler::Profiler()
   if (dmlc::GetEnv("MXNET_PROFILER_AUTOSTART", 0)) {
     this->state_ = ProfilerState::kRunning;
     this->enable_output_ = true;
+    if (dmlc::GetEnv("MXNET_PROFILER_BINARY_TRACE", 0)) {
+      this->filename_ = "profile.trace";
+      SetBinaryTrace(true, 1.0f);
+    }
     // Since we want to avoid interfering with pure-VTune analysis runs, for not set,
     // vtune will be recording based upon whether "Start" or "STart Paused" was selected
     vtune::vtune_resume();
@@ -128,7 +132,8 @@ void Profiler::SetConfig(int mode,
                          std::string output_filename,
                          bool continuous_dump,
                          float dump_period,
-                         bool aggregate_stats) {
+                         bool aggregate_stats,
+                         bool binary_trace) {
   CHECK(!continuous_dump || dump_period > 0);
   std::lock_guard<std::recursive_mutex> lock{this->m_};
   this->mode_ = mode;
@@ -137,7 +142,9 @@ void Profiler::SetConfig(int mode,
   if (!this->filename_.empty()) {
     ::unlink(this->filename_.c_str());
   }
-  SetContinuousProfileDump(continuous_dump, dump_period);
+  // The binary trace is written continuously by its own thread
+  SetContinuousProfileDump(continuous_dump && !binary_trace, dump_period);
+  SetBinaryTrace(binary_trace, dump_period);
   // Adjust whether storing aggregate stats as necessary
   if (aggregate_stats) {
     if (!aggregate_stats_) {
@@ -148,6 +155,24 @@ void Profiler::SetConfig(int mode,
   }
 }
 
+void Profiler::SetBinaryTrace(bool binary_trace, float flush_period) {
+  std::lock_guard<std::recursive_mutex> lock{this->m_};
+  if (binary_trace) {
+    if (!trace_writer_) {
+      trace_writer_.reset(new BinaryTraceWriter());
+    }
+    std::vector<std::string> device_names;
+    for (size_t i = 0; i < DeviceCount(); ++i) {
+      device_names.emplace_back(profile_stat[i].dev_name_);
+    }
+    trace_writer_->Open(filename_, device_names, flush_period);
+    binary_trace_ = true;
+  } else if (binary_trace_) {
+    binary_trace_ = false;
+    trace_writer_->Close();
+  }
+}
+
 /*
  * Docs for tracing format:
  * https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
@@ -171,6 +196,15 @@ void Profiler::DumpProfile(bool perform_cleanup) {
   if (perform_cleanup) {
     SetContinuousProfileDump(false, 1.0f);
   }
+  if (binary_trace_) {
+    if (perform_cleanup) {
+      SetBinaryTrace(false, 0);
+      enable_output_ = false;
+    } else {
+      trace_writer_->Flush();
+    }
+    return;
+  }
   std::ofstream file;
   const bool first_pass = ++profile_dump_count_ == 1;
   const bool last_pass = perform_cleanup || !continuous_dump_;
@@ -197,10 +231,6 @@ void Profiler::DumpProfile(bool perform_cleanup) {
     }
   }
 
-  // Hold ref in case SetConfig() resets aggregate_stats_
-  // If aggregate stats aren't enabled, this won't cause a locked instruction
-  std::shared_ptr<AggregateStats> ptr_aggregate_stats = aggregate_stats_.get()
-                                                        ? aggregate_stats_ : nullptr;
   for (uint32_t i = 0; i < dev_num; ++i) {
     DeviceStats &d = profile_stat[i];
     ProfileStat *_opr_stat;
@@ -211,9 +241,6 @@ void Profiler::DumpProfile(bool perform_cleanup) {
       file << ",\n" << std::endl;
       opr_stat->EmitEvents(&file);
       ++num_records_emitted_;
-      if (ptr_aggregate_stats) {
-        ptr_aggregate_stats->OnProfileStat(*_opr_stat);
-      }
     }
   }
 
@@ -238,9 +265,6 @@ void Profiler::DumpProfile(bool perform_cleanup) {
     file << std::endl;
     profile_stat->EmitEvents(&file);
     ++num_records_emitted_;
-    if (ptr_aggregate_stats) {
-      ptr_aggregate_stats->OnProfileStat(*profile_stat);
-    }
   }
 
   if (last_pass) {
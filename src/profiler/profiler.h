@@ -35,6 +35,7 @@
 #include <array>
 #include "./vtune.h"
 #include "./aggregate_stats.h"
+#include "./binary_trace.h"
 
 #if defined(_WIN32) || defined(_WIN64) || defined(__WINDOWS__)
 #include <windows.h>
@@ -173,6 +174,30 @@ struct ProfileStat {
     }
   }
 
+  /*!
+   * \brief Fill a binary trace record with this statistic
+   * \param process_id Device index, or TraceRecord::kCategoryPid
+   * \param record Record to fill
+   */
+  void ToTraceRecord(uint32_t process_id, TraceRecord *record) const {
+    size_t count = 0;
+    record->event_type[1] = '\0';
+    for (size_t i = 0; i < sizeof(items_) / sizeof(items_[0]) && count < 2; ++i) {
+      if (items_[i].enabled_) {
+        record->event_type[count] = static_cast<char>(items_[i].event_type_);
+        record->timestamp[count] = items_[i].timestamp_;
+        ++count;
+      }
+    }
+    record->thread_id = std::hash<std::thread::id>{}(thread_id_);
+    record->arg = TraceArg();
+    record->process_id = process_id;
+    strncpy(record->categories, categories_.c_str(), sizeof(record->categories) - 1);
+    record->categories[sizeof(record->categories) - 1] = '\0';
+    strncpy(record->name, name_.c_str(), sizeof(record->name) - 1);
+    record->name[sizeof(record->name) - 1] = '\0';
+  }
+
   /*!
    * \brief Virtual destructor
    */
@@ -188,6 +213,12 @@ struct ProfileStat {
     }
   }
 
+  /*!
+   * \brief Override for statistics on a device, aggregate latencies are kept per device
+   * \return Device name, or nullptr
+   */
+  virtual const char *DeviceName() const { return nullptr; }
+
  protected:
   /*!
    * \brief Override to emit extra items within the json event data block. Append with a comma ",".
@@ -196,6 +227,12 @@ struct ProfileStat {
    */
   virtual void EmitExtra(std::ostream *os, size_t idx) {}
 
+  /*!
+   * \brief Override to keep the value of the extra json items in binary traces
+   * \return Value written to TraceRecord::arg
+   */
+  virtual uint64_t TraceArg() const { return 0; }
+
   /*!
    * \brief Emit sub-event statistics
    * \param os Output stream
@@ -278,11 +315,15 @@ class Profiler {
    * \param output_filename profile output file name
    * \param continuous_dump true if profile information should be periodically dumped
    * \param dump_period Period (in seconds) of profile info dumping
+   * \param aggregate_stats true if aggregate statistics are to be kept
+   * \param binary_trace true if statistics are streamed to output_filename in the binary
+   *        trace format instead of being dumped as json
    */
   void SetConfig(int mode, std::string output_filename,
                  bool continuous_dump,
                  float dump_period,
-                 bool aggregate_stats);
+                 bool aggregate_stats,
+                 bool binary_trace = false);
 
   /*! \return mode of profiler */
   inline int GetMode() const {
@@ -322,8 +363,17 @@ class Profiler {
   template<typename StatType, typename SetExtraInfoFunction, typename ...Args>
   void AddNewProfileStat(SetExtraInfoFunction set_extra_info_function, Args... args) {
     if (!paused_) {
+      if (binary_trace_) {
+        // streamed without allocating or queueing the statistic
+        StatType stat(args...);
+        set_extra_info_function(&stat);
+        AggregateProfileStat(stat);
+        TraceProfileStat(stat);
+        return;
+      }
       std::unique_ptr<StatType> stat = CreateProfileStat<StatType>(args...);
       set_extra_info_function(stat.get());
+      AggregateProfileStat(*stat);
       AddProfileStat(&stat);
     }
   }
@@ -434,6 +484,36 @@ class Profiler {
     general_stats_.opr_exec_stats_->enqueue(stat->release());
   }
 
+  /*!
+   * \brief Record a statistic in the binary trace
+   * \tparam StatType Type of the statistic object
+   * \param stat The statistic object
+   */
+  template<typename StatType>
+  inline void TraceProfileStat(const StatType &stat) {
+    TraceRecord record = {};
+    stat.ToTraceRecord(TraceRecord::kCategoryPid, &record);
+    trace_writer_->Record(record);
+  }
+
+  /*!
+   * \brief Add a statistic to the aggregate stats when they are kept. Statistics are
+   *        aggregated when recorded, so aggregates are current without dumping the profile.
+   * \param stat The statistic object
+   */
+  inline void AggregateProfileStat(const ProfileStat &stat) {
+    if (aggregate_stats_.get()) {
+      // Hold ref in case SetConfig() resets aggregate_stats_
+      std::shared_ptr<AggregateStats> ptr_aggregate_stats = aggregate_stats_;
+      if (ptr_aggregate_stats) {
+        ptr_aggregate_stats->OnProfileStat(stat);
+      }
+    }
+  }
+
+  /*! \brief start the binary trace, or switch back to json output */
+  void SetBinaryTrace(bool binary_trace, float flush_period);
+
   /*! \brief generate device information following chrome profile file format */
   void EmitPid(std::ostream *os, const std::string& name, size_t pid);
 
@@ -477,6 +557,10 @@ class Profiler {
   /*! \brief Maintain in-memory aggregate stats for print output.
    *  \warning This has a negative performance impact */
   std::shared_ptr<AggregateStats> aggregate_stats_ = nullptr;
+  /*! \brief Statistics are streamed to a binary trace instead of being queued */
+  volatile bool binary_trace_ = false;
+  /*! \brief Writer of the binary trace, made when first enabled */
+  std::unique_ptr<BinaryTraceWriter> trace_writer_;
   /*! \brief Asynchronous operation thread lifecycle control object */
   std::shared_ptr<dmlc::ThreadGroup> thread_group_ = std::make_shared<dmlc::ThreadGroup>();
   /* !\brief pids */
@@ -639,6 +723,10 @@ struct ProfileCounter : public ProfileObject {
       *os << "        \"args\": { \"" << name_.c_str() << "\": " << value_ << " },\n";
     }
 
+    uint64_t TraceArg() const override {
+      return value_;
+    }
+
     /*!
      * \brief Save aggregate data for this stat
      * \param data Stat data
@@ -1030,6 +1118,9 @@ struct ProfileMarker {
       ProfileStat::EmitExtra(os, idx);
       *os << "        \"s\": \"" << scope_char_ << "\",\n";
     }
+    uint64_t TraceArg() const override {
+      return static_cast<uint64_t>(scope_char_);
+    }
     const char scope_char_;
   };
 
@@ -1171,6 +1262,9 @@ struct ProfileOperator : public ProfileEvent {
       items_[kStart].timestamp_ = start_time;
       items_[kStop].timestamp_ = stop_time;
     }
+    const char *DeviceName() const override {
+      return Profiler::Get()->DeviceName(dev_type_, dev_id_);
+    }
     /*! \brief device type: CPU: 1, GPU: 2, CPUPinned: 3 */
     mxnet::Context::DeviceType dev_type_;
     /*! \brief device id */
@@ -1241,6 +1335,21 @@ inline void Profiler::AddProfileStat<ProfileOperator::OprExecStat>(
   dev_stat.opr_exec_stats_->enqueue((*opr_stat).release());
 }
 
+/*!
+ * \brief Explicit 'Profiler::TraceProfileStat' override for 'OprExecStat', which is
+ *        traced on its device
+ * \param opr_stat The operator statistic
+ */
+template<>
+inline void Profiler::TraceProfileStat<ProfileOperator::OprExecStat>(
+  const ProfileOperator::OprExecStat &opr_stat) {
+  const size_t idx = DeviceIndex(opr_stat.dev_type_, opr_stat.dev_id_);
+  CHECK_LT(idx, DeviceCount());
+  TraceRecord record = {};
+  opr_stat.ToTraceRecord(static_cast<uint32_t>(idx), &record);
+  trace_writer_->Record(record);
+}
+
 #undef VTUNE_ONLY_CODE  // This macro not meant to be used outside of this file
 
 }  // namespace profiler
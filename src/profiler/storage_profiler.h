@@ -71,6 +71,34 @@ class DeviceStorageProfiler {
     }
   }
 
+  /*!
+   * \brief Called by pooling storage managers when a request was served from the pool
+   * \param handle Handle to the allocated storage
+   */
+  void OnPoolHit(const Storage::Handle &handle) {
+    profiler::Profiler *prof = profiler::Profiler::Get();
+    if (prof->IsProfiling(profiler::Profiler::kMemory)) {
+      Init();
+      const size_t idx = prof->DeviceIndex(handle.ctx.dev_type, handle.ctx.dev_id);
+      CHECK_LT(idx, pool_hit_counters_.size()) << "Invalid device index: " << idx;
+      ++*pool_hit_counters_[idx];
+    }
+  }
+
+  /*!
+   * \brief Called by pooling storage managers when a request had to go to the device allocator
+   * \param handle Handle to the allocated storage
+   */
+  void OnPoolMiss(const Storage::Handle &handle) {
+    profiler::Profiler *prof = profiler::Profiler::Get();
+    if (prof->IsProfiling(profiler::Profiler::kMemory)) {
+      Init();
+      const size_t idx = prof->DeviceIndex(handle.ctx.dev_type, handle.ctx.dev_id);
+      CHECK_LT(idx, pool_miss_counters_.size()) << "Invalid device index: " << idx;
+      ++*pool_miss_counters_[idx];
+    }
+  }
+
  private:
   /*!
    * \brief Lazy initialization.  No locks occur except for on the first pass
@@ -83,6 +111,16 @@ class DeviceStorageProfiler {
       if (mem_counters_.empty()) {
         profiler::Profiler *prof = profiler::Profiler::Get();
         const size_t device_count = prof->DeviceCount();
+        pool_hit_counters_.reserve(device_count);
+        pool_miss_counters_.reserve(device_count);
+        for (size_t i = 0, n = device_count; i < n; ++i) {
+          const std::string dev_name = prof->DeviceName(i);
+          pool_hit_counters_.emplace_back(std::make_shared<profiler::ProfileCounter>(
+            ("Pool Hits: " + dev_name).c_str(), &domain_));
+          pool_miss_counters_.emplace_back(std::make_shared<profiler::ProfileCounter>(
+            ("Pool Misses: " + dev_name).c_str(), &domain_));
+        }
+        // Filled last, since its emptiness is what the unlocked check in Init() looks at
         mem_counters_.reserve(device_count);
         for (size_t i = 0, n = device_count; i < n; ++i) {
           std::string name = "Memory: ";
@@ -100,6 +138,10 @@ class DeviceStorageProfiler {
   std::mutex init_mutex_;
   /*! \brief Constant-sized vector of memory profile counters */
   std::vector<std::shared_ptr<profiler::ProfileCounter>> mem_counters_;
+  /*! \brief Constant-sized vector of memory pool hit counters */
+  std::vector<std::shared_ptr<profiler::ProfileCounter>> pool_hit_counters_;
+  /*! \brief Constant-sized vector of memory pool miss counters */
+  std::vector<std::shared_ptr<profiler::ProfileCounter>> pool_miss_counters_;
 };
 
 }  // namespace storage
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file cpu_numa_storage_manager.h
+ * \brief Unpooled CPU storage manager placing memory on one NUMA node.
+ */
+#ifndef MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
+#define MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif  // defined(__linux__)
+#include "./storage_manager.h"
+#include "./cpu_device_storage.h"
+#include "../common/numa.h"
+#include "mxnet/base.h"
+
+namespace mxnet {
+namespace storage {
+
+/*!
+ * \brief Like NaiveStorageManager<CPUDeviceStorage>, but asks the kernel to back the
+ *  allocations with pages of a given NUMA node.
+ *
+ *  Allocations of at least kMinMappedSize bytes get their own anonymous mapping, so the
+ *  placement hint always applies to fresh pages and is given once per allocation. Smaller
+ *  ones come from the heap, whose pages may already be populated and hold few whole pages;
+ *  they are left to first touch placement by the (node bound) worker threads.
+ */
+class CPUNUMAStorageManager final : public StorageManager {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param numa_node Node the memory should be placed on.
+   */
+  explicit CPUNUMAStorageManager(int numa_node) : numa_node_(numa_node) {}
+  /*!
+   * \brief Default destructor.
+   */
+  ~CPUNUMAStorageManager() = default;
+
+  void Alloc(Storage::Handle* handle) override {
+#if defined(__linux__)
+    if (handle->size >= kMinMappedSize) {
+      void *ptr = mmap(nullptr, handle->size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (ptr == MAP_FAILED) LOG(FATAL) << "Failed to allocate CPU Memory";
+      handle->dptr = ptr;
+      common::numa::PreferNode(ptr, handle->size, numa_node_);
+      return;
+    }
+#endif  // defined(__linux__)
+    handle->dptr = CPUDeviceStorage::Alloc(handle->size);
+  }
+
+  void Free(Storage::Handle handle) override {
+#if defined(__linux__)
+    if (handle.size >= kMinMappedSize) {
+      munmap(handle.dptr, handle.size);
+      return;
+    }
+#endif  // defined(__linux__)
+    CPUDeviceStorage::Free(handle.dptr);
+  }
+
+  void DirectFree(Storage::Handle handle) override {
+    Free(handle);
+  }
+
+  /*! \brief smallest allocation that is mapped and placed on the node */
+  static const size_t kMinMappedSize = 1 << 16;
+
+ private:
+  /*! \brief node the memory is placed on */
+  const int numa_node_;
+  DISALLOW_COPY_AND_ASSIGN(CPUNUMAStorageManager);
+};  // class CPUNUMAStorageManager
+
+}  // namespace storage
+}  // namespace mxnet
+
+#endif  // MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file lock_free_free_list.h
+ * \brief Lock-free free list of memory chunks used by the pooled storage managers.
+ */
+#ifndef MXNET_STORAGE_LOCK_FREE_FREE_LIST_H_
+#define MXNET_STORAGE_LOCK_FREE_FREE_LIST_H_
+
+#include <dmlc/logging.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "mxnet/base.h"
+
+namespace mxnet {
+namespace storage {
+
+/*!
+ * \brief Process-wide arena of free list nodes.
+ *
+ * Nodes are addressed by a 32-bit index so that a list head can pack the index together
+ * with a version tag into a single 64-bit word. Nodes are recycled but never returned to
+ * the system, hence a racing reader may see a stale node but never a freed one.
+ */
+class FreeListNodeArena {
+ public:
+  /*! \brief index denoting the end of a list */
+  static constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+  struct Node {
+    /*! \brief chunk owned by this node, only accessed by the thread owning the node */
+    void *ptr;
+    /*! \brief next node in the list */
+    std::atomic<uint32_t> next;
+  };
+
+  /*! \brief Lock-free LIFO of node indices (Treiber stack with a tagged head). */
+  class Stack {
+   public:
+    Stack() : head_(Pack(kNil, 0)) {}
+
+    inline void Push(FreeListNodeArena *arena, uint32_t idx) {
+      Node &node = arena->At(idx);
+      uint64_t old_head = head_.load(std::memory_order_acquire);
+      uint64_t new_head;
+      do {
+        node.next.store(Index(old_head), std::memory_order_relaxed);
+        new_head = Pack(idx, Tag(old_head) + 1);
+      } while (!head_.compare_exchange_weak(old_head, new_head,
+                                            std::memory_order_release,
+                                            std::memory_order_acquire));
+    }
+
+    inline uint32_t Pop(FreeListNodeArena *arena) {
+      uint64_t old_head = head_.load(std::memory_order_acquire);
+      while (Index(old_head) != kNil) {
+        // May read the link of a node that was popped and reused meanwhile; the tag
+        // then no longer matches and the exchange below fails.
+        const uint32_t next = arena->At(Index(old_head)).next.load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(old_head, Pack(next, Tag(old_head) + 1),
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+          return Index(old_head);
+        }
+      }
+      return kNil;
+    }
+
+    inline bool Empty() const {
+      return Index(head_.load(std::memory_order_acquire)) == kNil;
+    }
+
+   private:
+    static inline uint64_t Pack(uint32_t idx, uint32_t tag) {
+      return (static_cast<uint64_t>(tag) << 32) | idx;
+    }
+    static inline uint32_t Index(uint64_t head) {
+      return static_cast<uint32_t>(head);
+    }
+    static inline uint32_t Tag(uint64_t head) {
+      return static_cast<uint32_t>(head >> 32);
+    }
+    std::atomic<uint64_t> head_;
+  };
+
+  /*!
+   * \brief Arena singleton. Intentionally never destroyed, since thread local pools may
+   *  hand their chunks back during thread exit after static destruction has started.
+   */
+  static FreeListNodeArena* Get() {
+    static FreeListNodeArena *inst = new FreeListNodeArena();
+    return inst;
+  }
+
+  inline Node& At(uint32_t idx) {
+    return blocks_[idx >> kLog2BlockSize].load(std::memory_order_acquire)
+        [idx & (kBlockSize - 1)];
+  }
+
+  /*! \brief Take an unused node, growing the arena if needed */
+  inline uint32_t Acquire() {
+    uint32_t idx = free_nodes_.Pop(this);
+    while (idx == kNil) {
+      Grow();
+      idx = free_nodes_.Pop(this);
+    }
+    return idx;
+  }
+
+  /*! \brief Return a node obtained from Acquire() */
+  inline void Release(uint32_t idx) {
+    free_nodes_.Push(this, idx);
+  }
+
+ private:
+  static constexpr uint32_t kLog2BlockSize = 12;
+  static constexpr uint32_t kBlockSize = 1u << kLog2BlockSize;
+  static constexpr uint32_t kMaxBlocks = 1u << 16;
+
+  FreeListNodeArena() : num_blocks_(0) {
+    for (auto &block : blocks_) block.store(nullptr, std::memory_order_relaxed);
+  }
+
+  void Grow() {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    // Another thread may have grown the arena while we were waiting
+    if (!free_nodes_.Empty()) return;
+    CHECK(num_blocks_ < kMaxBlocks) << "Too many pooled memory chunks";
+    Node *block = new Node[kBlockSize];
+    const uint32_t base = num_blocks_ << kLog2BlockSize;
+    blocks_[num_blocks_].store(block, std::memory_order_release);
+    ++num_blocks_;
+    for (uint32_t i = 0; i < kBlockSize; ++i) {
+      free_nodes_.Push(this, base + i);
+    }
+  }
+
+  std::array<std::atomic<Node*>, kMaxBlocks> blocks_;
+  uint32_t num_blocks_;
+  std::mutex grow_mutex_;
+  Stack free_nodes_;
+};
+
+/*!
+ * \brief Lock-free LIFO of memory chunks. The chunks may be device memory, the links
+ *  live in nodes of the FreeListNodeArena.
+ */
+class LockFreeFreeList {
+ public:
+  LockFreeFreeList() : arena_(FreeListNodeArena::Get()) {}
+  /*!
+   * \brief Destructor. Chunks still in the list are not freed, owners drain it first.
+   */
+  ~LockFreeFreeList() {
+    uint32_t idx;
+    while ((idx = stack_.Pop(arena_)) != FreeListNodeArena::kNil) {
+      arena_->Release(idx);
+    }
+  }
+  /*!
+   * \brief Add a chunk to the list.
+   * \param ptr Chunk pointer.
+   */
+  inline void Push(void *ptr) {
+    const uint32_t idx = arena_->Acquire();
+    arena_->At(idx).ptr = ptr;
+    stack_.Push(arena_, idx);
+  }
+  /*!
+   * \brief Remove the most recently added chunk.
+   * \return Chunk pointer, nullptr if the list is empty.
+   */
+  inline void* Pop() {
+    const uint32_t idx = stack_.Pop(arena_);
+    if (idx == FreeListNodeArena::kNil) return nullptr;
+    void *ptr = arena_->At(idx).ptr;
+    arena_->Release(idx);
+    return ptr;
+  }
+  /*! \brief Whether the list is currently empty */
+  inline bool Empty() const {
+    return stack_.Empty();
+  }
+
+ private:
+  FreeListNodeArena *arena_;
+  FreeListNodeArena::Stack stack_;
+  DISALLOW_COPY_AND_ASSIGN(LockFreeFreeList);
+};
+
+}  // namespace storage
+}  // namespace mxnet
+
+#endif  // MXNET_STORAGE_LOCK_FREE_FREE_LIST_H_
@@ -32,12 +32,18 @@
 #include <mxnet/storage.h>
 #include <unordered_map>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <new>
 #include "./storage_manager.h"
+#include "./cpu_device_storage.h"
+#include "./lock_free_free_list.h"
 #include "../common/cuda_utils.h"
+#include "../common/numa.h"
 #include "../common/utils.h"
+#include "../profiler/storage_profiler.h"
 
 
 namespace mxnet {
@@ -45,8 +51,13 @@ namespace storage {
 
 #if MXNET_USE_GPU
 /*!
- * \brief Storage manager with a memory pool on gpu. Memory chunks are reused based on exact size
- * match.
+ * \brief Storage manager with a memory pool on gpu. Memory chunks are reused based on a
+ * match of their size rounded up to a multiple of the page size (or, for large chunks, of
+ * MXNET_GPU_MEM_LARGE_ALLOC_ROUND_SIZE).
+ *
+ * Each rounded size has its own lock-free free list, so Alloc and Free from concurrent
+ * engine workers and the kvstore do not serialize. Only sizes beyond the bucket array
+ * fall back to a mutex protected map.
  */
 class GPUPooledStorageManager final : public StorageManager {
  public:
@@ -65,6 +76,10 @@ class GPUPooledStorageManager final : public StorageManager {
       LOG(FATAL) << "MXNET_GPU_MEM_POOL_PAGE_SIZE cannot be set to a value smaller than " << NDEV \
                  << ". Got " << page_size_ << ".";
     }
+    num_small_buckets_ = (large_alloc_round_size_ + page_size_ - 1) / page_size_;
+    num_buckets_ = std::min(num_small_buckets_ + (1ul << LOG2_MAX_MEM) / large_alloc_round_size_,
+                            MAX_BUCKETS);
+    memory_pool_.reset(new LockFreeFreeList[num_buckets_]);
   }
   /*!
    * \brief Default destructor.
@@ -77,14 +92,12 @@ class GPUPooledStorageManager final : public StorageManager {
   void Free(Storage::Handle handle) override;
 
   void DirectFree(Storage::Handle handle) override {
-    std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
-    DirectFreeNoLock(handle);
+    DirectFreeImpl(handle.dptr, RoundAllocSize(handle.size));
   }
 
  private:
-  void DirectFreeNoLock(Storage::Handle handle) {
-    hipError_t err = hipFree(handle.dptr);
-    size_t size = RoundAllocSize(handle.size);
+  void DirectFreeImpl(void *ptr, size_t size) {
+    hipError_t err = hipFree(ptr);
     // ignore unloading error, as memory has already been recycled
     if (err != hipSuccess && err != hipErrorDeinitialized) {
       LOG(FATAL) << "CUDA: " << hipGetErrorString(err);
@@ -99,8 +112,8 @@ class GPUPooledStorageManager final : public StorageManager {
   }
 
   size_t RoundAllocSize(size_t size) {
-    // Round up small allocs to the page_size_ to consolidate the pool lookups
-    size = std::max(size, page_size_);
+    // Round up small allocs to a multiple of page_size_ to consolidate the pool lookups
+    size = RoundToMultiple(std::max<size_t>(size, 1), page_size_);
     // To ensure proper freeing under some driver variants, make sure
     // large allocs entirely occupy their slabs, which cannot then be
     // locked by smaller permanent allocations sharing the slab.
@@ -109,10 +122,18 @@ class GPUPooledStorageManager final : public StorageManager {
     return size;
   }
 
+  // Bucket of a rounded size, num_buckets_ if the size is not covered by the bucket array
+  size_t GetBucket(size_t rounded_size) {
+    size_t bucket = rounded_size <= large_alloc_round_size_ ?
+                    rounded_size / page_size_ - 1 :
+                    num_small_buckets_ + rounded_size / large_alloc_round_size_ - 1;
+    return std::min(bucket, num_buckets_);
+  }
+
  private:
   void ReleaseAll();
   // used memory
-  size_t used_memory_ = 0;
+  std::atomic<size_t> used_memory_{0};
   // page size
   size_t page_size_;
   // size that large allocations should be rounded to, for proper freeing.
@@ -121,53 +142,77 @@ class GPUPooledStorageManager final : public StorageManager {
   int reserve_;
   // number of devices
   const size_t NDEV = 32;
-  // memory pool
-  std::unordered_map<size_t, std::vector<void*>> memory_pool_;
+  // log2 of maximum size covered by the bucket array. 16GB
+  const size_t LOG2_MAX_MEM = 34;
+  // upper bound on the number of buckets, e.g. when large alloc rounding is disabled
+  const size_t MAX_BUCKETS = 1ul << 16;
+  // number of page sized buckets
+  size_t num_small_buckets_;
+  // number of buckets
+  size_t num_buckets_;
+  // memory pool, one free list per rounded size
+  std::unique_ptr<LockFreeFreeList[]> memory_pool_;
+  // memory pool for sizes not covered by memory_pool_
+  std::unordered_map<size_t, std::vector<void*>> overflow_pool_;
   DISALLOW_COPY_AND_ASSIGN(GPUPooledStorageManager);
 };  // class GPUPooledStorageManager
 
-void GPUPooledStorageManager::Alloc(Storage::Handle* handle) {
-  std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+inline void GPUPooledStorageManager::Alloc(Storage::Handle* handle) {
   size_t size = RoundAllocSize(handle->size);
-  auto&& reuse_it = memory_pool_.find(size);
-  if (reuse_it == memory_pool_.end() || reuse_it->second.size() == 0) {
+  size_t bucket = GetBucket(size);
+  void* ret = nullptr;
+  if (bucket < num_buckets_) {
+    ret = memory_pool_[bucket].Pop();
+  } else {
+    std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+    auto&& reuse_it = overflow_pool_.find(size);
+    if (reuse_it != overflow_pool_.end() && reuse_it->second.size() != 0) {
+      ret = reuse_it->second.back();
+      reuse_it->second.pop_back();
+    }
+  }
+  if (ret == nullptr) {
     size_t free, total;
     hipMemGetInfo(&free, &total);
     if (free <= total * reserve_ / 100 || size > free - total * reserve_ / 100)
       ReleaseAll();
 
-    void* ret = nullptr;
     hipError_t e = hipMalloc(&ret, size);
     if (e != hipSuccess && e != hipErrorDeinitialized) {
       LOG(FATAL) << "hipMalloc failed: " << hipGetErrorString(e);
     }
     used_memory_ += size;
-    handle->dptr = ret;
-  } else {
-    auto&& reuse_pool = reuse_it->second;
-    auto ret = reuse_pool.back();
-    reuse_pool.pop_back();
-    handle->dptr = ret;
   }
+  handle->dptr = ret;
 }
 
-void GPUPooledStorageManager::Free(Storage::Handle handle) {
-  std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+inline void GPUPooledStorageManager::Free(Storage::Handle handle) {
   size_t size = RoundAllocSize(handle.size);
-  auto&& reuse_pool = memory_pool_[size];
-  reuse_pool.push_back(handle.dptr);
+  size_t bucket = GetBucket(size);
+  if (bucket < num_buckets_) {
+    memory_pool_[bucket].Push(handle.dptr);
+  } else {
+    std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+    overflow_pool_[size].push_back(handle.dptr);
+  }
 }
 
-void GPUPooledStorageManager::ReleaseAll() {
-  for (auto&& i : memory_pool_) {
+inline void GPUPooledStorageManager::ReleaseAll() {
+  for (size_t i = 0; i < num_buckets_; ++i) {
+    size_t size = i < num_small_buckets_ ? (i + 1) * page_size_ :
+                  (i - num_small_buckets_ + 1) * large_alloc_round_size_;
+    void *ptr;
+    while ((ptr = memory_pool_[i].Pop()) != nullptr) {
+      DirectFreeImpl(ptr, size);
+    }
+  }
+  std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+  for (auto&& i : overflow_pool_) {
     for (auto&& j : i.second) {
-      Storage::Handle handle;
-      handle.dptr = j;
-      handle.size = i.first;
-      DirectFreeNoLock(handle);
+      DirectFreeImpl(j, i.first);
     }
   }
-  memory_pool_.clear();
+  overflow_pool_.clear();
 }
 
 /*!
@@ -176,7 +221,7 @@ void GPUPooledStorageManager::ReleaseAll() {
  * This GPU mem pool uses a mixture of nearest pow2 (exponential) rounding and
  * nearest multiple (linear) rounding to help alleviate the memory allocation stress
  * in which the default naive exact-size-match pool falls short, such as in variable-length
- * input/output cases like RNN workloads.
+ * input/output cases like RNN workloads. Each bucket is a lock-free free list.
  *
  * \param cutoff the cutoff at which rounding is switched from exponential to linear. It's set
  * through MXNET_GPU_MEM_POOL_ROUND_LINEAR_CUTOFF environment variable. Must be between 20 (1 MB)
@@ -211,7 +256,8 @@ class GPUPooledRoundedStorageManager final : public StorageManager {
                  << "smaller than log2 of MXNET_GPU_MEM_POOL_PAGE_SIZE. Got: " \
                  << cut_off_ << " vs " << page_size_ << ".";
     }
-    memory_pool_ = std::vector<std::vector<void*>>((1ul << (LOG2_MAX_MEM - cut_off_)) + cut_off_);
+    num_buckets_ = (1ul << (LOG2_MAX_MEM - cut_off_)) + cut_off_;
+    memory_pool_.reset(new LockFreeFreeList[num_buckets_]);
   }
   /*!
    * \brief Default destructor.
@@ -224,8 +270,7 @@ class GPUPooledRoundedStorageManager final : public StorageManager {
   void Free(Storage::Handle handle) override;
 
   void DirectFree(Storage::Handle handle) override {
-    std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
-    DirectFreeNoLock(handle);
+    DirectFreeImpl(handle.dptr, get_size(get_bucket(handle.size)));
   }
 
  private:
@@ -250,9 +295,8 @@ class GPUPooledRoundedStorageManager final : public StorageManager {
       return (bucket - cut_off_ + 1) * (1ul << cut_off_);
   }
 
-  void DirectFreeNoLock(Storage::Handle handle) {
-    hipError_t err = hipFree(handle.dptr);
-    size_t size = get_size(get_bucket(handle.size));
+  void DirectFreeImpl(void *ptr, size_t size) {
+    hipError_t err = hipFree(ptr);
     // ignore unloading error, as memory has already been recycled
     if (err != hipSuccess && err != hipErrorDeinitialized) {
       LOG(FATAL) << "CUDA: " << hipGetErrorString(err);
@@ -269,65 +313,271 @@ class GPUPooledRoundedStorageManager final : public StorageManager {
   // address width in bits
   static const int addr_width = sizeof(size_t) * 8;
   // used memory
-  size_t used_memory_ = 0;
+  std::atomic<size_t> used_memory_{0};
   // page size
   size_t page_size_;
   // log2 of memory size before switching to exponential mode to linear mode
   size_t cut_off_;
   // percentage of reserved memory
   int reserve_;
-  // memory pool
-  std::vector<std::vector<void*>> memory_pool_;
+  // number of buckets
+  size_t num_buckets_;
+  // memory pool, one free list per bucket
+  std::unique_ptr<LockFreeFreeList[]> memory_pool_;
   DISALLOW_COPY_AND_ASSIGN(GPUPooledRoundedStorageManager);
 };  // class GPUPooledRoundedStorageManager
 
-void GPUPooledRoundedStorageManager::Alloc(Storage::Handle* handle) {
-  std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+inline void GPUPooledRoundedStorageManager::Alloc(Storage::Handle* handle) {
   int bucket = get_bucket(handle->size);
   size_t size = get_size(bucket);
-  auto&& reuse_pool = memory_pool_[bucket];
-  if (reuse_pool.size() == 0) {
+  void* ret = memory_pool_[bucket].Pop();
+  if (ret == nullptr) {
     size_t free, total;
     hipMemGetInfo(&free, &total);
     if (free <= total * reserve_ / 100 || size > free - total * reserve_ / 100)
       ReleaseAll();
 
-    void* ret = nullptr;
     hipError_t e = hipMalloc(&ret, size);
     if (e != hipSuccess && e != hipErrorDeinitialized) {
       LOG(FATAL) << "hipMalloc failed: " << hipGetErrorString(e);
     }
     used_memory_ += size;
-    handle->dptr = ret;
-  } else {
-    auto ret = reuse_pool.back();
-    reuse_pool.pop_back();
-    handle->dptr = ret;
   }
+  handle->dptr = ret;
 }
 
-void GPUPooledRoundedStorageManager::Free(Storage::Handle handle) {
-  std::lock_guard<std::mutex> lock(Storage::Get()->GetMutex(Context::kGPU));
+inline void GPUPooledRoundedStorageManager::Free(Storage::Handle handle) {
   int bucket = get_bucket(handle.size);
-  auto&& reuse_pool = memory_pool_[bucket];
-  reuse_pool.push_back(handle.dptr);
+  memory_pool_[bucket].Push(handle.dptr);
 }
 
-void GPUPooledRoundedStorageManager::ReleaseAll() {
-  for (size_t i = 0; i < memory_pool_.size(); i++) {
-    int size = get_size(i);
-    for (auto& j : memory_pool_[i]) {
-      Storage::Handle handle;
-      handle.size = size;
-      handle.dptr = j;
-      DirectFreeNoLock(handle);
+inline void GPUPooledRoundedStorageManager::ReleaseAll() {
+  for (size_t i = 0; i < num_buckets_; i++) {
+    size_t size = get_size(i);
+    void *ptr;
+    while ((ptr = memory_pool_[i].Pop()) != nullptr) {
+      DirectFreeImpl(ptr, size);
     }
-    memory_pool_[i].clear();
   }
 }
 
 #endif  // MXNET_USE_GPU
 
+/*!
+ * \brief Storage manager with a memory pool on cpu.
+ *
+ * Requested sizes are rounded into the same buckets as GPUPooledRoundedStorageManager:
+ * exp2(page), ..., exp2(X), 2*exp2(X), 3*exp2(X), ... where X is the linear cutoff.
+ * Freed chunks of small buckets go to a per-thread cache first and only spill into the
+ * shared pool, a lock-free free list per bucket, when that cache is full. Requests larger
+ * than 2^LOG2_MAX_MEM bytes bypass the pool.
+ *
+ * Tuned through the following environment variables:
+ *  - MXNET_CPU_MEM_POOL_PAGE_SIZE: smallest bucket, power of 2 (default 64)
+ *  - MXNET_CPU_MEM_POOL_ROUND_LINEAR_CUTOFF: log2 of the linear cutoff X (default 24)
+ *  - MXNET_CPU_MEM_POOL_THREAD_CACHE_SIZE: chunks kept per bucket per thread (default 16)
+ *  - MXNET_CPU_MEM_POOL_THREAD_CACHE_MAX_CHUNK: largest chunk kept in a thread cache
+ *    (default 1MB)
+ *
+ * If a NUMA node is given, new chunks are placed on that node. Since chunks are only ever
+ * recycled within the same manager, pooled memory stays node local.
+ */
+class CPUPooledStorageManager final : public StorageManager {
+ public:
+  /*!
+   * \brief Default constructor.
+   * \param profiler Optional profiler receiving pool hit/miss events.
+   * \param numa_node NUMA node to place new chunks on, -1 for no placement.
+   */
+  explicit CPUPooledStorageManager(DeviceStorageProfiler *profiler = nullptr,
+                                   int numa_node = -1)
+    : profiler_(profiler), numa_node_(numa_node), pool_(std::make_shared<SharedPool>()) {
+    size_t page_size = dmlc::GetEnv("MXNET_CPU_MEM_POOL_PAGE_SIZE", 64);
+    cut_off_ = dmlc::GetEnv("MXNET_CPU_MEM_POOL_ROUND_LINEAR_CUTOFF", 24);
+    thread_cache_size_ = dmlc::GetEnv("MXNET_CPU_MEM_POOL_THREAD_CACHE_SIZE", 16);
+    size_t max_cached_chunk = dmlc::GetEnv("MXNET_CPU_MEM_POOL_THREAD_CACHE_MAX_CHUNK",
+                                           1 << 20);
+    if (page_size < 16) {
+      LOG(FATAL) << "MXNET_CPU_MEM_POOL_PAGE_SIZE cannot be set to a value smaller than 16. " \
+                 << "Got: " << page_size << ".";
+    }
+    if (page_size != 1ul << common::ilog2ul(page_size - 1)) {
+      LOG(FATAL) << "MXNET_CPU_MEM_POOL_PAGE_SIZE must be a power of 2. Got: " << page_size << ".";
+    }
+    page_size_ = common::ilog2ul(page_size - 1);
+    if (cut_off_ < 20 || cut_off_ > LOG2_MAX_MEM) {
+      LOG(FATAL) << "MXNET_CPU_MEM_POOL_ROUND_LINEAR_CUTOFF cannot be set to a value " \
+                 << "smaller than 20 or greater than " << LOG2_MAX_MEM << ". Got: " \
+                 << cut_off_ << ".";
+    }
+    if (cut_off_ < page_size_) {
+      LOG(FATAL) << "MXNET_CPU_MEM_POOL_ROUND_LINEAR_CUTOFF cannot be set to a value " \
+                 << "smaller than log2 of MXNET_CPU_MEM_POOL_PAGE_SIZE. Got: " \
+                 << cut_off_ << " vs " << page_size_ << ".";
+    }
+    num_buckets_ = (1ul << (LOG2_MAX_MEM - cut_off_)) + cut_off_;
+    max_cached_bucket_ = max_cached_chunk == 0 ? -1 : get_bucket(max_cached_chunk);
+    pool_->buckets.reset(new LockFreeFreeList[num_buckets_]);
+  }
+  /*!
+   * \brief Default destructor.
+   */
+  ~CPUPooledStorageManager() {
+    pool_->released = true;
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      pool_->Drain(i);
+    }
+  }
+
+  void Alloc(Storage::Handle* handle) override;
+  void Free(Storage::Handle handle) override;
+
+  void DirectFree(Storage::Handle handle) override {
+    CPUDeviceStorage::Free(handle.dptr);
+  }
+
+ private:
+  /*! \brief chunks shared by all threads; outlives the manager while thread caches hold it */
+  struct SharedPool {
+    std::unique_ptr<LockFreeFreeList[]> buckets;
+    std::atomic<bool> released{false};
+    /*! \brief hand a chunk back, freeing it instead if the manager is gone */
+    void Push(size_t bucket, void *ptr) {
+      if (released) {
+        CPUDeviceStorage::Free(ptr);
+        return;
+      }
+      buckets[bucket].Push(ptr);
+      // The manager may have drained this bucket between the check and the push
+      if (released) Drain(bucket);
+    }
+    void Drain(size_t bucket) {
+      void *ptr;
+      while ((ptr = buckets[bucket].Pop()) != nullptr) {
+        CPUDeviceStorage::Free(ptr);
+      }
+    }
+  };
+  /*! \brief per-thread chunk cache, handed back to the shared pool on thread exit */
+  struct ThreadCache {
+    std::shared_ptr<SharedPool> pool;
+    std::vector<std::vector<void*>> buckets;
+    ~ThreadCache() {
+      for (size_t i = 0; i < buckets.size(); ++i) {
+        for (void *ptr : buckets[i]) {
+          pool->Push(i, ptr);
+        }
+      }
+    }
+  };
+
+  inline int div_pow2_round_up(size_t s, int divisor_log2) {
+    size_t result = s >> divisor_log2;
+    return static_cast<int>(result + (s > (result << divisor_log2) ? 1 : 0));
+  }
+  inline int get_bucket(size_t s) {
+    int log_size = s > 1 ? common::ilog2ul(s - 1) : 0;
+    if (log_size > static_cast<int>(cut_off_))
+      return div_pow2_round_up(s, cut_off_) - 1 + cut_off_;
+    else
+      return std::max(log_size, static_cast<int>(page_size_));
+  }
+  inline size_t get_size(int bucket) {
+    if (bucket <= static_cast<int>(cut_off_))
+      return 1ul << bucket;
+    else
+      return (bucket - cut_off_ + 1) * (1ul << cut_off_);
+  }
+  inline bool is_pooled(size_t s) {
+    return s <= (1ul << LOG2_MAX_MEM);
+  }
+  /*! \brief thread cache of the calling thread, or nullptr if the bucket is not cached */
+  inline ThreadCache* GetThreadCache(int bucket) {
+    if (bucket > max_cached_bucket_ || thread_cache_size_ == 0) return nullptr;
+    static thread_local std::unordered_map<const SharedPool*,
+                                           std::unique_ptr<ThreadCache>> caches;
+    std::unique_ptr<ThreadCache>& cache = caches[pool_.get()];
+    if (!cache) {
+      cache.reset(new ThreadCache());
+      cache->pool = pool_;
+      cache->buckets.resize(max_cached_bucket_ + 1);
+    }
+    return cache.get();
+  }
+
+ private:
+  // log2 of maximum pooled chunk size. 16GB
+  const size_t LOG2_MAX_MEM = 34;
+  // optional profiler for hit/miss counters
+  DeviceStorageProfiler *profiler_;
+  // NUMA node new chunks are placed on, -1 if none
+  int numa_node_;
+  // log2 of the smallest bucket
+  size_t page_size_;
+  // log2 of memory size before switching to exponential mode to linear mode
+  size_t cut_off_;
+  // number of buckets
+  size_t num_buckets_;
+  // largest bucket held in thread caches
+  int max_cached_bucket_;
+  // maximum number of chunks per bucket in a thread cache
+  size_t thread_cache_size_;
+  // memory pool shared across threads
+  std::shared_ptr<SharedPool> pool_;
+  DISALLOW_COPY_AND_ASSIGN(CPUPooledStorageManager);
+};  // class CPUPooledStorageManager
+
+inline void CPUPooledStorageManager::Alloc(Storage::Handle* handle) {
+  if (!is_pooled(handle->size)) {
+    handle->dptr = CPUDeviceStorage::Alloc(handle->size);
+    return;
+  }
+  int bucket = get_bucket(handle->size);
+  ThreadCache *cache = GetThreadCache(bucket);
+  if (cache != nullptr && !cache->buckets[bucket].empty()) {
+    handle->dptr = cache->buckets[bucket].back();
+    cache->buckets[bucket].pop_back();
+    if (profiler_) profiler_->OnPoolHit(*handle);
+    return;
+  }
+  void *ret = pool_->buckets[bucket].Pop();
+  if (ret != nullptr) {
+    handle->dptr = ret;
+    if (profiler_) profiler_->OnPoolHit(*handle);
+    return;
+  }
+  const size_t size = get_size(bucket);
+  handle->dptr = CPUDeviceStorage::Alloc(size);
+  if (numa_node_ >= 0) common::numa::PreferNode(handle->dptr, size, numa_node_);
+  if (profiler_) profiler_->OnPoolMiss(*handle);
+}
+
+inline void CPUPooledStorageManager::Free(Storage::Handle handle) {
+  if (!is_pooled(handle.size)) {
+    CPUDeviceStorage::Free(handle.dptr);
+    return;
+  }
+  int bucket = get_bucket(handle.size);
+  ThreadCache *cache = GetThreadCache(bucket);
+  if (cache != nullptr) {
+    auto&& local = cache->buckets[bucket];
+    if (local.size() < thread_cache_size_) {
+      local.push_back(handle.dptr);
+      return;
+    }
+    // Cache is full: move half of it to the shared pool so that the next
+    // few frees on this thread stay thread local again.
+    const size_t keep = thread_cache_size_ / 2;
+    for (size_t i = keep; i < local.size(); ++i) {
+      pool_->buckets[bucket].Push(local[i]);
+    }
+    local.resize(keep);
+    local.push_back(handle.dptr);
+    return;
+  }
+  pool_->buckets[bucket].Push(handle.dptr);
+}
+
 }  // namespace storage
 }  // namespace mxnet
 
@@ -26,8 +26,10 @@
 #include "./pooled_storage_manager.h"
 #include "./cpu_shared_storage_manager.h"
 #include "./cpu_device_storage.h"
+#include "./cpu_numa_storage_manager.h"
 #include "./pinned_memory_storage.h"
 #include "../common/lazy_alloc_array.h"
+#include "../common/numa.h"
 #include "../profiler/storage_profiler.h"
 
 namespace mxnet {
@@ -44,6 +46,16 @@ class StorageImpl : public Storage {
 
  private:
   static constexpr size_t kMaxNumberOfDevices = Context::kMaxDevType + 1;
+  /*!
+   * \brief Index of the storage manager of a context. All CPU contexts share one manager,
+   *  unless NUMA placement is enabled, where each CPU device id gets its own.
+   */
+  static int ManagerId(const Context& ctx) {
+    if (ctx.dev_type == Context::kCPU && common::numa::Enabled()) {
+      return ctx.dev_id;
+    }
+    return ctx.real_dev_id();
+  }
 #if MXNET_USE_GPU
   static int num_gpu_device;
 #endif  // MXNET_USE_GPU
@@ -90,11 +102,30 @@ void StorageImpl::Alloc(Storage::Handle* handle) {
   // space already recycled, ignore request
   auto&& device = storage_managers_.at(handle->ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      handle->ctx.real_dev_id(), [handle]() {
+      ManagerId(handle->ctx), [this, handle]() {
         storage::StorageManager *ptr = nullptr;
         switch (handle->ctx.dev_type) {
           case Context::kCPU: {
-            ptr = new storage::NaiveStorageManager<storage::CPUDeviceStorage>();
+            const char *type = getenv("MXNET_CPU_MEM_POOL_TYPE");
+            const bool default_pool = (type == nullptr);
+            if (default_pool) type = "Unpooled";
+            std::string strategy = type;
+
+            const int numa_node = common::numa::Enabled() ?
+                                  common::numa::NodeOfDevice(handle->ctx.dev_id) : -1;
+            if (strategy == "Round") {
+              ptr = new storage::CPUPooledStorageManager(&profiler_, numa_node);
+              LOG(INFO) << "Using CPUPooledStorageManager.";
+            } else {
+              if (strategy != "Unpooled") {
+                LOG(FATAL) << "Unknown CPU memory pool strategy specified: " << strategy << ".";
+              }
+              if (numa_node >= 0) {
+                ptr = new storage::CPUNUMAStorageManager(numa_node);
+              } else {
+                ptr = new storage::NaiveStorageManager<storage::CPUDeviceStorage>();
+              }
+            }
             break;
           }
           case Context::kCPUShared: {
@@ -164,7 +195,7 @@ void StorageImpl::Free(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      ctx.real_dev_id(), []() {
+      ManagerId(ctx), []() {
         LOG(FATAL) <<  "Cannot Free space to a device you have not allocated";
         return nullptr;
       });
@@ -183,7 +214,7 @@ void StorageImpl::DirectFree(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      ctx.real_dev_id(), []() {
+      ManagerId(ctx), []() {
         LOG(FATAL) <<  "Cannot Free space to a device you have not allocated";
         return nullptr;
       });
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file engine_perf.cc
+ * \brief Throughput of pushing many tiny operators to the threaded engines
+*/
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <gtest/gtest.h>
+#include <mxnet/engine.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/engine/engine_impl.h"
+#include "../include/test_util.h"
+
+/*!
+ * \brief Push num_ops no-op operators from each of num_threads threads. Each op reads one
+ *  and writes another of num_vars variables, so most of the time is spent in dependency
+ *  tracking (ThreadedVar) and scheduling rather than in the ops.
+ * \return completed operators per second
+ */
+static double PushTinyOps(mxnet::Engine *engine, size_t num_threads,
+                          size_t num_vars, size_t num_ops) {
+  using mxnet::Engine;
+  std::vector<Engine::VarHandle> vars;
+  for (size_t i = 0; i < num_vars; ++i) {
+    vars.push_back(engine->NewVariable());
+  }
+  std::atomic<size_t> executed{0};
+  auto fn = [&executed](mxnet::RunContext, Engine::CallbackOnComplete cb) {
+    ++executed;
+    cb();
+  };
+  const double start = dmlc::GetTime();
+  std::vector<std::thread> pushers;
+  for (size_t t = 0; t < num_threads; ++t) {
+    pushers.emplace_back([&, t]() {
+      unsigned seed = static_cast<unsigned>(t + 1);
+      for (size_t i = 0; i < num_ops; ++i) {
+        const size_t read = rand_r(&seed) % num_vars;
+        size_t write = rand_r(&seed) % num_vars;
+        if (write == read) write = (write + 1) % num_vars;
+        engine->PushAsync(fn, mxnet::Context::CPU(), {vars[read]}, {vars[write]});
+      }
+    });
+  }
+  for (auto &pusher : pushers) {
+    pusher.join();
+  }
+  engine->WaitForAll();
+  const double elapsed = dmlc::GetTime() - start;
+  EXPECT_EQ(executed.load(), num_threads * num_ops);
+  for (auto var : vars) {
+    engine->DeleteVariable([](mxnet::RunContext) {}, mxnet::Context::CPU(), var);
+  }
+  engine->WaitForAll();
+  return (num_threads * num_ops) / elapsed;
+}
+
+TEST(ENGINE_PERF, PushTinyOps) {
+  const size_t num_ops = mxnet::test::performance_run ? 200000 : 2000;
+  const std::vector<size_t> thread_counts = mxnet::test::performance_run ?
+                                            std::vector<size_t>{1, 2, 4, 8} :
+                                            std::vector<size_t>{1, 4};
+  const std::vector<size_t> var_counts = mxnet::test::performance_run ?
+                                         std::vector<size_t>{16, 1024, 65536} :
+                                         std::vector<size_t>{64};
+  const std::vector<std::string> type_names = {"ThreadedEnginePooled",
+                                               "ThreadedEnginePerDevice",
+                                               "ThreadedEnginePerDeviceWorkStealing"};
+  std::vector<std::unique_ptr<mxnet::Engine>> engines(type_names.size());
+  engines[0].reset(mxnet::engine::CreateThreadedEnginePooled());
+  engines[1].reset(mxnet::engine::CreateThreadedEnginePerDevice());
+  engines[2].reset(mxnet::engine::CreateThreadedEnginePerDeviceWorkStealing());
+  for (size_t k = 0; k < engines.size(); ++k) {
+    for (size_t num_vars : var_counts) {
+      for (size_t num_threads : thread_counts) {
+        const double rate = PushTinyOps(engines[k].get(), num_threads, num_vars, num_ops);
+        LOG(INFO) << type_names[k] << ": " << num_threads << " pushing threads, "
+                  << num_vars << " vars: " << rate << " ops/sec";
+      }
+    }
+  }
+}
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file op_cost_test.cc
+ * \brief Tests of the op cost estimates and of cutting bulks by cost
+*/
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../src/engine/op_cost.h"
+
+namespace {
+
+typedef std::vector<std::pair<size_t, size_t> > Segments;
+
+/*!
+ * \brief Segments of a chain of nodes with the given costs, cut the way
+ *  GraphExecutor::BulkTrainingOpSegs does. Negative costs are unmeasured.
+ * \param standalone_nodes receives the nodes that run outside of any segment
+ */
+Segments SegmentByCost(const std::vector<double> &costs, double budget, size_t max_nodes,
+                       std::vector<size_t> *standalone_nodes, bool *saw_unmeasured) {
+  mxnet::engine::BulkCostSplitter splitter(budget, max_nodes);
+  Segments segments;
+  size_t topo_start = 0;
+  for (size_t nid = 0; nid < costs.size(); ++nid) {
+    bool standalone = true;
+    if (splitter.Split(costs[nid], &standalone)) {
+      if (nid > topo_start) segments.emplace_back(topo_start, nid);
+      topo_start = standalone ? nid + 1 : nid;
+      if (standalone) {
+        standalone_nodes->push_back(nid);
+        splitter.Reset();
+      }
+    }
+  }
+  if (topo_start < costs.size()) segments.emplace_back(topo_start, costs.size());
+  *saw_unmeasured = splitter.saw_unmeasured();
+  return segments;
+}
+
+}  // namespace
+
+TEST(OpCost, BulkCostSplitterSegments) {
+  std::vector<size_t> standalone;
+  bool saw_unmeasured = false;
+  // Budget of 100us. The unmeasured node counts as 100 / 15 us.
+  const Segments segments = SegmentByCost({30, 30, 30, 30, 150, 10, -1, 60, 50},
+                                          100, 15, &standalone, &saw_unmeasured);
+  EXPECT_EQ(segments, Segments({{0, 3}, {3, 4}, {5, 8}, {8, 9}}));
+  EXPECT_EQ(standalone, std::vector<size_t>({4}));
+  EXPECT_TRUE(saw_unmeasured);
+}
+
+TEST(OpCost, BulkCostSplitterCheapAndHeavyOps) {
+  std::vector<size_t> standalone;
+  bool saw_unmeasured = true;
+  // Many cheap ops share one segment regardless of their count
+  const Segments cheap = SegmentByCost(std::vector<double>(40, 1.0), 100, 15,
+                                       &standalone, &saw_unmeasured);
+  EXPECT_EQ(cheap, Segments({{0, 40}}));
+  EXPECT_TRUE(standalone.empty());
+  EXPECT_FALSE(saw_unmeasured);
+  // A segment ends exactly at the budget, and ops at the budget run on their own
+  const Segments heavy = SegmentByCost({50, 50, 50, 100, 100, 20},
+                                       100, 15, &standalone, &saw_unmeasured);
+  EXPECT_EQ(heavy, Segments({{0, 2}, {2, 3}, {5, 6}}));
+  EXPECT_EQ(standalone, std::vector<size_t>({3, 4}));
+  // Unmeasured ops alone are bulked by count
+  const Segments unmeasured = SegmentByCost(std::vector<double>(10, -1.0), 100, 4,
+                                            &standalone, &saw_unmeasured);
+  EXPECT_EQ(unmeasured, Segments({{0, 4}, {4, 8}, {8, 10}}));
+  EXPECT_TRUE(saw_unmeasured);
+}
+
+TEST(OpCost, EstimateAfterWarmup) {
+  mxnet::engine::OpCost cost;
+  EXPECT_LT(cost.Estimate(), 0);
+  // The first run is discarded
+  cost.Run([]() {});
+  EXPECT_LT(cost.Estimate(), 0);
+  cost.Run([]() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+  EXPECT_GE(cost.Estimate(), 2000.0);
+}
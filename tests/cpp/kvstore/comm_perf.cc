@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file comm_perf.cc
+ * \brief Correctness and bandwidth of the CPU gradient reduction used by CommCPU
+*/
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <gtest/gtest.h>
+#include <mxnet/base.h>
+#include <cstdlib>
+#include <vector>
+
+#include "../src/kvstore/comm.h"
+#include "../src/kvstore/cpu_reduce.h"
+#include "../include/test_util.h"
+
+using mshadow::half::half_t;
+
+template<typename DType>
+static void FillSources(std::vector<std::vector<DType>> *bufs, size_t num_src, size_t size) {
+  bufs->assign(num_src, std::vector<DType>(size));
+  for (size_t i = 0; i < num_src; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      (*bufs)[i][j] = static_cast<DType>(static_cast<float>((i + j) % 7) * 0.25f);
+    }
+  }
+}
+
+template<typename DType>
+static std::vector<DType*> Pointers(std::vector<std::vector<DType>> *bufs) {
+  std::vector<DType*> dptr;
+  for (auto &buf : *bufs) {
+    dptr.push_back(buf.data());
+  }
+  return dptr;
+}
+
+TEST(COMM_CPU, ReduceSum) {
+  // Sizes around the tile and task boundaries, sources around the unrolled group of four
+  for (size_t size : {1, 1023, 1024, 5000, 20000}) {
+    for (size_t num_src : {2, 3, 5, 8, 17}) {
+      std::vector<std::vector<float>> bufs;
+      FillSources(&bufs, num_src, size);
+      mxnet::kvstore::ReduceSumCPU(Pointers(&bufs), size, 4096, 4);
+      for (size_t j = 0; j < size; ++j) {
+        float expected = 0;
+        for (size_t i = 0; i < num_src; ++i) {
+          expected += static_cast<float>((i + j) % 7) * 0.25f;
+        }
+        ASSERT_EQ(bufs[0][j], expected) << "size " << size << ", sources " << num_src;
+      }
+    }
+  }
+}
+
+TEST(COMM_CPU, ReduceSumHalfAccumulatesInFloat) {
+  // 2048 plus sixteen ones would stay 2048 if the sum was rounded to half after every addition
+  const size_t num_src = 17, size = 3000;
+  std::vector<std::vector<half_t>> bufs(num_src, std::vector<half_t>(size, half_t(1.0f)));
+  for (auto &v : bufs[0]) v = half_t(2048.0f);
+  mxnet::kvstore::ReduceSumCPU(Pointers(&bufs), size, 1024, 2);
+  for (size_t j = 0; j < size; ++j) {
+    ASSERT_EQ(static_cast<float>(bufs[0][j]), 2064.0f);
+  }
+}
+
+TEST(COMM_CPU, ReduceMatchesSerialSum) {
+  // A fan-in of 3 reduces 4 and 11 sources as trees of two and three levels, arrays
+  // under the bound as one flat sum
+  setenv("MXNET_KVSTORE_REDUCTION_FANIN", "3", 1);
+  setenv("MXNET_KVSTORE_BIGARRAY_BOUND", "64", 1);
+  mxnet::kvstore::CommCPU comm;
+  unsetenv("MXNET_KVSTORE_REDUCTION_FANIN");
+  unsetenv("MXNET_KVSTORE_BIGARRAY_BOUND");
+  int key = 0;
+  for (size_t size : {32, 1000}) {
+    for (size_t num_src : {2, 4, 9, 11}) {
+      comm.Init(key, mxnet::kDefaultStorage, mxnet::TShape{static_cast<int64_t>(size)});
+      std::vector<mxnet::NDArray> src;
+      std::vector<float> expected(size, 0.0f), values(size);
+      for (size_t i = 0; i < num_src; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+          values[j] = static_cast<float>((i * size + j) % 13) * 0.5f;
+          expected[j] += values[j];
+        }
+        src.emplace_back(mxnet::TShape{static_cast<int64_t>(size)}, mxnet::Context::CPU());
+        src.back().SyncCopyFromCPU(values.data(), size);
+      }
+      const mxnet::NDArray &merged = comm.Reduce(key, src, 0);
+      std::vector<float> result(size);
+      merged.SyncCopyToCPU(result.data(), size);
+      EXPECT_EQ(result, expected) << "size " << size << ", sources " << num_src;
+      ++key;
+    }
+  }
+}
+
+/*!
+ * \brief Sum num_src buffers of size elements and report the bandwidth, counting every
+ *  source read and the result written once.
+ */
+template<typename DType>
+static void RunReduceBandwidth(const char *type_name, size_t num_src, size_t size,
+                               int nthreads, size_t iterations) {
+  std::vector<std::vector<DType>> bufs;
+  FillSources(&bufs, num_src, size);
+  const std::vector<DType*> dptr = Pointers(&bufs);
+  // the same task size CommCPU uses with the default MXNET_KVSTORE_BIGARRAY_BOUND
+  const size_t step = 4 << 10;
+  mxnet::kvstore::ReduceSumCPU(dptr, size, step, nthreads);
+  const double start = dmlc::GetTime();
+  for (size_t it = 0; it < iterations; ++it) {
+    mxnet::kvstore::ReduceSumCPU(dptr, size, step, nthreads);
+  }
+  const double elapsed = dmlc::GetTime() - start;
+  const double bytes = static_cast<double>((num_src + 1) * size * sizeof(DType)) * iterations;
+  LOG(INFO) << type_name << ", " << num_src << " sources, " << size << " elements, "
+            << nthreads << " threads: " << bytes / elapsed / 1e9 << " GB/s";
+}
+
+TEST(COMM_PERF, ReduceSumBandwidth) {
+  const std::vector<size_t> sizes = mxnet::test::performance_run ?
+      std::vector<size_t>{1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 25} :
+      std::vector<size_t>{1 << 10, 1 << 18};
+  const std::vector<size_t> source_counts = mxnet::test::performance_run ?
+      std::vector<size_t>{2, 4, 8, 16, 32} : std::vector<size_t>{4, 16};
+  const std::vector<int> thread_counts = mxnet::test::performance_run ?
+      std::vector<int>{1, 4, 8, 16} : std::vector<int>{1, 4};
+  for (size_t size : sizes) {
+    const size_t iterations = std::max<size_t>(1, (mxnet::test::performance_run ?
+                                                   (1 << 28) : (1 << 22)) / size);
+    for (size_t num_src : source_counts) {
+      for (int nthreads : thread_counts) {
+        RunReduceBandwidth<float>("float32", num_src, size, nthreads, iterations);
+        RunReduceBandwidth<half_t>("float16", num_src, size, nthreads, iterations);
+      }
+    }
+  }
+}
@@ -0,0 +1,184 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file gradient_compression_test.cc
+ * \brief Round trips and throughput of the CPU gradient compression types
+*/
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <gtest/gtest.h>
+#include <mxnet/ndarray.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/kvstore/gradient_compression.h"
+#include "../include/test_util.h"
+
+using mxnet::NDArray;
+using mxnet::kvstore::GradientCompression;
+
+static std::vector<std::pair<std::string, std::string>> Params(const std::string &type) {
+  return {{"type", type}, {"k", "4"}};
+}
+
+static NDArray FromVector(const std::vector<float> &v) {
+  NDArray arr(mxnet::TShape{static_cast<int64_t>(v.size())}, mxnet::Context::CPU());
+  arr.SyncCopyFromCPU(v.data(), v.size());
+  return arr;
+}
+
+static std::vector<float> ToVector(const NDArray &arr) {
+  std::vector<float> v(arr.shape().Size());
+  arr.SyncCopyToCPU(v.data(), v.size());
+  return v;
+}
+
+static std::vector<float> RandomGradient(size_t size) {
+  std::mt19937 gen(7);
+  std::normal_distribution<float> dist;
+  std::vector<float> grad(size);
+  for (auto &g : grad) g = dist(gen);
+  return grad;
+}
+
+/*!
+ * \brief compress grad with a zero residual and decompress it
+ * \return the decompressed gradient and the residual
+ */
+static std::pair<std::vector<float>, std::vector<float>> RoundTrip(
+    GradientCompression *gc, const std::vector<float> &grad) {
+  NDArray from = FromVector(grad);
+  NDArray residual = FromVector(std::vector<float>(grad.size(), 0));
+  NDArray compressed(mxnet::TShape{gc->GetCompressedSize(grad.size())}, mxnet::Context::CPU());
+  NDArray to(from.shape(), mxnet::Context::CPU());
+  gc->Quantize(from, &compressed, &residual, 0);
+  gc->Dequantize(compressed, &to, 0);
+  return {ToVector(to), ToVector(residual)};
+}
+
+TEST(GRADIENT_COMPRESSION, ErrorFeedback) {
+  // nothing is lost, what was not sent is in the residual
+  for (const std::string type : {"2bit", "1bit", "8bit", "topk"}) {
+    for (size_t size : {1, 255, 1024, 5000}) {
+      GradientCompression gc;
+      gc.SetParams(Params(type));
+      const std::vector<float> grad = RandomGradient(size);
+      const auto result = RoundTrip(&gc, grad);
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_NEAR(result.first[i] + result.second[i], grad[i], 1e-5)
+          << type << ", size " << size << ", index " << i;
+      }
+    }
+  }
+}
+
+TEST(GRADIENT_COMPRESSION, TopKSendsLargest) {
+  GradientCompression gc;
+  gc.SetParams(Params("topk"));
+  const size_t size = 1000, block = 256, k = 4;
+  const std::vector<float> grad = RandomGradient(size);
+  const std::vector<float> sent = RoundTrip(&gc, grad).first;
+  for (size_t begin = 0; begin < size; begin += block) {
+    const size_t end = std::min(size, begin + block);
+    std::vector<float> magnitudes;
+    size_t num_sent = 0;
+    for (size_t i = begin; i < end; ++i) {
+      magnitudes.push_back(std::fabs(grad[i]));
+      if (sent[i] != 0) ++num_sent;
+    }
+    EXPECT_EQ(num_sent, std::min(k, end - begin));
+    std::sort(magnitudes.rbegin(), magnitudes.rend());
+    const float smallest_sent = magnitudes[num_sent - 1];
+    for (size_t i = begin; i < end; ++i) {
+      EXPECT_EQ(sent[i] != 0, std::fabs(grad[i]) >= smallest_sent) << "index " << i;
+    }
+  }
+}
+
+TEST(GRADIENT_COMPRESSION, EightBitIsUnbiased) {
+  // the mean of many roundings of one value is close to the value
+  GradientCompression gc;
+  gc.SetParams(Params("8bit"));
+  std::vector<float> grad(256, 0.3f);
+  grad[0] = 1.0f;
+  NDArray from = FromVector(grad);
+  NDArray compressed(mxnet::TShape{gc.GetCompressedSize(grad.size())}, mxnet::Context::CPU());
+  NDArray to(from.shape(), mxnet::Context::CPU());
+  double sum = 0;
+  const int rounds = 200;
+  for (int r = 0; r < rounds; ++r) {
+    // a fresh residual every round, so only the random rounding averages out
+    NDArray residual = FromVector(std::vector<float>(grad.size(), 0));
+    gc.Quantize(from, &compressed, &residual, 0);
+    gc.Dequantize(compressed, &to, 0);
+    const std::vector<float> sent = ToVector(to);
+    for (size_t i = 1; i < sent.size(); ++i) sum += sent[i];
+  }
+  EXPECT_NEAR(sum / (rounds * 255), 0.3, 1e-3);
+}
+
+TEST(GRADIENT_COMPRESSION, CompressedSize) {
+  GradientCompression gc;
+  gc.SetParams(Params("2bit"));
+  EXPECT_EQ(gc.GetCompressedSize(33), 3);
+  gc.SetParams(Params("1bit"));
+  EXPECT_EQ(gc.GetCompressedSize(2048), 66);
+  gc.SetParams(Params("8bit"));
+  EXPECT_EQ(gc.GetCompressedSize(257), 130);
+  gc.SetParams(Params("topk"));
+  EXPECT_EQ(gc.GetCompressedSize(512), 8);
+}
+
+TEST(GRADIENT_COMPRESSION_PERF, Throughput) {
+  const size_t size = mxnet::test::performance_run ? (1 << 24) : (1 << 20);
+  const int iterations = mxnet::test::performance_run ? 20 : 2;
+  const std::vector<float> grad = RandomGradient(size);
+  for (const std::string type : {"2bit", "1bit", "8bit", "topk"}) {
+    GradientCompression gc;
+    gc.SetParams(Params(type));
+    NDArray from = FromVector(grad);
+    NDArray residual = FromVector(std::vector<float>(size, 0));
+    NDArray compressed(mxnet::TShape{gc.GetCompressedSize(size)}, mxnet::Context::CPU());
+    NDArray to(from.shape(), mxnet::Context::CPU());
+    gc.Quantize(from, &compressed, &residual, 0);
+    compressed.WaitToRead();
+    double start = dmlc::GetTime();
+    for (int i = 0; i < iterations; ++i) {
+      gc.Quantize(from, &compressed, &residual, 0);
+    }
+    compressed.WaitToRead();
+    const double quantize = dmlc::GetTime() - start;
+    start = dmlc::GetTime();
+    for (int i = 0; i < iterations; ++i) {
+      gc.Dequantize(compressed, &to, 0);
+    }
+    to.WaitToRead();
+    const double dequantize = dmlc::GetTime() - start;
+    const double bytes = static_cast<double>(size * sizeof(float)) * iterations;
+    LOG(INFO) << type << ": " << size / static_cast<double>(gc.GetCompressedSize(size))
+              << "x smaller, quantize " << bytes / quantize / 1e9 << " GB/s, dequantize "
+              << bytes / dequantize / 1e9 << " GB/s";
+  }
+}
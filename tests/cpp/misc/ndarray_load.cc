@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file ndarray_load.cc
+ * \brief Loading saved NDArray lists from memory without copying, and the aligned format
+*/
+#include <dmlc/memory_io.h>
+#include <gtest/gtest.h>
+#include <mxnet/ndarray.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using mxnet::NDArray;
+using mxnet::TShape;
+
+TEST(NDArrayLoad, LoadFromMemoryRefersToBuffer) {
+  std::vector<float> weight(6);
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = static_cast<float>(i) * 0.5f;
+  NDArray a(TShape{2, 3}, mxnet::Context::CPU());
+  a.SyncCopyFromCPU(weight.data(), weight.size());
+  NDArray b(TShape{4}, mxnet::Context::CPU(), false, mshadow::kUint8);
+  b = 7;
+  std::string saved;
+  {
+    dmlc::MemoryStringStream fo(&saved);
+    NDArray::Save(&fo, {a, b}, {"arg:a", "aux:b"});
+  }
+  auto buffer = std::make_shared<std::vector<char>>(saved.begin(), saved.end());
+  std::weak_ptr<std::vector<char>> alive = buffer;
+  std::vector<NDArray> data;
+  std::vector<std::string> keys;
+  NDArray::LoadFromMemory(buffer->data(), buffer->size(), buffer, &data, &keys);
+  const char *begin = buffer->data(), *end = begin + buffer->size();
+  buffer.reset();
+
+  ASSERT_EQ(data.size(), 2U);
+  EXPECT_EQ(keys, std::vector<std::string>({"arg:a", "aux:b"}));
+  EXPECT_EQ(data[0].shape(), TShape({2, 3}));
+  EXPECT_EQ(data[1].dtype(), mshadow::kUint8);
+  for (const NDArray &nd : data) {
+    const char *dptr = static_cast<const char*>(nd.data().dptr_);
+    EXPECT_TRUE(dptr >= begin && dptr < end);
+  }
+  std::vector<float> loaded(weight.size());
+  data[0].SyncCopyToCPU(loaded.data(), loaded.size());
+  EXPECT_EQ(loaded, weight);
+
+  // the arrays keep the buffer alive
+  EXPECT_FALSE(alive.expired());
+  data.clear();
+  EXPECT_TRUE(alive.expired());
+}
+
+TEST(NDArrayLoad, SaveAlignedAlignsData) {
+  NDArray small(TShape{3}, mxnet::Context::CPU());
+  small = 1;
+  NDArray large(TShape{1000, 3}, mxnet::Context::CPU(), false, mshadow::kFloat64);
+  large = 2;
+  std::string saved;
+  {
+    dmlc::MemoryStringStream fo(&saved);
+    NDArray::SaveAligned(&fo, {small, large}, {});
+  }
+  // copies into a page aligned buffer, as a memory mapped file would be
+  std::shared_ptr<char> buffer(new char[saved.size() + 4096], std::default_delete<char[]>());
+  char *begin = buffer.get() + (4096 - reinterpret_cast<uintptr_t>(buffer.get()) % 4096);
+  std::copy(saved.begin(), saved.end(), begin);
+  std::vector<NDArray> data;
+  std::vector<std::string> keys;
+  NDArray::LoadFromMemory(begin, saved.size(), buffer, &data, &keys);
+  ASSERT_EQ(data.size(), 2U);
+  EXPECT_TRUE(keys.empty());
+  const uintptr_t small_offset = static_cast<char*>(data[0].data().dptr_) - begin;
+  const uintptr_t large_offset = static_cast<char*>(data[1].data().dptr_) - begin;
+  EXPECT_LT(small_offset, saved.size());
+  EXPECT_EQ(small_offset % 64, 0U);
+  EXPECT_LT(large_offset, saved.size());
+  EXPECT_EQ(large_offset % 4096, 0U);
+
+  // the same arrays through a stream
+  std::vector<NDArray> streamed;
+  dmlc::MemoryStringStream fi(&saved);
+  NDArray::Load(&fi, &streamed, &keys);
+  ASSERT_EQ(streamed.size(), 2U);
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(streamed[i].shape(), data[i].shape());
+    EXPECT_EQ(streamed[i].dtype(), data[i].dtype());
+    EXPECT_EQ(0, memcmp(streamed[i].data().dptr_, data[i].data().dptr_,
+                        data[i].shape().Size() * mshadow::mshadow_sizeof(data[i].dtype())));
+  }
+}
+
+TEST(NDArrayLoad, SaveAlignedLargeArrayFirst) {
+  // the gap between the index and the data of a first array of a page or more spans
+  // more than a page of padding
+  std::vector<float> weight(300 * 20);
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = static_cast<float>(i) - 100.0f;
+  NDArray large(TShape{300, 20}, mxnet::Context::CPU());
+  large.SyncCopyFromCPU(weight.data(), weight.size());
+  NDArray small(TShape{5}, mxnet::Context::CPU(), false, mshadow::kInt32);
+  small = 3;
+  std::string saved;
+  {
+    dmlc::MemoryStringStream fo(&saved);
+    NDArray::SaveAligned(&fo, {large, small}, {"large", "small"});
+  }
+  std::shared_ptr<char> buffer(new char[saved.size() + 4096], std::default_delete<char[]>());
+  char *begin = buffer.get() + (4096 - reinterpret_cast<uintptr_t>(buffer.get()) % 4096);
+  std::copy(saved.begin(), saved.end(), begin);
+  std::vector<NDArray> data;
+  std::vector<std::string> keys;
+  NDArray::LoadFromMemory(begin, saved.size(), buffer, &data, &keys);
+  ASSERT_EQ(data.size(), 2U);
+  EXPECT_EQ(keys, std::vector<std::string>({"large", "small"}));
+  const uintptr_t large_offset = static_cast<char*>(data[0].data().dptr_) - begin;
+  EXPECT_EQ(large_offset % 4096, 0U);
+  EXPECT_LE(large_offset + weight.size() * sizeof(float), saved.size());
+  std::vector<float> loaded(weight.size());
+  data[0].SyncCopyToCPU(loaded.data(), loaded.size());
+  EXPECT_EQ(loaded, weight);
+  std::vector<int32_t> small_loaded(5);
+  data[1].SyncCopyToCPU(small_loaded.data(), small_loaded.size());
+  EXPECT_EQ(small_loaded, std::vector<int32_t>(5, 3));
+  // the padding after the index page is zeros, up to the record header before the data
+  EXPECT_GE(large_offset, 8192U);
+  for (size_t i = 4096; i + 256 < large_offset; ++i) {
+    ASSERT_EQ(saved[i], 0) << "byte " << i;
+  }
+
+  // the same arrays through a stream
+  std::vector<NDArray> streamed;
+  dmlc::MemoryStringStream fi(&saved);
+  NDArray::Load(&fi, &streamed, &keys);
+  ASSERT_EQ(streamed.size(), 2U);
+  streamed[0].SyncCopyToCPU(loaded.data(), loaded.size());
+  EXPECT_EQ(loaded, weight);
+}
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file predict_batcher.cc
+ * \brief The predict API batcher gives the same outputs as single requests
+*/
+#include <dmlc/memory_io.h>
+#include <gtest/gtest.h>
+#include <mxnet/c_predict_api.h>
+#include <mxnet/ndarray.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const mx_uint kNumInputs = 4;
+const mx_uint kNumHidden = 3;
+
+// data -> FullyConnected(num_hidden=3)
+const char *kSymbolJson =
+  "{\"nodes\": ["
+  "{\"op\": \"null\", \"name\": \"data\", \"inputs\": []},"
+  "{\"op\": \"null\", \"name\": \"fc_weight\", \"inputs\": []},"
+  "{\"op\": \"null\", \"name\": \"fc_bias\", \"inputs\": []},"
+  "{\"op\": \"FullyConnected\", \"name\": \"fc\", \"attrs\": {\"num_hidden\": \"3\"},"
+  " \"inputs\": [[0, 0, 0], [1, 0, 0], [2, 0, 0]]}],"
+  "\"arg_nodes\": [0, 1, 2], \"heads\": [[3, 0, 0]],"
+  "\"attrs\": {\"mxnet_version\": [\"int\", 10400]}}";
+
+std::string SavedParams() {
+  std::vector<float> weight(kNumHidden * kNumInputs), bias(kNumHidden);
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = 0.25f * i - 1.0f;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = 0.5f * i;
+  mxnet::NDArray w(mxnet::TShape{kNumHidden, kNumInputs}, mxnet::Context::CPU());
+  w.SyncCopyFromCPU(weight.data(), weight.size());
+  mxnet::NDArray b(mxnet::TShape{kNumHidden}, mxnet::Context::CPU());
+  b.SyncCopyFromCPU(bias.data(), bias.size());
+  std::string saved;
+  dmlc::MemoryStringStream fo(&saved);
+  mxnet::NDArray::Save(&fo, {w, b}, {"arg:fc_weight", "arg:fc_bias"});
+  return saved;
+}
+
+std::vector<float> RequestInput(int request) {
+  std::vector<float> input(kNumInputs);
+  for (mx_uint i = 0; i < kNumInputs; ++i) input[i] = 0.1f * (request + 1) * (i + 1) - 0.3f;
+  return input;
+}
+
+}  // namespace
+
+TEST(PredictBatcher, MatchesSingleRequests) {
+  const std::string params = SavedParams();
+  const char *input_keys[] = {"data"};
+  const mx_uint shape_indptr[] = {0, 2};
+  const mx_uint shape_data[] = {1, kNumInputs};
+  const int num_requests = 7;
+
+  // expected outputs from a predictor running one request at a time
+  std::vector<std::vector<float>> expected(num_requests, std::vector<float>(kNumHidden));
+  PredictorHandle pred = nullptr;
+  ASSERT_EQ(MXPredCreate(kSymbolJson, params.data(), static_cast<int>(params.size()), 1, 0,
+                         1, input_keys, shape_indptr, shape_data, &pred), 0);
+  for (int r = 0; r < num_requests; ++r) {
+    const std::vector<float> input = RequestInput(r);
+    ASSERT_EQ(MXPredSetInput(pred, "data", input.data(), kNumInputs), 0);
+    ASSERT_EQ(MXPredForward(pred), 0);
+    ASSERT_EQ(MXPredGetOutput(pred, 0, expected[r].data(), kNumHidden), 0);
+  }
+  ASSERT_EQ(MXPredFree(pred), 0);
+
+  // Batches of up to 4, bound for sizes 1, 2 and 4. Seven concurrent requests give a full
+  // batch and a partial one of 3 running on the predictor for 4, unless they arrive apart.
+  PredictorBatcherHandle batcher = nullptr;
+  ASSERT_EQ(MXPredBatcherCreate(kSymbolJson, params.data(), static_cast<int>(params.size()),
+                                1, 0, 1, input_keys, shape_indptr, shape_data,
+                                4, 200000, &batcher), 0);
+  mx_uint *out_shape = nullptr, out_ndim = 0;
+  ASSERT_EQ(MXPredBatcherGetOutputShape(batcher, 0, &out_shape, &out_ndim), 0);
+  ASSERT_EQ(out_ndim, 2U);
+  EXPECT_EQ(out_shape[0], 1U);
+  EXPECT_EQ(out_shape[1], kNumHidden);
+
+  auto predict = [batcher](int r, std::vector<float> *output, int *ret) {
+    const std::vector<float> input = RequestInput(r);
+    const mx_float *inputs[] = {input.data()};
+    mx_float *outputs[] = {output->data()};
+    *ret = MXPredBatcherPredict(batcher, inputs, outputs);
+  };
+  std::vector<std::vector<float>> outputs(num_requests, std::vector<float>(kNumHidden, -1));
+  std::vector<int> rets(num_requests, -1);
+  std::vector<std::thread> clients;
+  for (int r = 0; r < num_requests; ++r) {
+    clients.emplace_back(predict, r, &outputs[r], &rets[r]);
+  }
+  for (auto &client : clients) client.join();
+  for (int r = 0; r < num_requests; ++r) {
+    EXPECT_EQ(rets[r], 0);
+    for (mx_uint i = 0; i < kNumHidden; ++i) {
+      EXPECT_NEAR(outputs[r][i], expected[r][i], 1e-5) << "request " << r << " output " << i;
+    }
+  }
+
+  // a lone request runs as a batch of one after the delay
+  std::vector<float> single(kNumHidden, -1);
+  int ret = -1;
+  predict(num_requests - 1, &single, &ret);
+  EXPECT_EQ(ret, 0);
+  for (mx_uint i = 0; i < kNumHidden; ++i) {
+    EXPECT_NEAR(single[i], expected[num_requests - 1][i], 1e-5);
+  }
+  ASSERT_EQ(MXPredBatcherFree(batcher), 0);
+}
@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file predict_pool.cc
+ * \brief Predictors of a pool share its weights and give the same outputs as MXPredCreate
+*/
+#include <dmlc/memory_io.h>
+#include <gtest/gtest.h>
+#include <mxnet/c_predict_api.h>
+#include <mxnet/ndarray.h>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/c_api/c_predict_api_common.h"
+
+namespace {
+
+const mx_uint kNumInputs = 4;
+const mx_uint kNumHidden = 3;
+const char *kInputKeys[] = {"data"};
+const mx_uint kShapeIndptr[] = {0, 2};
+const mx_uint kShapeData[] = {1, kNumInputs};
+
+// data -> FullyConnected(num_hidden=3)
+const char *kSymbolJson =
+  "{\"nodes\": ["
+  "{\"op\": \"null\", \"name\": \"data\", \"inputs\": []},"
+  "{\"op\": \"null\", \"name\": \"fc_weight\", \"inputs\": []},"
+  "{\"op\": \"null\", \"name\": \"fc_bias\", \"inputs\": []},"
+  "{\"op\": \"FullyConnected\", \"name\": \"fc\", \"attrs\": {\"num_hidden\": \"3\"},"
+  " \"inputs\": [[0, 0, 0], [1, 0, 0], [2, 0, 0]]}],"
+  "\"arg_nodes\": [0, 1, 2], \"heads\": [[3, 0, 0]],"
+  "\"attrs\": {\"mxnet_version\": [\"int\", 10400]}}";
+
+/*!
+ * \brief the saved weight and bias of the symbol
+ * \param weight_dtype dtype the weight is saved with
+ * \param bias_shape shape the bias is saved with, of kNumHidden elements
+ */
+std::string SavedParams(int weight_dtype, const mxnet::TShape &bias_shape) {
+  std::vector<double> weight(kNumHidden * kNumInputs);
+  std::vector<float> bias(kNumHidden);
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = 0.25 * i - 1.0;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = 0.5f * i;
+  mxnet::NDArray w(mxnet::TShape{kNumHidden, kNumInputs}, mxnet::Context::CPU(), false,
+                   weight_dtype);
+  if (weight_dtype == mshadow::kFloat64) {
+    w.SyncCopyFromCPU(weight.data(), weight.size());
+  } else {
+    const std::vector<float> float_weight(weight.begin(), weight.end());
+    w.SyncCopyFromCPU(float_weight.data(), float_weight.size());
+  }
+  mxnet::NDArray b(bias_shape, mxnet::Context::CPU());
+  b.SyncCopyFromCPU(bias.data(), bias.size());
+  std::string saved;
+  dmlc::MemoryStringStream fo(&saved);
+  mxnet::NDArray::Save(&fo, {w, b}, {"arg:fc_weight", "arg:fc_bias"});
+  return saved;
+}
+
+std::vector<float> Predict(PredictorHandle pred, int request) {
+  std::vector<float> input(kNumInputs), output(kNumHidden, -1);
+  for (mx_uint i = 0; i < kNumInputs; ++i) input[i] = 0.1f * (request + 1) * (i + 1) - 0.3f;
+  EXPECT_EQ(MXPredSetInput(pred, "data", input.data(), kNumInputs), 0);
+  EXPECT_EQ(MXPredForward(pred), 0);
+  EXPECT_EQ(MXPredGetOutput(pred, 0, output.data(), kNumHidden), 0);
+  return output;
+}
+
+const void *ArgData(PredictorHandle pred, const std::string &name) {
+  const MXAPIPredictor *p = static_cast<const MXAPIPredictor*>(pred);
+  return p->arg_arrays[p->key2arg.at(name)].data().dptr_;
+}
+
+/*!
+ * \brief checks two predictors of a pool made from params against MXPredCreate
+ * \param reference the float32 params of the same values for MXPredCreate
+ * \return the addresses of the weight and the bias used by the predictors of the pool
+ */
+std::pair<const char*, const char*> CheckPool(const std::string &params,
+                                              const std::string &reference) {
+  PredictorHandle single = nullptr;
+  EXPECT_EQ(MXPredCreate(kSymbolJson, reference.data(), static_cast<int>(reference.size()),
+                         1, 0, 1, kInputKeys, kShapeIndptr, kShapeData, &single), 0);
+  PredictorPoolHandle pool = nullptr;
+  EXPECT_EQ(MXPredPoolCreate(kSymbolJson, params.data(), static_cast<int>(params.size()),
+                             1, 0, 1, kInputKeys, kShapeIndptr, kShapeData, &pool), 0);
+  PredictorHandle first = nullptr, second = nullptr;
+  EXPECT_EQ(MXPredPoolCreatePredictor(pool, &first), 0);
+  EXPECT_EQ(MXPredPoolCreatePredictor(pool, &second), 0);
+  // the predictors outlive their pool
+  EXPECT_EQ(MXPredPoolFree(pool), 0);
+
+  const int num_requests = 3;
+  std::vector<std::vector<float>> expected;
+  for (int r = 0; r < num_requests; ++r) expected.push_back(Predict(single, r));
+  for (int r = 0; r < num_requests; ++r) {
+    // the predictors run different inputs in turn
+    const std::vector<float> a = Predict(first, r);
+    const std::vector<float> b = Predict(second, num_requests - 1 - r);
+    for (mx_uint i = 0; i < kNumHidden; ++i) {
+      EXPECT_NEAR(a[i], expected[r][i], 1e-5) << "request " << r << " output " << i;
+      EXPECT_NEAR(b[i], expected[num_requests - 1 - r][i], 1e-5)
+          << "request " << num_requests - 1 - r << " output " << i;
+    }
+  }
+
+  // weights are shared by the predictors, the inputs are their own
+  EXPECT_EQ(ArgData(first, "fc_weight"), ArgData(second, "fc_weight"));
+  EXPECT_EQ(ArgData(first, "fc_bias"), ArgData(second, "fc_bias"));
+  EXPECT_NE(ArgData(first, "data"), ArgData(second, "data"));
+  const MXAPIPredictor *p = static_cast<const MXAPIPredictor*>(first);
+  const mxnet::NDArray &weight = p->arg_arrays[p->key2arg.at("fc_weight")];
+  EXPECT_EQ(weight.dtype(), mshadow::kFloat32);
+  EXPECT_EQ(weight.shape(), mxnet::TShape({kNumHidden, kNumInputs}));
+  const auto addresses = std::make_pair(static_cast<const char*>(ArgData(first, "fc_weight")),
+                                        static_cast<const char*>(ArgData(first, "fc_bias")));
+
+  EXPECT_EQ(MXPredFree(first), 0);
+  EXPECT_EQ(MXPredFree(second), 0);
+  EXPECT_EQ(MXPredFree(single), 0);
+  return addresses;
+}
+
+}  // namespace
+
+TEST(PredictPool, SharedFloat32Weights) {
+  const std::string params = SavedParams(mshadow::kFloat32, mxnet::TShape{kNumHidden});
+  const auto addresses = CheckPool(params, params);
+  // both refer to the one copy of the params the pool keeps, the bias saved after the weight
+  EXPECT_GT(addresses.second, addresses.first);
+  EXPECT_LT(addresses.second - addresses.first, static_cast<ptrdiff_t>(params.size()));
+}
+
+TEST(PredictPool, CopiedWeightsOfOtherDtype) {
+  // float64 weights are converted once by the pool, then shared by its predictors
+  CheckPool(SavedParams(mshadow::kFloat64, mxnet::TShape{kNumHidden}),
+            SavedParams(mshadow::kFloat32, mxnet::TShape{kNumHidden}));
+}
+
+TEST(PredictPool, ReshapedWeightsOfOtherShape) {
+  // a bias saved as (3, 1) has the right size and is used reshaped, without a copy
+  const std::string params = SavedParams(mshadow::kFloat32, mxnet::TShape{kNumHidden, 1});
+  const auto addresses = CheckPool(params,
+                                   SavedParams(mshadow::kFloat32, mxnet::TShape{kNumHidden}));
+  EXPECT_GT(addresses.second, addresses.first);
+  EXPECT_LT(addresses.second - addresses.first, static_cast<ptrdiff_t>(params.size()));
+}
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  \file broadcast_perf.cc
+ *  \brief Check and time the broadcast binary operators over the broadcast patterns
+ */
+
+#include <gtest/gtest.h>
+#include <mxnet/tensor_blob.h>
+#include "../include/test_op_runner.h"
+#include "../include/test_core_op.h"
+
+using namespace mxnet;
+
+using kwargs_t = test::op::kwargs_t;
+
+/*! \brief lhs and rhs shapes of the scalar, row, column and general broadcast patterns */
+static std::vector<std::vector<TShape> > BroadcastShapes(const index_t rows,
+                                                         const index_t cols) {
+  return {
+    { TShape({rows, cols}), TShape({rows, cols}) },
+    { TShape({rows, cols}), TShape({1, 1}) },
+    { TShape({rows, cols}), TShape({1, cols}) },
+    { TShape({rows, cols}), TShape({rows, 1}) },
+    { TShape({rows, 1}), TShape({1, cols}) },
+    { TShape({4, 1, rows / 4, cols}), TShape({1, 3, rows / 4, 1}) }
+  };
+}
+
+/*!
+ * \brief broadcast_sub against a direct evaluation of the broadcast
+ */
+TEST(BROADCAST_PERF, ExecuteForward) {
+  for (const std::vector<TShape>& shapes : BroadcastShapes(64, 75)) {
+    test::op::CoreOpExecutor<float> op(false, shapes);
+    op.set_verbose(false);
+    op.Init(op.ArgsWithOpName({}, "broadcast_sub", COREOP_BWD_OP_NAME_VALUE_NONE));
+    op.Execute();
+    const NDArray& lhs = op.inputs()[0];
+    const NDArray& rhs = op.inputs()[1];
+    const NDArray& out = op.outputs()[0];
+    out.WaitToRead();
+    const int ndim = out.shape().ndim();
+    const float *l = lhs.data().dptr<float>();
+    const float *r = rhs.data().dptr<float>();
+    const float *o = out.data().dptr<float>();
+    std::vector<index_t> coord(ndim, 0);
+    for (size_t i = 0; i < out.shape().Size(); ++i) {
+      index_t li = 0, ri = 0;
+      for (int d = 0; d < ndim; ++d) {
+        li = li * lhs.shape()[d] + (lhs.shape()[d] > 1 ? coord[d] : 0);
+        ri = ri * rhs.shape()[d] + (rhs.shape()[d] > 1 ? coord[d] : 0);
+      }
+      ASSERT_EQ(o[i], l[li] - r[ri]) << lhs.shape() << " " << rhs.shape() << " at " << i;
+      for (int d = ndim - 1; d >= 0 && ++coord[d] == out.shape()[d]; --d) {
+        coord[d] = 0;
+      }
+    }
+  }
+}
+
+template<typename DType = float>
+static void RunBroadcastTimingTest(const bool isGPU, const char *op_name) {
+  const kwargs_t kwargs = test::op::CoreOpExecutor<DType>::ArgsWithOpName(
+    {}, op_name, COREOP_BWD_OP_NAME_VALUE_NONE);
+
+  // prime code and cache before the performance runs
+  test::op::CoreOperatorRunner<DType> runner;
+  runner.RunBidirectional(false, { {128, 128}, {1, 128} }, kwargs, 1);
+
+  // Do the performance runs
+  std::vector<std::vector<TShape> > shape_sets;
+  if (test::performance_run) {
+    for (const index_t size : { 64, 256, 1024, 4096 }) {
+      for (const std::vector<TShape>& shapes : BroadcastShapes(size, size)) {
+        shape_sets.emplace_back(shapes);
+      }
+    }
+  } else {
+    shape_sets = BroadcastShapes(128, 128);
+  }
+  const char *pu = isGPU ? "GPU" : "CPU";
+  for (const std::vector<TShape>& shapes : shape_sets) {
+    std::cout << shapes[0] << " " << op_name << " " << shapes[1] << std::endl;
+    runner.TimingTest(std::string(op_name) + " Operator " + pu, isGPU, false, kwargs,
+                      2, 10, shapes, false);
+  }
+}
+
+/*!
+ * \brief Broadcast timing test for CPU
+ */
+TEST(BROADCAST_PERF, TimingCPU) {
+  RunBroadcastTimingTest(false, "broadcast_add");
+  RunBroadcastTimingTest(false, "broadcast_mul");
+}
+
+#if MXNET_USE_GPU == 1
+/*!
+ * \brief Broadcast timing test for GPU
+ */
+TEST(BROADCAST_PERF, TimingGPU) {
+  RunBroadcastTimingTest(true, "broadcast_add");
+  RunBroadcastTimingTest(true, "broadcast_mul");
+}
+#endif  // MXNET_USE_GPU == 1
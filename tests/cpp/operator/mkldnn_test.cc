@@ -28,11 +28,17 @@
 #include <mkldnn_types.h>
 #include <cmath>
 #include <climits>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "mxnet/imperative.h"
 #include "../../src/operator/nn/mkldnn/mkldnn_ops-inl.h"
 #include "../../src/operator/nn/mkldnn/mkldnn_base-inl.h"
+#include "../../src/operator/nn/mkldnn/mkldnn_primitive_cache.h"
 #include "../include/test_mkldnn.h"
 
 using namespace mxnet;
@@ -417,4 +423,67 @@ TEST(MKLDNN_NDArray, CopyFrom) {
   }
 }
 
+TEST(MKLDNN_BASE, PrimitiveCacheLRU) {
+  setenv("MXNET_MKLDNN_CACHE_NUM", "2", 1);
+  setenv("MXNET_MKLDNN_CACHE_BYTES", "250", 1);
+  MKLDNNPrimitiveCache<int, int, std::hash<int>> cache("Test");
+  unsetenv("MXNET_MKLDNN_CACHE_NUM");
+  unsetenv("MXNET_MKLDNN_CACHE_BYTES");
+  int created = 0;
+  auto get = [&](int key, size_t bytes) {
+    return *cache.Get(key, [&]() { ++created; return key * 10; },
+                      [bytes](int) { return bytes; });
+  };
+  EXPECT_EQ(get(1, 100), 10);
+  EXPECT_EQ(get(2, 100), 20);
+  // 1 is used last, so 2 is evicted for 3
+  EXPECT_EQ(get(1, 100), 10);
+  EXPECT_EQ(get(3, 100), 30);
+  EXPECT_EQ(created, 3);
+  EXPECT_EQ(get(1, 100), 10);
+  EXPECT_EQ(created, 3);
+  EXPECT_EQ(get(2, 100), 20);
+  EXPECT_EQ(created, 4);
+  // over the byte budget by itself, everything else is evicted
+  EXPECT_EQ(get(4, 300), 40);
+  EXPECT_EQ(cache.size(), 1U);
+  EXPECT_EQ(cache.hits(), 2U);
+  EXPECT_EQ(cache.misses(), 5U);
+  EXPECT_EQ(cache.evictions(), 4U);
+}
+
+TEST(MKLDNN_BASE, PrimitiveCacheConcurrentSameKey) {
+  MKLDNNPrimitiveCache<int, int, std::hash<int>> cache("TestConcurrent");
+  std::atomic<int> created(0);
+  auto get = [&](int key) {
+    return cache.Get(key, [&]() { ++created; return key * 10; },
+                     [](int) { return size_t(100); });
+  };
+  // Both threads hold a primitive of key 1 at the same time. The second one gets a
+  // private primitive instead of waiting for the first to release the cached one.
+  std::mutex mu;
+  std::condition_variable cv;
+  int holding = 0;
+  std::vector<bool> cached(2);
+  auto run = [&](int i) {
+    auto prim = get(1);
+    EXPECT_EQ(*prim, 10);
+    cached[i] = prim.cached();
+    std::unique_lock<std::mutex> lock(mu);
+    ++holding;
+    cv.notify_all();
+    cv.wait(lock, [&]() { return holding == 2; });
+  };
+  std::thread first(run, 0), second(run, 1);
+  first.join();
+  second.join();
+  EXPECT_NE(cached[0], cached[1]);
+  EXPECT_EQ(created, 2);
+  EXPECT_EQ(cache.contentions(), 1U);
+  // the private primitive is not cached, the released cached one is used again
+  EXPECT_EQ(cache.size(), 1U);
+  EXPECT_TRUE(get(1).cached());
+  EXPECT_EQ(created, 2);
+}
+
 #endif
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2019 by Contributors
+ * \file storage_perf.cc
+ * \brief Multithreaded alloc/free throughput of the pooled storage managers
+ */
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <mxnet/storage.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/test_util.h"
+#include "../include/test_perf.h"
+#include "../../src/storage/naive_storage_manager.h"
+#include "../../src/storage/pooled_storage_manager.h"
+
+using namespace mxnet;
+
+/*!
+ * \brief Run num_threads threads, each repeatedly allocating a small working set of
+ *  mixed sizes and freeing it again, and print the aggregated alloc/free pairs per second.
+ */
+static void RunAllocFree(const char *name, storage::StorageManager *manager,
+                         const Context &ctx, const size_t num_threads,
+                         const size_t iterations) {
+  const std::vector<size_t> sizes = { 64, 200, 1024, 4000, 16384, 65536, 300000 };
+  test::perf::TimedScope timer;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      std::vector<Storage::Handle> handles(sizes.size());
+      for (size_t i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < sizes.size(); ++j) {
+          handles[j].ctx = ctx;
+          handles[j].size = sizes[j];
+          manager->Alloc(&handles[j]);
+        }
+        for (auto &handle : handles) {
+          manager->Free(handle);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  timer.stop();
+  const double pairs = static_cast<double>(num_threads * iterations * sizes.size());
+  std::cout << name << ", " << num_threads << " threads: "
+            << pairs / timer.elapsedMicroseconds() << " M alloc/free per second" << std::endl;
+}
+
+static std::vector<size_t> ThreadCounts() {
+  if (test::performance_run) {
+    return { 1, 2, 4, 8, 16 };
+  }
+  return { 1, 4 };
+}
+
+TEST(STORAGE_PERF, CPUAllocFree) {
+  const size_t iterations = test::performance_run ? 200000 : 1000;
+  const Context ctx = Context::CPU();
+  for (const size_t num_threads : ThreadCounts()) {
+    storage::NaiveStorageManager<storage::CPUDeviceStorage> naive;
+    RunAllocFree("Unpooled", &naive, ctx, num_threads, iterations);
+    storage::CPUPooledStorageManager pooled;
+    RunAllocFree("CPUPooledStorageManager", &pooled, ctx, num_threads, iterations);
+  }
+}
+
+#if MXNET_USE_GPU
+TEST(STORAGE_PERF, GPUAllocFree) {
+  if (!test::unitTestsWithCuda) {
+    return;
+  }
+  const size_t iterations = test::performance_run ? 200000 : 1000;
+  const Context ctx = Context::GPU(0);
+  CUDA_CALL(hipSetDevice(0));
+  for (const size_t num_threads : ThreadCounts()) {
+    storage::GPUPooledStorageManager pooled;
+    RunAllocFree("GPUPooledStorageManager", &pooled, ctx, num_threads, iterations);
+    storage::GPUPooledRoundedStorageManager rounded;
+    RunAllocFree("GPUPooledRoundedStorageManager", &rounded, ctx, num_threads, iterations);
+  }
+}
+#endif  // MXNET_USE_GPU
@@ -25,8 +25,15 @@
 #include <gtest/gtest.h>
 #include <dmlc/logging.h>
 #include <mxnet/storage.h>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
 #include "test_util.h"
+#include "../../src/common/numa.h"
+#include "../../src/storage/cpu_numa_storage_manager.h"
+#include "../../src/storage/pooled_storage_manager.h"
 
 TEST(Storage, Basic_CPU) {
   constexpr size_t kSize = 1024;
@@ -42,6 +49,90 @@ TEST(Storage, Basic_CPU) {
   storage->Free(handle);
 }
 
+TEST(Storage, CPUPooled) {
+  mxnet::storage::CPUPooledStorageManager manager;
+  mxnet::Storage::Handle handle;
+  handle.size = 100;
+  manager.Alloc(&handle);
+  auto ptr = handle.dptr;
+  manager.Free(handle);
+
+  // Same size bucket (128 bytes), served from the thread cache
+  handle.size = 128;
+  manager.Alloc(&handle);
+  EXPECT_EQ(handle.dptr, ptr);
+  manager.Free(handle);
+
+  // Larger than the per-thread cache limit, served from the shared pool
+  handle.size = 3145728;
+  manager.Alloc(&handle);
+  auto large_ptr = handle.dptr;
+  manager.Free(handle);
+  handle.size = 4194304;
+  manager.Alloc(&handle);
+  EXPECT_EQ(handle.dptr, large_ptr);
+  manager.Free(handle);
+
+  // Chunks freed on another thread can be reused once that thread exits
+  void *worker_ptr = nullptr;
+  std::thread worker([&manager, &worker_ptr]() {
+    mxnet::Storage::Handle h;
+    h.size = 1000;
+    for (int i = 0; i < 4; ++i) {
+      manager.Alloc(&h);
+      manager.Free(h);
+    }
+    worker_ptr = h.dptr;
+  });
+  worker.join();
+  ASSERT_NE(worker_ptr, nullptr);
+  handle.size = 1000;
+  manager.Alloc(&handle);
+  EXPECT_EQ(handle.dptr, worker_ptr);
+  manager.Free(handle);
+}
+
+TEST(Storage, NUMANodeOfDevice) {
+  using mxnet::common::numa::NodeOfDevice;
+  EXPECT_EQ(NodeOfDevice(0, 1), 0);
+  EXPECT_EQ(NodeOfDevice(3, 1), 0);
+  EXPECT_EQ(NodeOfDevice(1, 2), 1);
+  EXPECT_EQ(NodeOfDevice(3, 2), 1);
+  EXPECT_EQ(NodeOfDevice(5, 4), 1);
+  EXPECT_EQ(NodeOfDevice(2, 0), 0);
+  const int num_nodes = mxnet::common::numa::NumNodes();
+  EXPECT_GE(num_nodes, 1);
+  for (int dev_id = 0; dev_id < 2 * num_nodes; ++dev_id) {
+    EXPECT_EQ(NodeOfDevice(dev_id), dev_id % num_nodes);
+  }
+  EXPECT_EQ(mxnet::common::numa::ParseCPUList("0-3,8,10-11\n"),
+            std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_TRUE(mxnet::common::numa::ParseCPUList("").empty());
+  // A node that does not exist is never bound to
+  std::thread worker([num_nodes]() {
+    EXPECT_FALSE(mxnet::common::numa::BindCurrentThreadToNode(num_nodes));
+    EXPECT_FALSE(mxnet::common::numa::BindCurrentThreadToNode(-1));
+  });
+  worker.join();
+}
+
+TEST(Storage, CPUNUMAStorageManager) {
+  const size_t min_mapped = mxnet::storage::CPUNUMAStorageManager::kMinMappedSize;
+  for (int node = 0; node < mxnet::common::numa::NumNodes(); ++node) {
+    mxnet::storage::CPUNUMAStorageManager manager(node);
+    for (size_t size : {size_t(100), min_mapped - 1, min_mapped, size_t(3) << 20}) {
+      mxnet::Storage::Handle handle;
+      handle.size = size;
+      manager.Alloc(&handle);
+      ASSERT_NE(handle.dptr, nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(handle.dptr) % 16, 0);
+      memset(handle.dptr, 0x5a, size);
+      EXPECT_EQ(static_cast<unsigned char*>(handle.dptr)[size - 1], 0x5a);
+      manager.Free(handle);
+    }
+  }
+}
+
 #if MXNET_USE_GPU
 TEST(Storage_GPU, Basic_GPU) {
   if (mxnet::test::unitTestsWithCuda) {
@@ -40,6 +40,7 @@ big_shape = (1200, 1200)        # bigger than MXNET_KVSTORE_BIGARRAY_BOUND
 
 keys_invalid = [999]
 keys_shape = ['3', '5', '7']
+pull_twice_keys_shape = ['15', '17', '19']
 keys_big_shape = ['99']
 fp16_keys_shape = ['4', '6', '8']
 fp16_keys_big_shape = ['100']
@@ -72,6 +73,7 @@ def init_kv():
     # # init kv dns keys
     kv.init(keys_shape, [mx.nd.ones(shape)] * len(keys_shape))
     kv.init(keys_big_shape, [mx.nd.ones(big_shape)] * len(keys_big_shape))
+    kv.init(pull_twice_keys_shape, [mx.nd.ones(shape)] * len(pull_twice_keys_shape))
     # # init kv row_sparse keys
     kv.init(rsp_keys_shape, [mx.nd.ones(shape).tostype('row_sparse')] * len(rsp_keys_shape))
     kv.init(rsp_keys_big_shape, [mx.nd.ones(big_shape).tostype('row_sparse')] * len(rsp_keys_big_shape))
@@ -112,6 +114,19 @@ def test_sync_push_pull(nrepeat):
                 kv.pull(k, out=val)
                 check_diff(val, num)
 
+    def check_default_keys_pull_twice(nrepeat):
+        # keys pushed back to back share a bucket when pushes are fused, and are pulled
+        # together. Pulling a key again without a push must not reuse the earlier pull.
+        for i in range(nrepeat):
+            for k in pull_twice_keys_shape:
+                kv.push(k, mx.nd.ones(shape)*(my_rank+1))
+            num = (nworker + 1) * nworker * rate / 2 * (i + 1) + 1
+            for k in pull_twice_keys_shape:
+                for _ in range(2):
+                    val = mx.nd.zeros(shape)
+                    kv.pull(k, out=val)
+                    check_diff(val, num)
+
     def check_row_sparse_keys(dtype, nrepeat):
         # prepare gradient
         v = mx.nd.zeros(shape, dtype=dtype)
@@ -228,6 +243,7 @@ def test_sync_push_pull(nrepeat):
         check_row_sparse_keys(dtype, nrepeat)
         check_row_sparse_keys_with_zeros(dtype, nrepeat)
         check_big_row_sparse_keys(dtype, nrepeat)
+    check_default_keys_pull_twice(nrepeat)
     print('worker ' + str(my_rank) + ' is done with non compression tests')
 
 def test_sync_2bit_compression(threshold, nrepeat):
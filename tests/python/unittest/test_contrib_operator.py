@@ -262,6 +262,65 @@ def test_multibox_target_op():
     assert_array_equal(cls_target.asnumpy(), expected_cls_target)
 
 
+def _interleave_complex(x):
+    out = np.empty(x.shape[:-1] + (x.shape[-1] * 2,))
+    out[..., 0::2] = x.real
+    out[..., 1::2] = x.imag
+    return out
+
+
+@with_seed()
+def test_fft():
+    # unnormalized transforms like the GPU operator, for lengths of every radix kind
+    for shape in [(3, 1), (5, 16), (4, 12), (2, 30), (7, 13), (2, 3, 4, 10)]:
+        for dtype, tol in [(np.float32, 1e-4), (np.float64, 1e-8)]:
+            data = np.random.normal(size=shape)
+            sym = mx.sym.contrib.fft(mx.sym.Variable('data'), compute_size=2)
+            expected = _interleave_complex(np.fft.fft(data, axis=-1))
+            check_symbolic_forward(sym, {'data': data}, [expected], rtol=tol, atol=tol,
+                                   dtype=dtype)
+            ograd = np.random.normal(size=expected.shape)
+            ograd_complex = ograd[..., 0::2] + 1j * ograd[..., 1::2]
+            igrad = np.fft.ifft(ograd_complex, axis=-1).real * shape[-1]
+            check_symbolic_backward(sym, {'data': data}, [ograd], [igrad], rtol=tol, atol=tol,
+                                    dtype=dtype)
+
+
+@with_seed()
+def test_ifft():
+    for shape in [(3, 1), (5, 16), (4, 12), (2, 30), (7, 13), (2, 3, 4, 10)]:
+        for dtype, tol in [(np.float32, 1e-4), (np.float64, 1e-8)]:
+            data = np.random.normal(size=shape[:-1] + (shape[-1] * 2,))
+            sym = mx.sym.contrib.ifft(mx.sym.Variable('data'), compute_size=2)
+            data_complex = data[..., 0::2] + 1j * data[..., 1::2]
+            expected = np.fft.ifft(data_complex, axis=-1).real * shape[-1]
+            check_symbolic_forward(sym, {'data': data}, [expected], rtol=tol, atol=tol,
+                                   dtype=dtype)
+            ograd = np.random.normal(size=shape)
+            igrad = _interleave_complex(np.fft.fft(ograd, axis=-1))
+            check_symbolic_backward(sym, {'data': data}, [ograd], [igrad], rtol=tol, atol=tol,
+                                    dtype=dtype)
+
+
+@with_seed()
+def test_count_sketch():
+    n, in_dim, out_dim = 37, 50, 11
+    data = np.random.uniform(-10, 10, (n, in_dim))
+    h = np.random.randint(0, out_dim, (1, in_dim))
+    s = np.random.randint(0, 2, (1, in_dim)) * 2 - 1
+    sym = mx.sym.contrib.count_sketch(data=mx.sym.Variable('data'), h=mx.sym.Variable('h'),
+                                      s=mx.sym.Variable('s'), out_dim=out_dim)
+    location = {'data': data, 'h': h, 's': s}
+    expected = np.zeros((n, out_dim))
+    for i in range(in_dim):
+        expected[:, h[0, i]] += data[:, i] * s[0, i]
+    check_symbolic_forward(sym, location, [expected], rtol=1e-3, atol=1e-5)
+    ograd = np.random.normal(size=(n, out_dim))
+    igrad = ograd[:, h[0]] * s
+    check_symbolic_backward(sym, location, [ograd], [igrad], rtol=1e-3, atol=1e-5,
+                            grad_req={'data': 'write', 'h': 'null', 's': 'null'})
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
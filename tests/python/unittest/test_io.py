@@ -381,8 +381,44 @@ def test_LibSVMIter():
         for batch in iter(data_train):
             data_train.get_data().asnumpy()
 
+    def check_libSVMIter_qid():
+        # the query id after the label is skipped
+        data_path = os.path.join(os.getcwd(), 'data_qid.t')
+        with open(data_path, 'w') as fout:
+            fout.write('1 qid:3 0:0.5 2:1.2\n')
+            fout.write('2 qid:3\n')
+            fout.write('3 qid:4 1:2.5\n')
+        data_train = mx.io.LibSVMIter(data_libsvm=data_path, data_shape=(3, ), batch_size=3)
+        batch = data_train.next()
+        batch.data[0].check_format(True)
+        assert_almost_equal(batch.data[0].asnumpy(), [[0.5, 0, 1.2], [0, 0, 0], [0, 2.5, 0]])
+        assert_almost_equal(batch.label[0].asnumpy(), [1, 2, 3])
+
+    def check_libSVMIter_parts():
+        # a mapped file and a directory read through an InputSplit split at the same lines
+        data_dir = os.path.join(os.getcwd(), 'data_parts')
+        if not os.path.exists(data_dir):
+            os.makedirs(data_dir)
+        data_path = os.path.join(data_dir, 'data.t')
+        with open(data_path, 'w') as fout:
+            for i in range(20):
+                fout.write(str(i) + ' ' + ' '.join('%d:1' % j for j in range(i % 7)) + '\n')
+
+        def labels(path, part_index, num_parts):
+            data_iter = mx.io.LibSVMIter(data_libsvm=path, data_shape=(7, ), batch_size=1,
+                                         part_index=part_index, num_parts=num_parts)
+            return [batch.label[0].asnumpy()[0] for batch in data_iter]
+
+        for num_parts in [2, 3]:
+            parts = [labels(data_path, i, num_parts) for i in range(num_parts)]
+            for i in range(num_parts):
+                assert parts[i] == labels(data_dir, i, num_parts)
+            assert sum(parts, []) == list(range(20))
+
     check_libSVMIter_synthetic()
     check_libSVMIter_news_data()
+    check_libSVMIter_qid()
+    check_libSVMIter_parts()
     assertRaises(MXNetError, check_libSVMIter_exception)
 
 
@@ -427,6 +463,73 @@ def test_CSVIter():
     for dtype in ['int32', 'int64', 'float32']:
         check_CSVIter_synthetic(dtype=dtype)
 
+def test_CSVIter_line_format():
+    # blank lines, CRLF line breaks, spaces and trailing commas are accepted
+    cwd = os.getcwd()
+    data_path = os.path.join(cwd, 'data_format.t')
+    with open(data_path, 'w') as fout:
+        fout.write('1,2,3\r\n\n 4, 5e1 ,-6,\n7,8,9.5')
+    data_iter = mx.io.CSVIter(data_csv=data_path, data_shape=(3,), batch_size=3,
+                              preprocess_threads=2)
+    batch = data_iter.next()
+    assert_almost_equal(batch.data[0].asnumpy(), [[1, 2, 3], [4, 50, -6], [7, 8, 9.5]])
+
+def test_CSVIter_number_edge_cases():
+    cwd = os.getcwd()
+    # 19 digit integers above the int64 range saturate instead of wrapping around
+    data_path = os.path.join(cwd, 'data_int64.t')
+    with open(data_path, 'w') as fout:
+        fout.write('9223372036854775807,-9223372036854775807,'
+                   '9300000000000000000,-9300000000000000000\n')
+    data_iter = mx.io.CSVIter(data_csv=data_path, data_shape=(4,), batch_size=1,
+                              dtype='int64')
+    data = data_iter.next().data[0].asnumpy()
+    int64_max = np.iinfo(np.int64).max
+    assert data[0].tolist() == [int64_max, -int64_max, int64_max, np.iinfo(np.int64).min]
+    # the same for int32, through the integer and the floating point paths
+    data_path = os.path.join(cwd, 'data_int32.t')
+    with open(data_path, 'w') as fout:
+        fout.write('2147483647,-2147483648,3000000000,-3000000000,5e9,-5e9,12.7\n')
+    data_iter = mx.io.CSVIter(data_csv=data_path, data_shape=(7,), batch_size=1,
+                              dtype='int32')
+    data = data_iter.next().data[0].asnumpy()
+    int32_max, int32_min = np.iinfo(np.int32).max, np.iinfo(np.int32).min
+    assert data[0].tolist() == [int32_max, int32_min, int32_max, int32_min,
+                                int32_max, int32_min, 12]
+    # Values whose double is halfway between two floats. Rounding them to a double
+    # first would round the float down, the correctly rounded float is the upper one.
+    data_path = os.path.join(cwd, 'data_float.t')
+    with open(data_path, 'w') as fout:
+        fout.write('60.74770545959473,2.048434853553772,0.1,1e-45\n')
+    data_iter = mx.io.CSVIter(data_csv=data_path, data_shape=(4,), batch_size=1)
+    data = data_iter.next().data[0].asnumpy()
+    expected = np.array([float.fromhex('0x1.e5fb4ep+5'), float.fromhex('0x1.06331ep+1'),
+                         0.1, 1e-45], dtype=np.float32)
+    assert data.dtype == np.float32
+    assert np.array_equal(data[0], expected)
+
+def test_CSVIter_prefetch_in_place():
+    # batches are recycled and written in place, check none sees another's rows
+    cwd = os.getcwd()
+    data_path = os.path.join(cwd, 'data_prefetch.t')
+    with open(data_path, 'w') as fout:
+        for i in range(50):
+            fout.write(','.join([str(i)] * 4) + '\n')
+    for ctx in ['cpu', 'gpu']:
+        data_iter = mx.io.CSVIter(data_csv=data_path, data_shape=(4,), batch_size=8,
+                                  round_batch=False, prefetch_buffer=2, ctx=ctx)
+        for epoch in range(2):
+            batches = [(batch.data[0].asnumpy(), batch.pad) for batch in data_iter]
+            assert len(batches) == 7
+            for i, (data, pad) in enumerate(batches[:-1]):
+                expected = np.repeat(np.arange(i * 8, (i + 1) * 8), 4).reshape((8, 4))
+                assert_almost_equal(data, expected)
+                assert pad == 0
+            data, pad = batches[-1]
+            assert_almost_equal(data[:2], [[48] * 4, [49] * 4])
+            assert pad == 6
+            data_iter.reset()
+
 @unittest.skip("Flaky test: https://github.com/apache/incubator-mxnet/issues/11359")
 def test_ImageRecordIter_seed_augmentation():
     get_cifar10()
@@ -515,6 +618,28 @@ def test_ImageRecordIter_seed_augmentation():
     data2 = batch.data[0].asnumpy().astype(np.uint8)
     assert(np.array_equal(data,data2))
 
+
+def test_ImageRecordIter_jpeg_dct_scaling():
+    get_cifar10()
+
+    def decode(jpeg_dct_scaling):
+        dataiter = mx.io.ImageRecordIter(
+            path_imgrec="data/cifar/train.rec",
+            shuffle=False,
+            data_shape=(3, 16, 16),
+            resize=16,
+            batch_size=32,
+            jpeg_dct_scaling=jpeg_dct_scaling)
+        return [batch.data[0].asnumpy() for _, batch in zip(range(4), dataiter)]
+
+    # Decoding the 32x32 images at half scale replaces the resize by the inverse DCT,
+    # which rounds differently. The pixels stay within a few levels of the full decode.
+    for scaled, full in zip(decode(True), decode(False)):
+        assert scaled.shape == full.shape
+        diff = np.abs(scaled - full)
+        assert diff.mean() < 4, diff.mean()
+        assert np.percentile(diff, 99) < 32, np.percentile(diff, 99)
+
 if __name__ == "__main__":
     test_NDArrayIter()
     if h5py:
@@ -525,4 +650,5 @@ if __name__ == "__main__":
     test_NDArrayIter_csr()
     test_CSVIter()
     test_ImageRecordIter_seed_augmentation()
+    test_ImageRecordIter_jpeg_dct_scaling()
     test_image_iter_exception()
@@ -302,6 +302,49 @@ def test_ndarray_saveload():
     os.remove(fname)
 
 
+@with_seed()
+def test_ndarray_saveload_aligned():
+    with TemporaryDirectory(prefix='test_ndarray_saveload_aligned_') as tmpdir:
+        fname = os.path.join(tmpdir, 'aligned.params')
+        data = {'dense': mx.nd.random.uniform(shape=(300, 20)),
+                'int': mx.nd.arange(7, dtype='int32'),
+                'half': mx.nd.ones((3, 5), dtype='float16'),
+                'rsp': mx.nd.array([[0, 1], [0, 0], [2, 3]]).tostype('row_sparse'),
+                'csr': mx.nd.array([[0, 1], [4, 0]]).tostype('csr')}
+        mx.nd.save(fname, data, aligned=True)
+        with open(fname, 'rb') as f:
+            saved = f.read()
+        for loaded in [mx.nd.load(fname), mx.nd.load_frombuffer(saved)]:
+            assert sorted(loaded.keys()) == sorted(data.keys())
+            for k, x in data.items():
+                assert loaded[k].stype == x.stype
+                assert loaded[k].dtype == x.dtype
+                assert same(loaded[k].asnumpy(), x.asnumpy())
+        # writing to a loaded array does not change the file
+        loaded = mx.nd.load(fname)
+        loaded['dense'][:] = 0
+        assert same(mx.nd.load(fname)['dense'].asnumpy(), data['dense'].asnumpy())
+        with open(fname, 'rb') as f:
+            assert f.read() == saved
+
+
+@with_seed()
+def test_ndarray_parsed_op_reuse():
+    # the same op is invoked with alternating parameters, recorded and not
+    x = mx.nd.array([-2, -0.5, 0.5, 2])
+    x.attach_grad()
+    for _ in range(3):
+        assert same(mx.nd.clip(x, 0, 1).asnumpy(), np.array([0, 0, 0.5, 1]))
+        assert same(mx.nd.clip(x, -1, 1).asnumpy(), np.array([-1, -0.5, 0.5, 1]))
+        with mx.autograd.record():
+            y = mx.nd.clip(x, -1, 1) * 2
+        y.backward()
+        assert same(x.grad.asnumpy(), np.array([0, 2, 2, 0]))
+    # ops with a variable number of inputs are parsed for each count
+    for n in [2, 3, 2]:
+        assert same(mx.nd.add_n(*[x] * n).asnumpy(), x.asnumpy() * n)
+
+
 @with_seed()
 def test_ndarray_legacy_load():
     data = []
@@ -1062,6 +1062,32 @@ def test_embedding():
     assert_almost_equal(grad_map["embed_weight"].asnumpy(), np.dot(np_onehot.T, np_grad), rtol=rtol, atol=atol)
 
 
+@with_seed()
+def test_embedding_backward_scatter_add():
+    in_dim = 7
+    out_dim = 5
+    # duplicate indices, and indices out of range that are clipped as in the forward take
+    np_data = np.array([[3, 3, 0], [6, 3, -2], [9, 1, 3], [3, 0, 12]])
+    data = mx.sym.Variable("data")
+    embed = mx.sym.Embedding(data=data, input_dim=in_dim, output_dim=out_dim, name="embed")
+    clipped = np.clip(np_data, 0, in_dim - 1)
+    for grad_req in ['write', 'add']:
+        exe = embed.simple_bind(default_context(), grad_req={'data': 'null', 'embed_weight': grad_req},
+                                data=np_data.shape)
+        np_weight = np.random.uniform(-1, 1, (in_dim, out_dim))
+        exe.arg_dict['data'][:] = np_data
+        exe.arg_dict['embed_weight'][:] = np_weight
+        np_init_grad = np.random.uniform(-1, 1, (in_dim, out_dim))
+        exe.grad_dict['embed_weight'][:] = np_init_grad
+        exe.forward(is_train=True)
+        assert_almost_equal(exe.outputs[0].asnumpy(), np_weight[clipped], rtol=1e-5, atol=1e-5)
+        np_ograd = np.random.uniform(-1, 1, exe.outputs[0].shape)
+        exe.backward([mx.nd.array(np_ograd)])
+        expected = np_init_grad.copy() if grad_req == 'add' else np.zeros((in_dim, out_dim))
+        np.add.at(expected, clipped.ravel(), np_ograd.reshape((-1, out_dim)))
+        assert_almost_equal(exe.grad_dict['embed_weight'].asnumpy(), expected, rtol=1e-5, atol=1e-5)
+
+
 # check ops handle duplicate input correctly.
 @with_seed()
 def test_binary_op_duplicate_input():
@@ -3240,7 +3266,7 @@ def test_norm():
 def test_layer_norm():
     for dtype, forward_check_eps in zip([np.float16, np.float32, np.float64],
                                         [1E-2, 1E-3, 1E-4]):
-        for in_shape in [(10, 6, 5), (10, 10)]:
+        for in_shape in [(10, 6, 5), (10, 10), (3, 37)]:
             for axis in range(-len(in_shape), len(in_shape)):
                 for eps in [1E-2, 1E-3]:
                     check_layer_normalization(in_shape, axis, eps, dtype=dtype,
@@ -3751,6 +3777,21 @@ def test_order():
                                              ret_typ="indices", k=5,
                                              is_ascend=is_ascend)])
 
+    # small k over a long axis with many ties
+    tie_npy = np.random.randint(0, 50, size=(4, 3000)).astype(np.float32)
+    for is_ascend in [True, False]:
+        for k in [1, 7, 100, 500]:
+            b = mx.sym.topk(a, axis=1, is_ascend=is_ascend, ret_typ="value", k=k)
+            check_symbolic_forward(b, location={'a': tie_npy},
+                                   expected=[gt_topk(dat=tie_npy, axis=1, ret_typ="value", k=k,
+                                                     is_ascend=is_ascend)])
+            if ctx.device_type == 'cpu':
+                # ties are ordered by their position on cpu
+                key = tie_npy if is_ascend else -tie_npy
+                b = mx.sym.topk(a, axis=1, is_ascend=is_ascend, ret_typ="indices", k=k)
+                check_symbolic_forward(b, location={'a': tie_npy},
+                                       expected=[key.argsort(axis=1, kind='mergesort')[:, :k]])
+
     b = mx.sym.topk(a, axis=3, is_ascend=is_ascend, ret_typ="indices", k=3)
     check_symbolic_backward(sym=b, location={'a': a_npy},
                             out_grads=[np.random.normal(size=(5, 5, 5, 3))],
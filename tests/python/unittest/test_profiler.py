@@ -233,6 +233,77 @@ def test_continuous_profile_and_instant_marker():
     profiler.set_state('stop')
 
 
+def test_aggregate_latency():
+    enable_profiler('test_aggregate_latency.json', True, False, True)
+    profiler.latency(reset=True)
+    a = mx.nd.ones((16, 16))
+    for _ in range(10):
+        a = mx.nd.dot(a, a) / 16
+    a.wait_to_read()
+    assert 'P99 (ms)' in profiler.dumps()
+    stats = profiler.latency(reset=True)
+    dots = [s for s in stats['operator'] if s['name'].startswith('dot') and s['device']]
+    assert len(dots) == 1
+    dot = dots[0]
+    assert dot['device'] == 'cpu/0'
+    assert dot['count'] == 10
+    assert dot['min'] <= dot['p50'] <= dot['p90'] <= dot['p99'] <= dot['p999'] <= dot['max']
+    # the histograms were reset by the snapshot
+    stats = profiler.latency()
+    assert not any(s['name'].startswith('dot') for s in stats.get('operator', []))
+    profiler.set_state('stop')
+
+
+def test_aggregate_latency_escapes_names():
+    enable_profiler('test_aggregate_latency_escapes_names.json', True, False, True)
+    profiler.latency(reset=True)
+    domain_name = 'Python"Domain\\latency'
+    task_name = 'task "quoted"\tname\n'
+    task = profiler.Task(profiler.Domain(domain_name), task_name)
+    for _ in range(3):
+        task.start()
+        time.sleep(0.001)
+        task.stop()
+    stats = profiler.latency(reset=True)
+    assert domain_name in stats
+    tasks = [s for s in stats[domain_name] if s['name'] == task_name]
+    assert len(tasks) == 1
+    assert tasks[0]['count'] == 3
+    profiler.set_state('stop')
+
+
+def test_binary_trace():
+    trace_name = 'test_binary_trace.trace'
+    json_name = 'test_binary_trace.json'
+    profiler.set_config(profile_all=True, filename=trace_name, binary_trace=True,
+                        dump_period=0.1)
+    profiler.set_state('run')
+    domain = profiler.Domain('PythonDomain::test_binary_trace')
+    counter = profiler.Counter(domain, 'TraceCounter', 7)
+    counter += 3
+    profiler.Marker(domain, 'TraceMarker').mark('thread')
+    a = mx.nd.ones((16, 16))
+    for _ in range(3):
+        a = mx.nd.dot(a, a) / 16
+    a.wait_to_read()
+    profiler.set_state('stop')
+    profiler.dump(True)
+    profiler.convert_trace(trace_name, json_name)
+    import json
+    with open(json_name) as f:
+        events = json.load(f)['traceEvents']
+    # operators are on their device, cpu/0
+    dots = [e for e in events if e['name'].startswith('dot') and e['ph'] in 'BE']
+    assert len(dots) == 6
+    assert all(e['pid'] == 0 for e in dots)
+    counts = [e['args']['TraceCounter'] for e in events if e['name'] == 'TraceCounter']
+    assert counts == [7, 10]
+    markers = [e for e in events if e['name'] == 'TraceMarker']
+    assert len(markers) == 1 and markers[0]['s'] == 't'
+    processes = [e['args']['name'] for e in events if e['ph'] == 'M']
+    assert 'PythonDomain::test_binary_trace' in processes
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
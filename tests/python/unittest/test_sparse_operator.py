@@ -1907,6 +1907,40 @@ def test_sparse_embedding():
             check_sparse_embedding(in_dim, out_dim, batch, densities, sparse_grad, weight_stype)
             check_sparse_embedding(in_dim, out_dim, batch, densities, sparse_grad, weight_stype)
 
+@with_seed()
+def test_sparse_embedding_backward_scatter_add():
+    in_dim = 20
+    out_dim = 3
+    data = mx.sym.Variable("data")
+    embed = mx.sym.Embedding(data=data, input_dim=in_dim, output_dim=out_dim,
+                             sparse_grad=True, name='embed')
+
+    def backward(np_data):
+        exe = embed.simple_bind(default_context(), grad_req={'data': 'null', 'embed_weight': 'write'},
+                                data=np_data.shape)
+        exe.arg_dict['data'][:] = np_data
+        exe.arg_dict['embed_weight'][:] = np.random.uniform(-1, 1, (in_dim, out_dim))
+        exe.forward(is_train=True)
+        np_ograd = np.random.uniform(-1, 1, exe.outputs[0].shape)
+        exe.backward([mx.nd.array(np_ograd)])
+        return exe.grad_dict['embed_weight'], np_ograd
+
+    # duplicate indices in one row_sparse row each
+    np_data = np.array([[4, 17, 4], [0, 4, 17], [19, 0, 4]])
+    grad, np_ograd = backward(np_data)
+    assert grad.stype == 'row_sparse'
+    expected = np.zeros((in_dim, out_dim))
+    np.add.at(expected, np_data.ravel(), np_ograd.reshape((-1, out_dim)))
+    assert_almost_equal(grad.indices.asnumpy(), np.unique(np_data))
+    assert_almost_equal(grad.data.asnumpy(), expected[np.unique(np_data)], rtol=1e-5, atol=1e-5)
+    assert_almost_equal(grad.asnumpy(), expected, rtol=1e-5, atol=1e-5)
+
+    # indices out of range are rejected instead of clipped
+    def backward_out_of_range():
+        grad, _ = backward(np.array([[1, in_dim]]))
+        grad.asnumpy()
+    assertRaises(MXNetError, backward_out_of_range)
+
 @with_seed()
 def test_sparse_broadcast_add_sub():
     def check_broadcast_add(mx_lhs, mx_rhs, np_lhs, np_rhs, dtype):
@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Throughput of the parameter servers with fake workers.
+
+Every worker pushes random gradients for a set of keys and pulls the weights back, as a
+training job without any computation would. Run it on one machine with
+
+    python ../launch.py --launcher local -n 4 -s 1 python measure_server.py
+
+and compare MXNET_KVSTORE_SERVER_THREADS=1 with larger values.
+"""
+
+import os, sys
+curr_path = os.path.abspath(os.path.dirname(__file__))
+sys.path.insert(0, os.path.join(curr_path, "../../python"))
+import mxnet as mx
+import logging
+import argparse
+import time
+
+logger = logging.getLogger()
+logger.setLevel(logging.INFO)
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="benchmark the kvstore servers with fake workers")
+    parser.add_argument('--kv-store', type=str, default='dist_sync',
+                        help='the kvstore type, dist_sync or dist_async')
+    parser.add_argument('--num-keys', type=int, default=64,
+                        help='number of keys pushed and pulled per iteration')
+    parser.add_argument('--key-size', type=int, default=1 << 16,
+                        help='number of float32 elements of each key')
+    parser.add_argument('--num-batches', type=int, default=20,
+                        help='number of iterations to run')
+    parser.add_argument('--disp-batches', type=int, default=5,
+                        help='show averaged results for every n iterations')
+    parser.add_argument('--optimizer', type=str, default='sgd',
+                        help='the optimizer run by the servers. None means no optimizer')
+    args = parser.parse_args()
+    logging.info(args)
+    return args
+
+def run(args):
+    kv = mx.kvstore.create(args.kv_store)
+    if args.optimizer != 'None':
+        kv.set_optimizer(mx.optimizer.create(args.optimizer, learning_rate=0.01))
+    keys = list(range(args.num_keys))
+    shape = (args.key_size,)
+    weights = [mx.nd.zeros(shape) for _ in keys]
+    grads = [mx.nd.random.uniform(shape=shape) for _ in keys]
+    kv.init(keys, weights)
+    mx.nd.waitall()
+    total_bytes = 2 * args.num_keys * args.key_size * 4
+
+    tic = time.time()
+    for b in range(args.num_batches):
+        for i, k in enumerate(keys):
+            kv.push(k, grads[i], priority=-i)
+        for i, k in enumerate(keys):
+            kv.pull(k, out=weights[i], priority=-i)
+        mx.nd.waitall()
+        if (b + 1) % args.disp_batches == 0:
+            toc = time.time()
+            elapsed = (toc - tic) / args.disp_batches
+            logging.info('worker %d, iter %d, %f sec, %f key updates/sec, %f GB/sec',
+                         kv.rank, b + 1, elapsed, args.num_keys / elapsed,
+                         total_bytes / elapsed / 1e9)
+            tic = time.time()
+
+if __name__ == "__main__":
+    run(parse_args())